@@ -44,10 +44,10 @@
 // The attach mechanism on Linux uses a UNIX domain socket. An attach listener
 // thread is created at startup or is created on-demand via a signal from
 // the client tool. The attach listener creates a socket and binds it to a file
-// in the filesystem. The attach listener then acts as a simple (single-
-// threaded) server - it waits for a client to connect, reads the request,
-// executes it, and returns the response to the client via the socket
-// connection.
+// in the filesystem. The attach listener then acts as a simple server - it
+// waits for a client to connect, reads the request, and hands it to a worker
+// thread that executes it and returns the response to the client via the
+// socket connection.
 //
 // As the socket is a UNIX domain socket it means that only clients on the
 // local machine can connect. In addition there are two other aspects to
@@ -113,6 +113,10 @@ class LinuxAttachOperation: public AttachOperation {
  public:
   void complete(jint res, bufferedStream* st);
 
+  bool supports_streaming() const                       { return true; }
+  bool write_result(jint result);
+  ssize_t write_reply(const char* buf, size_t len);
+
   void set_socket(int s)                                { _socket = s; }
   int socket() const                                    { return _socket; }
 
@@ -395,9 +399,9 @@ int LinuxAttachListener::write_fully(int s, char* buf, int len) {
 // output to the client. At this time the socket is in blocking mode so
 // potentially we can block if there is a lot of data and the client is
 // non-responsive. For most operations this is a non-issue because the
-// default send buffer is sufficient to buffer everything. In the future
-// if there are operations that involves a very big reply then it the
-// socket could be made non-blocking and a timeout could be used.
+// default send buffer is sufficient to buffer everything. Operations with
+// a very big reply have sent part of it while executing, see
+// AttachReplyStream.
 
 void LinuxAttachOperation::complete(jint result, bufferedStream* st) {
   JavaThread* thread = JavaThread::current();
@@ -407,10 +411,13 @@ void LinuxAttachOperation::complete(jint result, bufferedStream* st) {
   // cleared by handle_special_suspend_equivalent_condition() or
   // java_suspend_self() via check_and_wait_while_suspended()
 
-  // write operation result
-  char msg[32];
-  sprintf(msg, "%d\n", result);
-  int rc = LinuxAttachListener::write_fully(this->socket(), msg, strlen(msg));
+  // write operation result, unless already sent ahead of streamed output
+  int rc = 0;
+  if (!is_streaming()) {
+    char msg[32];
+    sprintf(msg, "%d\n", result);
+    rc = LinuxAttachListener::write_fully(this->socket(), msg, strlen(msg));
+  }
 
   // write any result data
   if (rc == 0) {
@@ -427,6 +434,26 @@ void LinuxAttachOperation::complete(jint result, bufferedStream* st) {
   delete this;
 }
 
+// The result code is the first thing sent on the connection, so it fits
+// into the socket buffer and writing it does not block.
+bool LinuxAttachOperation::write_result(jint result) {
+  char msg[32];
+  sprintf(msg, "%d\n", result);
+  return LinuxAttachListener::write_fully(this->socket(), msg, strlen(msg)) == 0;
+}
+
+// Write as much of the buffer as the socket accepts without blocking.
+// The operation is still executing and may hold locks, so it must not
+// wait for the client.
+ssize_t LinuxAttachOperation::write_reply(const char* buf, size_t len) {
+  ssize_t n;
+  RESTARTABLE(::send(this->socket(), buf, len, MSG_DONTWAIT), n);
+  if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return 0;
+  }
+  return n;
+}
+
 
 // AttachListener functions
 
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled/precompiled.hpp"
+#include "hardwareCounters_linux.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef PERF_FLAG_FD_CLOEXEC
+#define PERF_FLAG_FD_CLOEXEC 0
+#endif
+
+#if defined(IA32) || defined(AMD64)
+#define HARDWARE_COUNTERS_RDPMC 1
+#else
+#define HARDWARE_COUNTERS_RDPMC 0
+#endif
+
+static u8 cache_miss_config(u8 cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+int HardwareCounterSet::open_counter(HardwareCounters::Counter counter) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  switch (counter) {
+    case HardwareCounters::cycles:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case HardwareCounters::instructions:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case HardwareCounters::llc_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache_miss_config(PERF_COUNT_HW_CACHE_LL);
+      break;
+    case HardwareCounters::dtlb_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache_miss_config(PERF_COUNT_HW_CACHE_DTLB);
+      break;
+    default:
+      ShouldNotReachHere();
+  }
+  // The enabled and running times are needed to scale the counts when the
+  // kernel multiplexes more events than the CPU has counters.
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // Count the calling thread on any CPU.
+  return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+bool HardwareCounterSet::is_supported() {
+  int fd = open_counter(HardwareCounters::cycles);
+  if (fd < 0) {
+    log_info(os)("perf_event_open failed: %s", os::strerror(errno));
+    return false;
+  }
+  ::close(fd);
+  return true;
+}
+
+HardwareCounterSet::HardwareCounterSet() {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    _fds[i] = -1;
+    _pages[i] = NULL;
+  }
+}
+
+HardwareCounterSet::~HardwareCounterSet() {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    if (_pages[i] != NULL) {
+      ::munmap(_pages[i], os::vm_page_size());
+    }
+    if (_fds[i] >= 0) {
+      ::close(_fds[i]);
+    }
+  }
+}
+
+void HardwareCounterSet::open() {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    _fds[i] = open_counter((HardwareCounters::Counter)i);
+    if (_fds[i] < 0) {
+      log_debug(os)("Could not open hardware counter %s: %s",
+                    HardwareCounters::name((HardwareCounters::Counter)i), os::strerror(errno));
+      continue;
+    }
+    if (HARDWARE_COUNTERS_RDPMC && UseHardwareCountersRdpmc) {
+      // The first page of the mapping tells whether and how the counter
+      // can be read in user mode.
+      void* page = ::mmap(NULL, os::vm_page_size(), PROT_READ, MAP_SHARED, _fds[i], 0);
+      if (page != MAP_FAILED) {
+        _pages[i] = (perf_event_mmap_page*)page;
+      }
+    }
+  }
+}
+
+#if HARDWARE_COUNTERS_RDPMC
+static inline u8 rdpmc(u4 counter) {
+  u4 low, high;
+  __asm__ __volatile__ ("rdpmc" : "=a" (low), "=d" (high) : "c" (counter));
+  return ((u8)high << 32) | low;
+}
+
+// Reads a counter of the current thread without a system call. The kernel
+// updates the page with a sequence lock. Counters that have been
+// multiplexed are left to read(), so that all counts of a counter are
+// scaled the same way.
+static bool read_user_mode(volatile perf_event_mmap_page* pc, u8* value) {
+  u4 seq;
+  u8 count;
+  do {
+    seq = pc->lock;
+    __asm__ __volatile__ ("" : : : "memory");
+    u4 index = pc->index;
+    if (!pc->cap_user_rdpmc || index == 0 || pc->time_enabled != pc->time_running) {
+      return false;
+    }
+    u4 width = pc->pmc_width;
+    s8 pmc = (s8)rdpmc(index - 1);
+    pmc <<= 64 - width;
+    pmc >>= 64 - width;
+    count = pc->offset + pmc;
+    __asm__ __volatile__ ("" : : : "memory");
+  } while (pc->lock != seq);
+  *value = count;
+  return true;
+}
+#endif // HARDWARE_COUNTERS_RDPMC
+
+bool HardwareCounterSet::read_counter(int i, bool is_current, u8* value) {
+  if (_fds[i] < 0) {
+    return false;
+  }
+#if HARDWARE_COUNTERS_RDPMC
+  if (is_current && _pages[i] != NULL && read_user_mode(_pages[i], value)) {
+    return true;
+  }
+#endif
+  u8 data[3]; // value, time enabled, time running
+  if (::read(_fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) {
+    return false;
+  }
+  u8 count = data[0];
+  if (data[2] == 0) {
+    count = 0;
+  } else if (data[2] < data[1]) {
+    count = (u8)((double)count * ((double)data[1] / (double)data[2]));
+  }
+  *value = count;
+  return true;
+}
+
+bool HardwareCounterSet::read(HardwareCounterValues* values, bool is_current) {
+  bool any = false;
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    u8 value = 0;
+    if (read_counter(i, is_current, &value)) {
+      any = true;
+    }
+    values->set((HardwareCounters::Counter)i, value);
+  }
+  return any;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef OS_LINUX_HARDWARECOUNTERS_LINUX_HPP
+#define OS_LINUX_HARDWARECOUNTERS_LINUX_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/hardwareCounters.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+struct perf_event_mmap_page;
+
+// The perf events counting the hardware events of one thread. Every
+// counter is opened on its own rather than as a group, so that a counter
+// the CPU does not support does not disable the others.
+class HardwareCounterSet : public CHeapObj<mtInternal> {
+ private:
+  int                   _fds[HardwareCounters::num_counters];
+  perf_event_mmap_page* _pages[HardwareCounters::num_counters];
+
+  NONCOPYABLE(HardwareCounterSet);
+
+  static int open_counter(HardwareCounters::Counter counter);
+  bool read_counter(int i, bool is_current, u8* value);
+
+ public:
+  HardwareCounterSet();
+  ~HardwareCounterSet();
+
+  static bool is_supported();
+
+  // Opens the counters for the current thread.
+  void open();
+  bool read(HardwareCounterValues* values, bool is_current);
+};
+
+#endif // OS_LINUX_HARDWARECOUNTERS_LINUX_HPP
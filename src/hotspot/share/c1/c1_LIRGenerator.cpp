@@ -2945,20 +2945,17 @@ void LIRGenerator::do_ClassIDIntrinsic(Intrinsic* x) {
   arg.load_item();
   LIR_Opr klass = new_register(T_METADATA);
   __ move(new LIR_Address(arg.result(), java_lang_Class::klass_offset_in_bytes(), T_ADDRESS), klass, info);
-  LIR_Opr id = new_register(T_LONG);
-  ByteSize offset = KLASS_TRACE_ID_OFFSET;
-  LIR_Address* trace_id_addr = new LIR_Address(klass, in_bytes(offset), T_LONG);
+  __ null_check(klass, info2);
 
-  __ move(trace_id_addr, id);
-  __ logical_or(id, LIR_OprFact::longConst(0x01l), id);
-  __ store(id, trace_id_addr);
-
-#ifdef TRACE_ID_META_BITS
-  __ logical_and(id, LIR_OprFact::longConst(~TRACE_ID_META_BITS), id);
-#endif
-#ifdef TRACE_ID_SHIFT
-  __ unsigned_shift_right(id, TRACE_ID_SHIFT, id);
-#endif
+  // The klass is tagged and, when first tagged in the epoch, enqueued
+  // by the runtime. Unlike C2, there is no inline path for a klass that
+  // is already tagged, as a branch around a call within a block is not
+  // supported by the register allocator.
+  BasicTypeList signature;
+  signature.append(T_METADATA); // Klass*
+  LIR_OprList* args = new LIR_OprList();
+  args->append(klass);
+  LIR_Opr id = call_runtime(&signature, args, CAST_FROM_FN_PTR(address, JfrIntrinsicSupport::use_klass), longType, NULL);
 
   __ move(id, rlock_result(x));
 }
@@ -50,6 +50,7 @@
 #include "runtime/atomic.hpp"
 #include "runtime/compilationPolicy.hpp"
 #include "runtime/handles.inline.hpp"
+#include "runtime/hardwareCounters.hpp"
 #include "runtime/init.hpp"
 #include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/javaCalls.hpp"
@@ -1985,6 +1986,21 @@ static void post_compilation_event(EventCompilation* event, CompileTask* task) {
   event->commit();
 }
 
+static void post_compilation_hardware_counters_event(EventCompilationHardwareCounters* event, CompileTask* task,
+                                                     HardwareCounterSpan* span) {
+  assert(event != NULL, "invariant");
+  assert(event->should_commit(), "invariant");
+  HardwareCounterValues values;
+  if (span->stop(&values)) {
+    event->set_compileId(task->compile_id());
+    event->set_cycles(values.cycles());
+    event->set_instructions(values.instructions());
+    event->set_llcMisses(values.llc_misses());
+    event->set_dtlbMisses(values.dtlb_misses());
+    event->commit();
+  }
+}
+
 int DirectivesStack::_depth = 0;
 CompilerDirectives* DirectivesStack::_top = NULL;
 CompilerDirectives* DirectivesStack::_bottom = NULL;
@@ -2043,6 +2059,9 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
     should_log = false;
   }
 
+  EventCompilationHardwareCounters hardware_counters_event;
+  HardwareCounterSpan hardware_counters(thread);
+
   // Allocate a new set of JNI handles.
   push_jni_handle_block();
   Method* target_handle = task->method();
@@ -2154,6 +2173,10 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
   // the previous block.
   pop_jni_handle_block();
 
+  if (hardware_counters_event.should_commit()) {
+    post_compilation_hardware_counters_event(&hardware_counters_event, task, &hardware_counters);
+  }
+
   if (failure_reason != NULL) {
     task->set_failure_reason(failure_reason, failure_reason_on_C_heap);
     if (_compilation_log != NULL) {
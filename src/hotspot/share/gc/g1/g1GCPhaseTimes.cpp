@@ -29,6 +29,7 @@
 #include "gc/g1/g1ParScanThreadState.inline.hpp"
 #include "gc/g1/g1StringDedup.hpp"
 #include "gc/shared/gcTimer.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shared/workerDataArray.inline.hpp"
 #include "memory/resourceArea.hpp"
 #include "logging/log.hpp"
@@ -140,6 +141,13 @@ G1GCPhaseTimes::G1GCPhaseTimes(STWGCTimer* gc_timer, uint max_gc_threads) :
   _gc_par_phases[YoungFreeCSet] = new WorkerDataArray<double>(max_gc_threads, "Young Free Collection Set (ms):");
   _gc_par_phases[NonYoungFreeCSet] = new WorkerDataArray<double>(max_gc_threads, "Non-Young Free Collection Set (ms):");
 
+  for (int i = 0; i < GCParPhasesSentinel; i++) {
+    _hardware_counters[i] = NULL;
+    if (HardwareCounters::is_enabled() && _gc_par_phases[i] != NULL) {
+      _hardware_counters[i] = NEW_C_HEAP_ARRAY(HardwareCounterValues, max_gc_threads, mtGC);
+    }
+  }
+
   reset();
 }
 
@@ -181,6 +189,11 @@ void G1GCPhaseTimes::reset() {
     if (_gc_par_phases[i] != NULL) {
       _gc_par_phases[i]->reset();
     }
+    if (_hardware_counters[i] != NULL) {
+      for (uint j = 0; j < _max_gc_threads; j++) {
+        _hardware_counters[i][j].clear();
+      }
+    }
   }
 
   _ref_phase_times.reset();
@@ -261,6 +274,42 @@ void G1GCPhaseTimes::record_or_add_time_secs(GCParPhases phase, uint worker_i, d
   }
 }
 
+void G1GCPhaseTimes::add_hardware_counters(GCParPhases phase, uint worker_i, const HardwareCounterValues& values) {
+  if (_hardware_counters[phase] != NULL) {
+    _hardware_counters[phase][worker_i].add(values);
+  }
+}
+
+bool G1GCPhaseTimes::sum_hardware_counters(GCParPhases phase, HardwareCounterValues* sum) const {
+  if (_hardware_counters[phase] == NULL) {
+    return false;
+  }
+  sum->clear();
+  for (uint i = 0; i < _max_gc_threads; i++) {
+    sum->add(_hardware_counters[phase][i]);
+  }
+  return !sum->is_zero();
+}
+
+void G1GCPhaseTimes::report_hardware_counters() const {
+  if (!HardwareCounters::is_enabled() || !EventGCPhaseHardwareCounters::is_enabled()) {
+    return;
+  }
+  for (int i = 0; i < GCParPhasesSentinel; i++) {
+    HardwareCounterValues sum;
+    if (sum_hardware_counters((GCParPhases)i, &sum)) {
+      EventGCPhaseHardwareCounters event;
+      event.set_gcId(GCId::current());
+      event.set_name(phase_name((GCParPhases)i));
+      event.set_cycles(sum.cycles());
+      event.set_instructions(sum.instructions());
+      event.set_llcMisses(sum.llc_misses());
+      event.set_dtlbMisses(sum.dtlb_misses());
+      event.commit();
+    }
+  }
+}
+
 double G1GCPhaseTimes::get_time_secs(GCParPhases phase, uint worker_i) {
   return _gc_par_phases[phase]->get(worker_i);
 }
@@ -310,6 +359,15 @@ void G1GCPhaseTimes::log_phase(WorkerDataArray<double>* phase, uint indent, outp
       details(work_items, Indents[indent + 1]);
     }
   }
+
+  for (int i = 0; i < GCParPhasesSentinel; i++) {
+    HardwareCounterValues sum;
+    if (_gc_par_phases[i] == phase && sum_hardware_counters((GCParPhases)i, &sum)) {
+      out->print("%sHardware Counters: ", Indents[indent + 1]);
+      sum.print_on(out);
+      out->cr();
+    }
+  }
 }
 
 void G1GCPhaseTimes::debug_phase(WorkerDataArray<double>* phase, uint extra_indent) const {
@@ -496,6 +554,7 @@ void G1GCPhaseTimes::print_other(double accounted_ms) const {
 
 void G1GCPhaseTimes::print() {
   note_gc_end();
+  report_hardware_counters();
 
   if (_cur_verify_before_time_ms > 0.0) {
     debug_time("Verify Before", _cur_verify_before_time_ms);
@@ -581,9 +640,11 @@ void G1EvacPhaseWithTrimTimeTracker::stop() {
 }
 
 G1GCParPhaseTimesTracker::G1GCParPhaseTimesTracker(G1GCPhaseTimes* phase_times, G1GCPhaseTimes::GCParPhases phase, uint worker_id) :
-  _start_time(), _phase(phase), _phase_times(phase_times), _worker_id(worker_id), _event() {
+  _start_time(), _phase(phase), _phase_times(phase_times), _worker_id(worker_id), _event(),
+  _hardware_counters(Thread::current()) {
   if (_phase_times != NULL) {
     _start_time = Ticks::now();
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::phase_begin, G1GCPhaseTimes::phase_name(_phase));
   }
 }
 
@@ -591,6 +652,12 @@ G1GCParPhaseTimesTracker::~G1GCParPhaseTimesTracker() {
   if (_phase_times != NULL) {
     _phase_times->record_time_secs(_phase, _worker_id, (Ticks::now() - _start_time).seconds());
     _event.commit(GCId::current(), _worker_id, G1GCPhaseTimes::phase_name(_phase));
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::phase_end, G1GCPhaseTimes::phase_name(_phase));
+
+    HardwareCounterValues values;
+    if (_hardware_counters.stop(&values)) {
+      _phase_times->add_hardware_counters(_phase, _worker_id, values);
+    }
   }
 }
 
@@ -30,6 +30,7 @@
 #include "jfr/jfrEvents.hpp"
 #include "logging/logLevel.hpp"
 #include "memory/allocation.hpp"
+#include "runtime/hardwareCounters.hpp"
 #include "utilities/macros.hpp"
 
 class LineBuffer;
@@ -109,6 +110,9 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
 
   WorkerDataArray<double>* _gc_par_phases[GCParPhasesSentinel];
 
+  // Hardware events per phase and worker, if UseHardwareCounters is enabled.
+  HardwareCounterValues* _hardware_counters[GCParPhasesSentinel];
+
   WorkerDataArray<size_t>* _update_rs_processed_buffers;
   WorkerDataArray<size_t>* _update_rs_scanned_cards;
   WorkerDataArray<size_t>* _update_rs_skipped_cards;
@@ -196,6 +200,9 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
   template <class T>
   void details(T* phase, const char* indent) const;
 
+  bool sum_hardware_counters(GCParPhases phase, HardwareCounterValues* sum) const;
+  void report_hardware_counters() const;
+
   void log_phase(WorkerDataArray<double>* phase, uint indent, outputStream* out, bool print_sum) const;
   void debug_phase(WorkerDataArray<double>* phase, uint extra_indent = 0) const;
   void trace_phase(WorkerDataArray<double>* phase, bool print_sum = true) const;
@@ -227,6 +234,8 @@ class G1GCPhaseTimes : public CHeapObj<mtGC> {
 
   void record_or_add_time_secs(GCParPhases phase, uint worker_i, double secs);
 
+  void add_hardware_counters(GCParPhases phase, uint worker_i, const HardwareCounterValues& values);
+
   double get_time_secs(GCParPhases phase, uint worker_i);
 
   void record_thread_work_item(GCParPhases phase, uint worker_i, size_t count, uint index = 0);
@@ -424,6 +433,7 @@ protected:
   G1GCPhaseTimes* _phase_times;
   uint _worker_id;
   EventGCPhaseParallel _event;
+  HardwareCounterSpan _hardware_counters;
 public:
   G1GCParPhaseTimesTracker(G1GCPhaseTimes* phase_times, G1GCPhaseTimes::GCParPhases phase, uint worker_id);
   virtual ~G1GCParPhaseTimesTracker();
@@ -26,6 +26,7 @@
 #include "gc/parallel/gcTaskManager.hpp"
 #include "gc/parallel/gcTaskThread.hpp"
 #include "gc/shared/gcId.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "logging/log.hpp"
 #include "memory/allocation.hpp"
 #include "memory/allocation.inline.hpp"
@@ -151,7 +152,10 @@ void GCTaskThread::run() {
 
       // If this is the barrier task, it can be destroyed
       // by the GC task manager once the do_it() executes.
-      task->do_it(manager(), which());
+      {
+        GCWorkerTimelinePhase phase(which(), name);
+        task->do_it(manager(), which());
+      }
 
       // Use the saved value of is_idle_task because references
       // using "task" are not reliable for the barrier task.
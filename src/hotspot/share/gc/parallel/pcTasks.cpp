@@ -34,6 +34,7 @@
 #include "gc/shared/collectedHeap.hpp"
 #include "gc/shared/gcTimer.hpp"
 #include "gc/shared/gcTraceTime.inline.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "logging/log.hpp"
 #include "memory/iterator.inline.hpp"
 #include "memory/resourceArea.hpp"
@@ -205,7 +206,11 @@ void StealMarkingTask::do_it(GCTaskManager* manager, uint which) {
       cm->follow_contents(obj);
       cm->follow_marking_stacks();
     }
-  } while (!terminator()->offer_termination());
+    GCWorkerTimelineTermination timeline(which);
+    if (timeline.set_terminated(terminator()->offer_termination())) {
+      break;
+    }
+  } while (true);
 }
 
 //
@@ -235,7 +240,8 @@ void CompactionWithStealingTask::do_it(GCTaskManager* manager, uint which) {
       PSParallelCompact::fill_and_update_region(cm, region_index);
       cm->drain_region_stacks();
     } else {
-      if (terminator()->offer_termination()) {
+      GCWorkerTimelineTermination timeline(which);
+      if (timeline.set_terminated(terminator()->offer_termination())) {
         break;
       }
       // Go around again.
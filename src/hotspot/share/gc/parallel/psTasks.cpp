@@ -35,6 +35,7 @@
 #include "gc/parallel/psPromotionManager.inline.hpp"
 #include "gc/parallel/psScavenge.inline.hpp"
 #include "gc/parallel/psTasks.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shared/scavengableNMethods.hpp"
 #include "gc/shared/taskqueue.inline.hpp"
 #include "memory/iterator.hpp"
@@ -160,7 +161,8 @@ void StealTask::do_it(GCTaskManager* manager, uint which) {
       pm->process_popped_location_depth(p);
       pm->drain_stacks_depth(true);
     } else {
-      if (terminator()->offer_termination()) {
+      GCWorkerTimelineTermination timeline(which);
+      if (timeline.set_terminated(terminator()->offer_termination())) {
         break;
       }
     }
@@ -29,6 +29,7 @@
 #include "gc/shared/gcId.hpp"
 #include "gc/shared/gcLocker.hpp"
 #include "gc/shared/gcVMOperations.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shared/genCollectedHeap.hpp"
 #include "interpreter/oopMapCache.hpp"
 #include "logging/log.hpp"
@@ -156,6 +157,10 @@ void VM_GC_HeapInspection::doit() {
   inspect.heap_inspection(_out);
 }
 
+void VM_PrintGCWorkerTimeline::doit() {
+  GCWorkerTimeline::print_chrome_trace_on(_out);
+}
+
 
 void VM_GenCollectForAllocation::doit() {
   SvcGCMarker sgcm(SvcGCMarker::MINOR);
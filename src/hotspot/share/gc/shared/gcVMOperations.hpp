@@ -155,6 +155,15 @@ class VM_GC_HeapInspection: public VM_GC_Operation {
   bool collect();
 };
 
+class VM_PrintGCWorkerTimeline : public VM_Operation {
+ private:
+  outputStream* _out;
+ public:
+  VM_PrintGCWorkerTimeline(outputStream* out) : _out(out) {}
+  virtual VMOp_Type type() const { return VMOp_PrintGCWorkerTimeline; }
+  virtual void doit();
+};
+
 class VM_CollectForAllocation : public VM_GC_Operation {
  protected:
   size_t    _word_size; // Size of object to be allocated (in number of words)
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "jvm.h"
+#include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/gcCause.hpp"
+#include "gc/shared/gcId.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
+#include "gc/shared/gc_globals.hpp"
+#include "jfr/jfrEvents.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/universe.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/ticks.hpp"
+
+class GCWorkerTimelineEvent {
+ public:
+  Ticks       _time;
+  const char* _name;
+  u1          _type;
+  bool        _success;
+};
+
+class GCWorkerTimelineBuffer {
+ private:
+  GCWorkerTimelineEvent* _events;
+  size_t                 _capacity;
+  size_t                 _top;          // number of events ever recorded
+  size_t                 _pause_start;  // _top when the current pause began
+
+ public:
+  void initialize(size_t capacity) {
+    _events = NEW_C_HEAP_ARRAY(GCWorkerTimelineEvent, capacity, mtGC);
+    _capacity = capacity;
+    _top = 0;
+    _pause_start = 0;
+  }
+
+  void add(GCWorkerTimeline::EventType type, const char* name, bool success) {
+    GCWorkerTimelineEvent& e = _events[_top % _capacity];
+    e._time = Ticks::now();
+    e._name = name;
+    e._type = (u1)type;
+    e._success = success;
+    _top++;
+  }
+
+  void begin_pause()  { _pause_start = _top; }
+
+  size_t first() const           { return _top > _capacity ? _top - _capacity : 0; }
+  size_t first_of_pause() const  { return MAX2(_pause_start, first()); }
+  size_t top() const             { return _top; }
+  const GCWorkerTimelineEvent& at(size_t i) const { return _events[i % _capacity]; }
+};
+
+class GCWorkerTimelinePause {
+ public:
+  Ticks       _start;
+  Ticks       _end;
+  uint        _gc_id;
+  const char* _cause;
+};
+
+static const size_t PauseCapacity = 1024;
+static GCWorkerTimelinePause* _pauses = NULL;
+static size_t _num_pauses = 0;
+static Ticks _base_time;
+
+volatile bool GCWorkerTimeline::_recording = false;
+GCWorkerTimelineBuffer* GCWorkerTimeline::_buffers = NULL;
+uint GCWorkerTimeline::_num_buffers = 0;
+
+void GCWorkerTimeline::record_event(uint worker_id, EventType type, const char* name, bool success) {
+  if (worker_id < _num_buffers) {
+    _buffers[worker_id].add(type, name, success);
+  }
+}
+
+void GCWorkerTimeline::begin_pause() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  if (!RecordGCWorkerTimeline) {
+    return;
+  }
+  if (_buffers == NULL) {
+    uint num_buffers = MAX2(ParallelGCThreads, ConcGCThreads);
+    _buffers = NEW_C_HEAP_ARRAY(GCWorkerTimelineBuffer, num_buffers, mtGC);
+    for (uint i = 0; i < num_buffers; i++) {
+      _buffers[i].initialize(GCWorkerTimelineEvents);
+    }
+    _num_buffers = num_buffers;
+    _pauses = NEW_C_HEAP_ARRAY(GCWorkerTimelinePause, PauseCapacity, mtGC);
+    _base_time = Ticks::now();
+  }
+  for (uint i = 0; i < _num_buffers; i++) {
+    _buffers[i].begin_pause();
+  }
+
+  GCWorkerTimelinePause& pause = _pauses[_num_pauses % PauseCapacity];
+  pause._start = Ticks::now();
+  pause._end = pause._start;
+  pause._gc_id = GCId::current_or_undefined();
+  pause._cause = GCCause::to_string(Universe::heap()->gc_cause());
+
+  OrderAccess::release_store(&_recording, true);
+}
+
+// Sends one GCWorkerTermination event for each attempt to terminate during
+// the pause, with the steals made since the previous attempt.
+static void send_termination_events(uint worker_id, const GCWorkerTimelineBuffer& buffer, uint gc_id) {
+  uint steal_attempts = 0;
+  uint steals = 0;
+  Ticks termination_start;
+  bool in_termination = false;
+  for (size_t i = buffer.first_of_pause(); i < buffer.top(); i++) {
+    const GCWorkerTimelineEvent& e = buffer.at(i);
+    switch (e._type) {
+      case GCWorkerTimeline::steal:
+        steal_attempts++;
+        if (e._success) {
+          steals++;
+        }
+        break;
+      case GCWorkerTimeline::termination_begin:
+        termination_start = e._time;
+        in_termination = true;
+        break;
+      case GCWorkerTimeline::termination_end:
+        if (in_termination) {
+          EventGCWorkerTermination event(UNTIMED);
+          if (event.should_commit()) {
+            event.set_starttime(termination_start);
+            event.set_endtime(e._time);
+            event.set_gcId(gc_id);
+            event.set_gcWorkerId(worker_id);
+            event.set_stealAttempts(steal_attempts);
+            event.set_steals(steals);
+            event.set_terminated(e._success);
+            event.commit();
+          }
+        }
+        in_termination = false;
+        steal_attempts = 0;
+        steals = 0;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void GCWorkerTimeline::end_pause() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  if (!_recording) {
+    return;
+  }
+  OrderAccess::release_store(&_recording, false);
+
+  GCWorkerTimelinePause& pause = _pauses[_num_pauses % PauseCapacity];
+  pause._end = Ticks::now();
+  _num_pauses++;
+
+  if (EventGCWorkerTermination::is_enabled()) {
+    for (uint i = 0; i < _num_buffers; i++) {
+      send_termination_events(i, _buffers[i], pause._gc_id);
+    }
+  }
+}
+
+static jlong micros_since_base(const Ticks& t) {
+  return t < _base_time ? 0 : (jlong)(t - _base_time).microseconds();
+}
+
+static void print_trace_event(outputStream* st, bool* first, int pid, int tid,
+                              const char* name, const Ticks& start, const Ticks& end) {
+  st->print_cr("%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":" JLONG_FORMAT ",\"dur\":" JLONG_FORMAT "}",
+               *first ? "" : ",", name, pid, tid, micros_since_base(start),
+               micros_since_base(end) - micros_since_base(start));
+  *first = false;
+}
+
+static void print_thread_name(outputStream* st, bool* first, int pid, int tid, const char* name) {
+  st->print_cr("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+               *first ? "" : ",", pid, tid, name);
+  *first = false;
+}
+
+// Phases are printed as complete events, so a phase whose begin has been
+// overwritten in the ring buffer, or that has not ended, is left out.
+static void print_worker_events(outputStream* st, bool* first, int pid, uint worker_id,
+                                const GCWorkerTimelineBuffer& buffer) {
+  const int MaxDepth = 16;
+  size_t open[MaxDepth];
+  int depth = 0;
+  int tid = (int)worker_id + 1;
+  for (size_t i = buffer.first(); i < buffer.top(); i++) {
+    const GCWorkerTimelineEvent& e = buffer.at(i);
+    switch (e._type) {
+      case GCWorkerTimeline::phase_begin:
+      case GCWorkerTimeline::termination_begin:
+        if (depth < MaxDepth) {
+          open[depth] = i;
+        }
+        depth++;
+        break;
+      case GCWorkerTimeline::phase_end:
+      case GCWorkerTimeline::termination_end:
+        if (depth == 0) {
+          break;
+        }
+        depth--;
+        if (depth < MaxDepth) {
+          const GCWorkerTimelineEvent& begin = buffer.at(open[depth]);
+          if (e._type == GCWorkerTimeline::termination_end) {
+            print_trace_event(st, first, pid, tid, e._success ? "Termination" : "Termination (failed)",
+                              begin._time, e._time);
+          } else {
+            print_trace_event(st, first, pid, tid, begin._name != NULL ? begin._name : "Phase",
+                              begin._time, e._time);
+          }
+        }
+        break;
+      case GCWorkerTimeline::steal:
+        st->print_cr("%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":" JLONG_FORMAT "}",
+                     *first ? "" : ",", e._success ? "Steal" : "Steal (failed)", pid, tid, micros_since_base(e._time));
+        *first = false;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void GCWorkerTimeline::print_chrome_trace_on(outputStream* st) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  assert(!_recording, "must not be in a pause");
+  int pid = os::current_process_id();
+  bool first = true;
+
+  st->print_cr("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  print_thread_name(st, &first, pid, 0, "GC Pauses");
+  for (uint i = 0; i < _num_buffers; i++) {
+    char name[32];
+    jio_snprintf(name, sizeof(name), "GC Worker #%u", i);
+    print_thread_name(st, &first, pid, (int)i + 1, name);
+  }
+
+  size_t first_pause = _num_pauses > PauseCapacity ? _num_pauses - PauseCapacity : 0;
+  for (size_t i = first_pause; i < _num_pauses; i++) {
+    const GCWorkerTimelinePause& pause = _pauses[i % PauseCapacity];
+    st->print_cr("%s{\"name\":\"Pause (%s)\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":" JLONG_FORMAT ",\"dur\":" JLONG_FORMAT ",\"args\":{\"gcId\":%d}}",
+                 first ? "" : ",", pause._cause, pid, micros_since_base(pause._start),
+                 micros_since_base(pause._end) - micros_since_base(pause._start), (int)pause._gc_id);
+    first = false;
+  }
+
+  for (uint i = 0; i < _num_buffers; i++) {
+    print_worker_events(st, &first, pid, i, _buffers[i]);
+  }
+  st->print_cr("]}");
+  st->flush();
+}
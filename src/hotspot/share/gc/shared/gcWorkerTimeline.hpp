@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHARED_GCWORKERTIMELINE_HPP
+#define SHARE_GC_SHARED_GCWORKERTIMELINE_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class GCWorkerTimelineBuffer;
+class outputStream;
+
+// GCWorkerTimeline records what each parallel GC worker does during a
+// pause: the phases it runs, its steal attempts and its attempts to
+// terminate. The per-phase times in G1GCPhaseTimes and WorkerDataArray
+// only keep sums and averages, which hide when a worker started, stalled
+// or finished.
+//
+// Every worker id has a ring buffer of the last GCWorkerTimelineEvents
+// events. A worker id is only used by one thread at a time during a pause,
+// so workers record without synchronization. Recording is only on between
+// begin_pause() and end_pause(), which IsGCActiveMark calls on the VM
+// thread, so concurrent GC work is never recorded.
+//
+// At the end of each pause the terminations of that pause are sent to JFR
+// as GCWorkerTermination events. The GC.worker_timeline diagnostic command
+// writes the buffers in the Chrome trace event format, which can be viewed
+// in chrome://tracing or Perfetto.
+class GCWorkerTimeline : AllStatic {
+ public:
+  enum EventType {
+    phase_begin,
+    phase_end,
+    termination_begin,
+    termination_end,
+    steal
+  };
+
+ private:
+  static volatile bool _recording;
+  static GCWorkerTimelineBuffer* _buffers;
+  static uint _num_buffers;
+
+  static void record_event(uint worker_id, EventType type, const char* name, bool success);
+
+ public:
+  static bool is_recording() { return _recording; }
+
+  static void begin_pause();
+  static void end_pause();
+
+  static void record(uint worker_id, EventType type, const char* name = NULL, bool success = false) {
+    if (_recording) {
+      record_event(worker_id, type, name, success);
+    }
+  }
+
+  // Writes the recorded events as Chrome trace JSON. Must be called at a
+  // safepoint, outside of any pause.
+  static void print_chrome_trace_on(outputStream* st);
+};
+
+// Records a phase of a worker from construction to destruction.
+class GCWorkerTimelinePhase : public StackObj {
+ private:
+  uint        _worker_id;
+  const char* _name;
+
+ public:
+  GCWorkerTimelinePhase(uint worker_id, const char* name) : _worker_id(worker_id), _name(name) {
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::phase_begin, _name);
+  }
+  ~GCWorkerTimelinePhase() {
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::phase_end, _name);
+  }
+};
+
+// Records an attempt of a worker to terminate. The attempt is only
+// successful if set_terminated() is called before destruction.
+class GCWorkerTimelineTermination : public StackObj {
+ private:
+  uint _worker_id;
+  bool _terminated;
+
+ public:
+  GCWorkerTimelineTermination(uint worker_id) : _worker_id(worker_id), _terminated(false) {
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::termination_begin);
+  }
+  ~GCWorkerTimelineTermination() {
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::termination_end, NULL, _terminated);
+  }
+
+  bool set_terminated(bool terminated) {
+    _terminated = terminated;
+    return terminated;
+  }
+};
+
+#endif // SHARE_GC_SHARED_GCWORKERTIMELINE_HPP
@@ -375,6 +375,16 @@
           "Use Optimized Work Stealing Threads task termination "           \
           "protocol")                                                       \
                                                                             \
+  product(bool, RecordGCWorkerTimeline, false,                              \
+          "Record the phases, steals and termination attempts of each "     \
+          "parallel GC worker during pauses, see the GC.worker_timeline "   \
+          "diagnostic command")                                             \
+                                                                            \
+  product(uintx, GCWorkerTimelineEvents, 8192,                              \
+          "Number of most recent events kept per GC worker by "             \
+          "RecordGCWorkerTimeline")                                         \
+          range(64, 16*M)                                                   \
+                                                                            \
   experimental(uintx, WorkStealingSleepMillis, 1,                           \
           "Sleep time when sleep is used for yields")                       \
                                                                             \
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shared/isGCActiveMark.hpp"
 #include "memory/universe.hpp"
 #include "utilities/debug.hpp"
@@ -35,10 +36,12 @@ IsGCActiveMark::IsGCActiveMark() {
   CollectedHeap* heap = Universe::heap();
   assert(!heap->is_gc_active(), "Not reentrant");
   heap->_is_gc_active = true;
+  GCWorkerTimeline::begin_pause();
 }
 
 IsGCActiveMark::~IsGCActiveMark() {
   CollectedHeap* heap = Universe::heap();
   assert(heap->is_gc_active(), "Sanity");
+  GCWorkerTimeline::end_pause();
   heap->_is_gc_active = false;
 }
@@ -35,6 +35,7 @@
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/thread.inline.hpp"
+#include "runtime/threadHeapSampler.hpp"
 #include "services/lowMemoryDetector.hpp"
 #include "utilities/align.hpp"
 #include "utilities/copy.hpp"
@@ -187,7 +188,7 @@ void MemAllocator::Allocation::notify_allocation_jvmti_sampler() {
   // support for JVMTI VMObjectAlloc event (no-op if not enabled)
   JvmtiExport::vm_object_alloc_event_collector(obj());
 
-  if (!JvmtiExport::should_post_sampled_object_alloc()) {
+  if (!ThreadHeapSampler::is_enabled()) {
     // Sampling disabled
     return;
   }
@@ -289,7 +290,7 @@ HeapWord* MemAllocator::allocate_inside_tlab_slow(Allocation& allocation) const
   HeapWord* mem = NULL;
   ThreadLocalAllocBuffer& tlab = _thread->tlab();
 
-  if (JvmtiExport::should_post_sampled_object_alloc()) {
+  if (ThreadHeapSampler::is_enabled()) {
     tlab.set_back_allocation_end();
     mem = tlab.allocate(_word_size);
 
@@ -25,6 +25,7 @@
 #ifndef SHARE_GC_SHARED_TASKQUEUE_INLINE_HPP
 #define SHARE_GC_SHARED_TASKQUEUE_INLINE_HPP
 
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shared/taskqueue.hpp"
 #include "memory/allocation.inline.hpp"
 #include "oops/oop.inline.hpp"
@@ -313,9 +314,11 @@ GenericTaskQueueSet<T, F>::steal(uint queue_num, E& t) {
     TASKQUEUE_STATS_ONLY(queue(queue_num)->stats.record_steal_attempt());
     if (steal_best_of_2(queue_num, t)) {
       TASKQUEUE_STATS_ONLY(queue(queue_num)->stats.record_steal());
+      GCWorkerTimeline::record(queue_num, GCWorkerTimeline::steal, NULL, true);
       return true;
     }
   }
+  GCWorkerTimeline::record(queue_num, GCWorkerTimeline::steal, NULL, false);
   return false;
 }
 
@@ -23,6 +23,7 @@
 
 #include "precompiled.hpp"
 
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shenandoah/shenandoahHeap.hpp"
 #include "gc/shenandoah/shenandoahPhaseTimings.hpp"
 #include "gc/shenandoah/shenandoahTimingTracker.hpp"
@@ -38,6 +39,9 @@ ShenandoahWorkerTimingsTracker::ShenandoahWorkerTimingsTracker(ShenandoahWorkerT
   if (_worker_times != NULL) {
     _start_time = os::elapsedTime();
   }
+  if (ShenandoahGCPhase::is_root_work_phase()) {
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::phase_begin, phase_name());
+  }
 }
 
 ShenandoahWorkerTimingsTracker::~ShenandoahWorkerTimingsTracker() {
@@ -46,12 +50,17 @@ ShenandoahWorkerTimingsTracker::~ShenandoahWorkerTimingsTracker() {
   }
 
   if (ShenandoahGCPhase::is_root_work_phase()) {
-    ShenandoahPhaseTimings::Phase root_phase = ShenandoahGCPhase::current_phase();
-    ShenandoahPhaseTimings::Phase cur_phase = (ShenandoahPhaseTimings::Phase)((int)root_phase + (int)_phase + 1);
-    _event.commit(GCId::current(), _worker_id, ShenandoahPhaseTimings::phase_name(cur_phase));
+    _event.commit(GCId::current(), _worker_id, phase_name());
+    GCWorkerTimeline::record(_worker_id, GCWorkerTimeline::phase_end, phase_name());
   }
 }
 
+const char* ShenandoahWorkerTimingsTracker::phase_name() const {
+  ShenandoahPhaseTimings::Phase root_phase = ShenandoahGCPhase::current_phase();
+  ShenandoahPhaseTimings::Phase cur_phase = (ShenandoahPhaseTimings::Phase)((int)root_phase + (int)_phase + 1);
+  return ShenandoahPhaseTimings::phase_name(cur_phase);
+}
+
 ShenandoahTerminationTimingsTracker::ShenandoahTerminationTimingsTracker(uint worker_id) :
   _worker_id(worker_id)  {
   if (ShenandoahTerminationTrace) {
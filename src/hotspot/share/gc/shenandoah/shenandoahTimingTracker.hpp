@@ -36,6 +36,8 @@ private:
   uint _worker_id;
 
   EventGCPhaseParallel _event;
+
+  const char* phase_name() const;
 public:
     ShenandoahWorkerTimingsTracker(ShenandoahWorkerTimings* worker_times, ShenandoahPhaseTimings::GCParPhases phase, uint worker_id);
     ~ShenandoahWorkerTimingsTracker();
@@ -25,6 +25,7 @@
 
 #include "classfile/classLoaderData.hpp"
 #include "classfile/classLoaderDataGraph.hpp"
+#include "gc/shared/gcWorkerTimeline.hpp"
 #include "gc/shared/referenceProcessor.hpp"
 #include "gc/shared/referenceProcessorPhaseTimes.hpp"
 #include "gc/shared/workgroup.hpp"
@@ -538,7 +539,8 @@ void ShenandoahTraversalGC::main_loop_work(T* cl, jushort* live_data, uint worke
       ShenandoahTerminationTimingsTracker term_tracker(worker_id);
       ShenandoahTerminatorTerminator tt(_heap);
 
-      if (terminator->offer_termination(&tt)) return;
+      GCWorkerTimelineTermination timeline(worker_id);
+      if (timeline.set_terminated(terminator->offer_termination(&tt))) return;
     }
   }
 }
@@ -53,6 +53,7 @@
 #include "runtime/arguments.hpp"
 #include "runtime/flags/jvmFlag.hpp"
 #include "runtime/globals.hpp"
+#include "runtime/hardwareCounters.hpp"
 #include "runtime/os.hpp"
 #include "runtime/os_perf.hpp"
 #include "runtime/thread.inline.hpp"
@@ -429,6 +430,43 @@ TRACE_REQUEST_FUNC(ThreadAllocationStatistics) {
   }
 }
 
+TRACE_REQUEST_FUNC(ThreadHardwareCounters) {
+  if (!HardwareCounters::is_enabled()) {
+    return;
+  }
+  ResourceMark rm;
+  int initial_size = Threads::number_of_threads();
+  GrowableArray<HardwareCounterValues> counters(initial_size);
+  GrowableArray<traceid> thread_ids(initial_size);
+  JfrTicks time_stamp = JfrTicks::now();
+  {
+    // The counters of a thread are closed when it is deleted, which
+    // the ThreadsListHandle prevents while the counters are read.
+    // No lock is held, as reading them takes a system call per thread.
+    ThreadsListHandle tlh;
+    JavaThreadIterator jti(tlh.list());
+    for (JavaThread* jt = jti.first(); jt != NULL; jt = jti.next()) {
+      HardwareCounterValues values;
+      if (HardwareCounters::read(jt, &values)) {
+        counters.append(values);
+        thread_ids.append(JFR_THREAD_ID(jt));
+      }
+    }
+  }
+
+  for (int i = 0; i < thread_ids.length(); i++) {
+    const HardwareCounterValues& values = counters.at(i);
+    EventThreadHardwareCounters event(UNTIMED);
+    event.set_cycles(values.cycles());
+    event.set_instructions(values.instructions());
+    event.set_llcMisses(values.llc_misses());
+    event.set_dtlbMisses(values.dtlb_misses());
+    event.set_thread(thread_ids.at(i));
+    event.set_endtime(time_stamp);
+    event.commit();
+  }
+}
+
 /**
  *  PhysicalMemory event represents:
  *
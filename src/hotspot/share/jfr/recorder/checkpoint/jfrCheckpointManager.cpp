@@ -31,6 +31,7 @@
 #include "jfr/recorder/checkpoint/types/jfrTypeManager.hpp"
 #include "jfr/recorder/checkpoint/types/jfrTypeSet.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdEpoch.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdKlassQueue.hpp"
 #include "jfr/recorder/jfrRecorder.hpp"
 #include "jfr/recorder/repository/jfrChunkWriter.hpp"
 #include "jfr/recorder/service/jfrOptionSet.hpp"
@@ -111,6 +112,9 @@ bool JfrCheckpointManager::initialize() {
   if (_lock == NULL) {
     return false;
   }
+  if (!JfrTraceIdKlassQueue::initialize()) {
+    return false;
+  }
   return JfrTypeManager::initialize();
 }
 
@@ -331,6 +335,11 @@ size_t JfrCheckpointManager::write() {
   return processed;
 }
 
+// Writes outstanding checkpoint data without an epoch transition.
+size_t JfrCheckpointManager::flush() {
+  return write_mspace<MutexedWriteOp, CompositeOperation>(_free_list_mspace, _chunkwriter);
+}
+
 size_t JfrCheckpointManager::write_epoch_transition_mspace() {
   return write_mspace<ExclusiveOp, CompositeOperation>(_epoch_transition_mspace, _chunkwriter);
 }
@@ -365,21 +374,33 @@ void JfrCheckpointManager::write_type_set() {
   MutexLocker module_lock(Module_lock);
   if (!LeakProfiler::is_running()) {
     JfrCheckpointWriter writer(true, true, Thread::current());
-    JfrTypeSet::serialize(&writer, NULL, false);
+    JfrTypeSet::serialize(&writer, NULL, false, false);
   } else {
     Thread* const t = Thread::current();
     JfrCheckpointWriter leakp_writer(false, true, t);
     JfrCheckpointWriter writer(false, true, t);
-    JfrTypeSet::serialize(&writer, &leakp_writer, false);
+    JfrTypeSet::serialize(&writer, &leakp_writer, false, false);
     ObjectSampleCheckpoint::on_type_set(leakp_writer);
   }
 }
 
+// Writes the artifacts tagged in the current epoch since the last flushpoint.
+// Leak profiler information is still written on rotation only.
+size_t JfrCheckpointManager::flush_type_set() {
+  assert(!SafepointSynchronize::is_at_safepoint(), "invariant");
+  // can safepoint here
+  MutexLocker cld_lock(ClassLoaderDataGraph_lock);
+  MutexLocker module_lock(Module_lock);
+  JfrCheckpointWriter writer(true, true, Thread::current());
+  return JfrTypeSet::serialize(&writer, NULL, false, true);
+}
+
 void JfrCheckpointManager::write_type_set_for_unloaded_classes() {
   assert_locked_or_safepoint(ClassLoaderDataGraph_lock);
+  JfrTraceIdKlassQueue::on_unloading_classes();
   JfrCheckpointWriter writer(false, true, Thread::current());
   const JfrCheckpointContext ctx = writer.context();
-  JfrTypeSet::serialize(&writer, NULL, true);
+  JfrTypeSet::serialize(&writer, NULL, true, false);
   if (LeakProfiler::is_running()) {
     ObjectSampleCheckpoint::on_type_set_unload(writer);
   }
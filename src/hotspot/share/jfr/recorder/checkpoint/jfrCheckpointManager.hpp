@@ -73,10 +73,12 @@ class JfrCheckpointManager : public JfrCHeapObj {
 
   size_t clear();
   size_t write();
+  size_t flush();
   size_t write_epoch_transition_mspace();
   size_t write_types();
   size_t write_safepoint_types();
   void write_type_set();
+  size_t flush_type_set();
   void shift_epoch();
   void synchronize_epoch();
   bool use_epoch_transition_mspace(const Thread* t) const;
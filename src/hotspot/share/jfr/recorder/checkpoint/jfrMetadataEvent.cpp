@@ -34,11 +34,17 @@
 
 static jbyteArray _metadata_blob = NULL;
 static Semaphore metadata_mutex_semaphore(1);
+static u8 metadata_id = 0;
+static u8 last_written_metadata_id = 0;
 
 void JfrMetadataEvent::lock() {
   metadata_mutex_semaphore.wait();
 }
 
+bool JfrMetadataEvent::try_lock() {
+  return metadata_mutex_semaphore.trywait();
+}
+
 void JfrMetadataEvent::unlock() {
   metadata_mutex_semaphore.signal();
 }
@@ -66,8 +72,9 @@ size_t JfrMetadataEvent::write(JfrChunkWriter& chunkwriter, jlong metadata_offse
   // time data
   chunkwriter.write(JfrTicks::now());
   chunkwriter.write((u8)0); // duration
-  chunkwriter.write((u8)0); // metadata id
+  chunkwriter.write(metadata_id); // metadata id
   write_metadata_blob(chunkwriter, _metadata_blob); // payload
+  last_written_metadata_id = metadata_id;
   unlock(); // open up for java to provide updated metadata
   // fill in size of metadata descriptor event
   const jlong size_written = chunkwriter.current_offset() - metadata_offset;
@@ -75,6 +82,11 @@ size_t JfrMetadataEvent::write(JfrChunkWriter& chunkwriter, jlong metadata_offse
   return size_written;
 }
 
+// the semaphore is assumed to be locked
+bool JfrMetadataEvent::has_pending_update() {
+  return last_written_metadata_id != metadata_id;
+}
+
 void JfrMetadataEvent::update(jbyteArray metadata) {
   JavaThread* thread = (JavaThread*)Thread::current();
   assert(thread->is_Java_thread(), "invariant");
@@ -85,5 +97,6 @@ void JfrMetadataEvent::update(jbyteArray metadata) {
   }
   const oop new_desc_oop = JfrJavaSupport::resolve_non_null(metadata);
   _metadata_blob = new_desc_oop != NULL ? (jbyteArray)JfrJavaSupport::global_jni_handle(new_desc_oop, thread) : NULL;
+  ++metadata_id;
   unlock();
 }
@@ -38,8 +38,10 @@ class JfrChunkWriter;
 class JfrMetadataEvent : AllStatic {
  public:
   static void lock();
+  static bool try_lock();
   static void unlock();
   static size_t write(JfrChunkWriter& writer, jlong metadata_offset);
+  static bool has_pending_update();
   static void update(jbyteArray metadata);
 };
 
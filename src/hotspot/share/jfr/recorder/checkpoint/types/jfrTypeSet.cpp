@@ -34,6 +34,7 @@
 #include "jfr/recorder/checkpoint/types/jfrTypeSet.hpp"
 #include "jfr/recorder/checkpoint/types/jfrTypeSetUtils.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceId.inline.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdKlassQueue.hpp"
 #include "jfr/utilities/jfrHashtable.hpp"
 #include "jfr/utilities/jfrTypes.hpp"
 #include "jfr/writers/jfrTypeWriterHost.hpp"
@@ -73,7 +74,7 @@ static traceid create_symbol_id(traceid artifact_id) {
 }
 
 static bool current_epoch() {
-  return _class_unload;
+  return _class_unload || _flushpoint;
 }
 
 static bool previous_epoch() {
@@ -260,11 +261,64 @@ static void do_klass(Klass* klass) {
   do_implied(klass);
 }
 
+static bool used_in_epoch(const Klass* klass) {
+  assert(klass != NULL, "invariant");
+  return current_epoch() ? USED_THIS_EPOCH(klass) : USED_PREV_EPOCH(klass);
+}
+
+// Klasses already serialized at a flushpoint are still visited, to be
+// registered for their methods and, on rotation, for clearing their tags.
+static void do_queued_klass(Klass* klass) {
+  assert(klass != NULL, "invariant");
+  assert(_subsystem_callback != NULL, "invariant");
+  if (used_in_epoch(klass)) {
+    _subsystem_callback->do_artifact(klass);
+  }
+}
+
+class ImpliedKlassCallback : public CLDClosure {
+ public:
+  void do_cld(ClassLoaderData* cld) {
+    assert(cld != NULL, "invariant");
+    if (cld->is_unsafe_anonymous()) {
+      return;
+    }
+    Klass* const class_loader_klass = cld->class_loader_klass();
+    if (class_loader_klass != NULL && !used_in_epoch(class_loader_klass)) {
+      do_implied(class_loader_klass);
+    }
+  }
+};
+
+// The implied klasses are written on every rotation. A full walk finds them
+// while visiting all klasses; with the queue, the class loader klasses
+// are located through the (far fewer) loaded class loader data instances.
+// Implied klasses used in the epoch have already been visited from the queue.
+static void do_implied_klasses() {
+  Klass* const object_klass = SystemDictionary::Object_klass();
+  if (!used_in_epoch(object_klass)) {
+    do_implied(object_klass);
+  }
+  ImpliedKlassCallback callback;
+  ClassLoaderDataGraph::loaded_cld_do(&callback);
+}
+
 static void do_klasses() {
   if (_class_unload) {
     ClassLoaderDataGraph::classes_unloading_do(&do_unloaded_klass);
     return;
   }
+  if (_flushpoint) {
+    if (JfrTraceIdKlassQueue::is_current_epoch_complete()) {
+      JfrTraceIdKlassQueue::iterate_current_epoch(&do_queued_klass);
+      do_implied_klasses();
+      return;
+    }
+  } else if (JfrTraceIdKlassQueue::is_previous_epoch_complete()) {
+    JfrTraceIdKlassQueue::iterate_previous_epoch(&do_queued_klass);
+    do_implied_klasses();
+    return;
+  }
   ClassLoaderDataGraph::classes_do(&do_klass);
 }
 
@@ -904,16 +958,18 @@ static size_t teardown() {
     assert(_writer != NULL, "invariant");
     ClearKlassAndMethods clear(_writer);
     _artifacts->iterate_klasses(clear);
+    JfrTraceIdKlassQueue::reset_previous_epoch();
     JfrTypeSet::clear();
     ++checkpoint_id;
   }
   return total_count;
 }
 
-static void setup(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload) {
+static void setup(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload, bool flushpoint) {
   _writer = writer;
   _leakp_writer = leakp_writer;
   _class_unload = class_unload;
+  _flushpoint = flushpoint;
   if (_artifacts == NULL) {
     _artifacts = new JfrArtifactSet(class_unload);
   } else {
@@ -926,11 +982,16 @@ static void setup(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer
 
 /**
  * Write all "tagged" (in-use) constant artifacts and their dependencies.
+ *
+ * A flushpoint writes the artifacts tagged in the current epoch that are not
+ * yet serialized and leaves the tags in place. The serialized bits are cleared
+ * when the epoch is rotated out, so each artifact is written once per chunk.
  */
-size_t JfrTypeSet::serialize(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload) {
+size_t JfrTypeSet::serialize(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload, bool flushpoint) {
   assert(writer != NULL, "invariant");
+  assert(!(class_unload && flushpoint), "invariant");
   ResourceMark rm;
-  setup(writer, leakp_writer, class_unload);
+  setup(writer, leakp_writer, class_unload, flushpoint);
   // write order is important because an individual write step
   // might tag an artifact to be written in a subsequent step
   if (!write_klasses()) {
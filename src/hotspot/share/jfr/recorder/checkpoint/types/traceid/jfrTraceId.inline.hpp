@@ -31,6 +31,7 @@
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceId.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdBits.inline.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdEpoch.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdKlassQueue.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdMacros.hpp"
 #include "jfr/support/jfrKlassExtension.hpp"
 #include "oops/arrayKlass.hpp"
@@ -58,9 +59,29 @@ inline traceid JfrTraceId::get(const Thread* t) {
   return TRACE_ID_RAW(t->jfr_thread_local());
 }
 
+inline traceid epoch_bits(traceid bits, u1 epoch) {
+  return bits << (epoch == 0 ? EPOCH_1_SHIFT : EPOCH_2_SHIFT);
+}
+
+// A klass is enqueued when first tagged in an epoch,
+// see JfrTraceIdKlassQueue for how the queue is consumed.
+// The caller reads the epoch once, so that the tag bits
+// and the queue agree should the epoch shift meanwhile.
+inline void tag_klass(const Klass* klass, traceid bits, u1 epoch) {
+  assert(klass != NULL, "invariant");
+  const bool first_use = !TRACE_ID_PREDICATE(klass, (TRANSIENT_BIT | epoch_bits(USED_BIT, epoch)));
+  TRACE_ID_TAG(klass, epoch_bits(bits, epoch));
+  if (first_use) {
+    JfrTraceIdKlassQueue::enqueue(klass, epoch);
+  }
+}
+
 inline traceid JfrTraceId::use(const Klass* klass) {
   assert(klass != NULL, "invariant");
-  return set_used_and_get(klass);
+  const u1 epoch = JfrTraceIdEpoch::current();
+  tag_klass(klass, USED_BIT, epoch);
+  assert(TRACE_ID_PREDICATE(klass, epoch_bits(USED_BIT, epoch)), "invariant");
+  return TRACE_ID(klass);
 }
 
 inline traceid JfrTraceId::use(const Method* method) {
@@ -71,10 +92,11 @@ inline traceid JfrTraceId::use(const Method* method) {
 inline traceid JfrTraceId::use(const Klass* klass, const Method* method) {
   assert(klass != NULL, "invariant");
   assert(method != NULL, "invariant");
-  SET_METHOD_FLAG_USED_THIS_EPOCH(method);
+  const u1 epoch = JfrTraceIdEpoch::current();
+  METHOD_FLAG_TAG(method, (jbyte)epoch_bits(USED_BIT, epoch));
 
-  SET_METHOD_AND_CLASS_USED_THIS_EPOCH(klass);
-  assert(METHOD_AND_CLASS_USED_THIS_EPOCH(klass), "invariant");
+  tag_klass(klass, METHOD_AND_CLASS_IN_USE_BITS, epoch);
+  assert(TRACE_ID_PREDICATE(klass, epoch_bits(METHOD_AND_CLASS_IN_USE_BITS, epoch)), "invariant");
   return (METHOD_ID(klass, method));
 }
 
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderData.inline.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdBits.inline.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdEpoch.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdKlassQueue.hpp"
+#include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdMacros.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/klass.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.hpp"
+#include "utilities/quickSort.hpp"
+
+static const size_t queue_capacity = 32 * K;
+
+// one queue per epoch, indexed by JfrTraceIdEpoch::current() / previous()
+static const Klass** _queues[2] = { NULL, NULL };
+static volatile size_t _tops[2] = { 0, 0 };
+
+// number of elements of the previous epoch queue visited by the type set writer
+static size_t _visited = 0;
+
+static size_t top(u1 epoch) {
+  return MIN2(OrderAccess::load_acquire(&_tops[epoch]), queue_capacity);
+}
+
+bool JfrTraceIdKlassQueue::initialize() {
+  for (u1 epoch = 0; epoch < 2; ++epoch) {
+    assert(_queues[epoch] == NULL, "invariant");
+    _queues[epoch] = NEW_C_HEAP_ARRAY_RETURN_NULL(const Klass*, queue_capacity, mtTracing);
+    if (_queues[epoch] == NULL) {
+      return false;
+    }
+    memset(_queues[epoch], 0, queue_capacity * sizeof(const Klass*));
+  }
+  return true;
+}
+
+void JfrTraceIdKlassQueue::enqueue(const Klass* klass, u1 epoch) {
+  assert(klass != NULL, "invariant");
+  assert(epoch < 2, "invariant");
+  assert(_queues[epoch] != NULL, "invariant");
+  const size_t index = Atomic::add((size_t)1, &_tops[epoch]) - 1;
+  if (index < queue_capacity) {
+    OrderAccess::release_store(&_queues[epoch][index], klass);
+  }
+  // else overflow, the previous epoch will be walked in full
+}
+
+static bool is_complete(u1 epoch) {
+  return OrderAccess::load_acquire(&_tops[epoch]) <= queue_capacity;
+}
+
+static int compare_klasses(const Klass* const& lhs, const Klass* const& rhs) {
+  return lhs < rhs ? -1 : lhs > rhs ? 1 : 0;
+}
+
+// Visits a sorted snapshot of the queue to skip duplicates.
+// Returns the number of queue elements covered by the snapshot.
+// Caller needs ResourceMark.
+static size_t iterate(u1 epoch, void f(Klass*)) {
+  const Klass** const queue = _queues[epoch];
+  const size_t count = top(epoch);
+  if (count == 0) {
+    return 0;
+  }
+  const Klass** const snapshot = NEW_RESOURCE_ARRAY(const Klass*, count);
+  size_t length = 0;
+  for (size_t i = 0; i < count; ++i) {
+    // NULL if scrubbed on class unloading, or if the store is still pending
+    const Klass* const klass = OrderAccess::load_acquire(&queue[i]);
+    if (klass != NULL) {
+      snapshot[length++] = klass;
+    }
+  }
+  QuickSort::sort(snapshot, length, compare_klasses, false);
+  for (size_t i = 0; i < length; ++i) {
+    if (i == 0 || snapshot[i] != snapshot[i - 1]) {
+      f(const_cast<Klass*>(snapshot[i]));
+    }
+  }
+  return count;
+}
+
+bool JfrTraceIdKlassQueue::is_previous_epoch_complete() {
+  return is_complete(JfrTraceIdEpoch::previous());
+}
+
+void JfrTraceIdKlassQueue::iterate_previous_epoch(void f(Klass*)) {
+  _visited = iterate(JfrTraceIdEpoch::previous(), f);
+}
+
+bool JfrTraceIdKlassQueue::is_current_epoch_complete() {
+  return is_complete(JfrTraceIdEpoch::current());
+}
+
+void JfrTraceIdKlassQueue::iterate_current_epoch(void f(Klass*)) {
+  // klasses enqueued after the snapshot are visited on the next flushpoint or rotation
+  iterate(JfrTraceIdEpoch::current(), f);
+}
+
+void JfrTraceIdKlassQueue::reset_previous_epoch() {
+  const u1 epoch = JfrTraceIdEpoch::previous();
+  const Klass** const queue = _queues[epoch];
+  const size_t count = MIN2(Atomic::xchg((size_t)0, &_tops[epoch]), queue_capacity);
+  for (size_t i = 0; i < count; ++i) {
+    const Klass* const klass = queue[i];
+    if (klass != NULL && i >= _visited) {
+      // Tagged by a thread that raced the epoch shift, after the queue was visited.
+      // Clear the tag so that the klass is enqueued again on its next use.
+      CLEAR_METHOD_AND_CLASS_PREV_EPOCH(klass);
+    }
+    queue[i] = NULL;
+  }
+  _visited = 0;
+}
+
+void JfrTraceIdKlassQueue::on_unloading_classes() {
+  assert_locked_or_safepoint(ClassLoaderDataGraph_lock);
+  for (u1 epoch = 0; epoch < 2; ++epoch) {
+    const Klass** const queue = _queues[epoch];
+    if (queue == NULL) {
+      continue;
+    }
+    const size_t count = top(epoch);
+    for (size_t i = 0; i < count; ++i) {
+      const Klass* const klass = OrderAccess::load_acquire(&queue[i]);
+      if (klass != NULL && klass->class_loader_data()->is_unloading()) {
+        queue[i] = NULL;
+      }
+    }
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_JFR_RECORDER_CHECKPOINT_TYPES_TRACEID_JFRTRACEIDKLASSQUEUE_HPP
+#define SHARE_JFR_RECORDER_CHECKPOINT_TYPES_TRACEID_JFRTRACEIDKLASSQUEUE_HPP
+
+#include "memory/allocation.hpp"
+
+class Klass;
+
+//
+// Klasses tagged in use for the first time in an epoch are appended to
+// a queue for that epoch. This lets the type set for the previous epoch
+// be serialized from the queue instead of walking all loaded classes,
+// making the cost of a rotation relative to what was actually used.
+//
+// Tagging happens in contexts that can neither lock nor allocate, for
+// example the thread sampler while the sampled thread is suspended, so
+// each epoch has a preallocated array that is appended to using an atomic
+// increment. Should an array overflow, the epoch is marked incomplete and
+// the type set falls back to a full walk of the ClassLoaderDataGraph.
+//
+// Racing taggers can enqueue a klass more than once, iteration visits
+// each klass only once.
+//
+class JfrTraceIdKlassQueue : AllStatic {
+ public:
+  static bool initialize();
+  static void enqueue(const Klass* klass, u1 epoch);
+
+  // previous epoch, iterated and reset by the type set writer
+  static bool is_previous_epoch_complete();
+  static void iterate_previous_epoch(void f(Klass*));
+  static void reset_previous_epoch();
+
+  // current epoch, iterated by the type set writer at flushpoints
+  static bool is_current_epoch_complete();
+  static void iterate_current_epoch(void f(Klass*));
+
+  // removes klasses whose class loader data is unloading
+  static void on_unloading_classes();
+};
+
+#endif // SHARE_JFR_RECORDER_CHECKPOINT_TYPES_TRACEID_JFRTRACEIDKLASSQUEUE_HPP
@@ -39,7 +39,8 @@ JfrChunkState::JfrChunkState() :
   _start_nanos(0),
   _previous_start_ticks(0),
   _previous_start_nanos(0),
-  _last_checkpoint_offset(0) {}
+  _last_checkpoint_offset(0),
+  _last_metadata_offset(0) {}
 
 JfrChunkState::~JfrChunkState() {
   reset();
@@ -51,6 +52,7 @@ void JfrChunkState::reset() {
     _path = NULL;
   }
   set_last_checkpoint_offset(0);
+  set_last_metadata_offset(0);
 }
 
 void JfrChunkState::set_last_checkpoint_offset(int64_t offset) {
@@ -61,6 +63,22 @@ int64_t JfrChunkState::last_checkpoint_offset() const {
   return _last_checkpoint_offset;
 }
 
+void JfrChunkState::set_last_metadata_offset(int64_t offset) {
+  _last_metadata_offset = offset;
+}
+
+int64_t JfrChunkState::last_metadata_offset() const {
+  return _last_metadata_offset;
+}
+
+int64_t JfrChunkState::start_ticks() const {
+  return _start_ticks;
+}
+
+int64_t JfrChunkState::start_nanos() const {
+  return _start_nanos;
+}
+
 int64_t JfrChunkState::previous_start_ticks() const {
   return _previous_start_ticks;
 }
@@ -96,6 +114,11 @@ int64_t JfrChunkState::last_chunk_duration() const {
   return _start_nanos - _previous_start_nanos;
 }
 
+// duration of the chunk currently being written, used for flushpoints
+int64_t JfrChunkState::current_chunk_duration() const {
+  return (os::javaTimeMillis() * JfrTimeConverter::NANOS_PER_MILLISEC) - _start_nanos;
+}
+
 static char* copy_path(const char* path) {
   assert(path != NULL, "invariant");
   const size_t path_len = strlen(path);
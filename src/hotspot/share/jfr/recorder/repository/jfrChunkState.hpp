@@ -37,6 +37,7 @@ class JfrChunkState : public JfrCHeapObj {
   int64_t _previous_start_ticks;
   int64_t _previous_start_nanos;
   int64_t _last_checkpoint_offset;
+  int64_t _last_metadata_offset;
 
   void update_start_ticks();
   void update_start_nanos();
@@ -48,6 +49,11 @@ class JfrChunkState : public JfrCHeapObj {
   void reset();
   int64_t last_checkpoint_offset() const;
   void set_last_checkpoint_offset(int64_t offset);
+  int64_t last_metadata_offset() const;
+  void set_last_metadata_offset(int64_t offset);
+  int64_t start_ticks() const;
+  int64_t start_nanos() const;
+  int64_t current_chunk_duration() const;
   int64_t previous_start_ticks() const;
   int64_t previous_start_nanos() const;
   int64_t last_chunk_duration() const;
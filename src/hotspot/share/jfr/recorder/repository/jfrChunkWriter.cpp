@@ -74,6 +74,19 @@ bool JfrChunkWriter::open() {
   return is_open;
 }
 
+//
+// A flushpoint makes all data written so far visible to readers of the chunk
+// file while leaving the chunk open for further writes. The header describes
+// the chunk as if it ended at the current offset, the chunk size is updated last.
+//
+void JfrChunkWriter::flush_chunk(int64_t metadata_offset) {
+  assert(this->is_valid(), "invariant");
+  assert(metadata_offset > 0, "invariant");
+  _chunkstate->set_last_metadata_offset(metadata_offset);
+  this->flush();
+  write_flushpoint_header(metadata_offset);
+}
+
 size_t JfrChunkWriter::close(int64_t metadata_offset) {
   write_header(metadata_offset);
   this->flush();
@@ -97,6 +110,22 @@ void JfrChunkWriter::write_header(int64_t metadata_offset) {
   this->write_be_at_offset(_chunkstate->previous_start_ticks(), CHUNK_SIZE_OFFSET + (5 * FILEHEADER_SLOT_SIZE));
 }
 
+void JfrChunkWriter::write_flushpoint_header(int64_t metadata_offset) {
+  assert(this->is_valid(), "invariant");
+  // initial checkpoint event offset
+  this->write_be_at_offset(_chunkstate->last_checkpoint_offset(), CHUNK_SIZE_OFFSET + (1 * FILEHEADER_SLOT_SIZE));
+  // metadata event offset
+  this->write_be_at_offset(metadata_offset, CHUNK_SIZE_OFFSET + (2 * FILEHEADER_SLOT_SIZE));
+  // start of chunk in nanos since epoch
+  this->write_be_at_offset(_chunkstate->start_nanos(), CHUNK_SIZE_OFFSET + (3 * FILEHEADER_SLOT_SIZE));
+  // duration of chunk in nanos, so far
+  this->write_be_at_offset(_chunkstate->current_chunk_duration(), CHUNK_SIZE_OFFSET + (4 * FILEHEADER_SLOT_SIZE));
+  // start of chunk in ticks
+  this->write_be_at_offset(_chunkstate->start_ticks(), CHUNK_SIZE_OFFSET + (5 * FILEHEADER_SLOT_SIZE));
+  // Chunk size, last
+  this->write_be_at_offset(size_written(), CHUNK_SIZE_OFFSET);
+}
+
 void JfrChunkWriter::set_chunk_path(const char* chunk_path) {
   _chunkstate->set_path(chunk_path);
 }
@@ -113,6 +142,10 @@ void JfrChunkWriter::set_last_checkpoint_offset(int64_t offset) {
   _chunkstate->set_last_checkpoint_offset(offset);
 }
 
+int64_t JfrChunkWriter::last_metadata_offset() const {
+  return _chunkstate->last_metadata_offset();
+}
+
 void JfrChunkWriter::time_stamp_chunk_now() {
   _chunkstate->update_time_to_now();
 }
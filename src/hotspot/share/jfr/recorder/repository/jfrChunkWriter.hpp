@@ -43,6 +43,7 @@ class JfrChunkWriter : public JfrChunkWriterBase {
   bool open();
   size_t close(int64_t metadata_offset);
   void write_header(int64_t metadata_offset);
+  void write_flushpoint_header(int64_t metadata_offset);
   void set_chunk_path(const char* chunk_path);
 
  public:
@@ -51,7 +52,9 @@ class JfrChunkWriter : public JfrChunkWriterBase {
   int64_t size_written() const;
   int64_t last_checkpoint_offset() const;
   void set_last_checkpoint_offset(int64_t offset);
+  int64_t last_metadata_offset() const;
   void time_stamp_chunk_now();
+  void flush_chunk(int64_t metadata_offset);
 };
 
 #endif // SHARE_JFR_RECORDER_REPOSITORY_JFRCHUNKWRITER_HPP
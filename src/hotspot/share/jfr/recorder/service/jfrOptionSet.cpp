@@ -95,6 +95,14 @@ void JfrOptionSet::set_num_global_buffers(jlong value) {
   _num_global_buffers = value;
 }
 
+jlong JfrOptionSet::flush_interval() {
+  return _flush_interval;
+}
+
+void JfrOptionSet::set_flush_interval(jlong millis) {
+  _flush_interval = millis;
+}
+
 jint JfrOptionSet::old_object_queue_size() {
   return (jint)_old_object_queue_size;
 }
@@ -171,6 +179,7 @@ const char* const default_sample_threads = "true";
 const char* const default_stack_depth = "64";
 const char* const default_retransform = "true";
 const char* const default_old_object_queue_size = "256";
+const char* const default_flush_interval = "0";
 DEBUG_ONLY(const char* const default_sample_protection = "false";)
 
 // statics
@@ -223,6 +232,13 @@ static DCmdArgument<jlong> _dcmd_old_object_queue_size (
   false,
   default_old_object_queue_size);
 
+static DCmdArgument<NanoTimeArgument> _dcmd_flushinterval(
+  "flushinterval",
+  "Interval at which buffered data is flushed to the current disk chunk (0 disables periodic flushing)",
+  "NANOTIME",
+  false,
+  default_flush_interval);
+
 static DCmdArgument<bool> _dcmd_sample_threads(
   "samplethreads",
   "Thread sampling enable / disable (only sampling when event enabled and sampling enabled)",
@@ -266,6 +282,7 @@ static void register_parser_options() {
   _parser.add_dcmd_option(&_dcmd_sample_threads);
   _parser.add_dcmd_option(&_dcmd_retransform);
   _parser.add_dcmd_option(&_dcmd_old_object_queue_size);
+  _parser.add_dcmd_option(&_dcmd_flushinterval);
   DEBUG_ONLY(_parser.add_dcmd_option(&_dcmd_sample_protection);)
 }
 
@@ -304,6 +321,7 @@ jlong JfrOptionSet::_thread_buffer_size = 0;
 jlong JfrOptionSet::_memory_size = 0;
 jlong JfrOptionSet::_num_global_buffers = 0;
 jlong JfrOptionSet::_old_object_queue_size = 0;
+jlong JfrOptionSet::_flush_interval = 0;
 u4 JfrOptionSet::_stack_depth = STACK_DEPTH_DEFAULT;
 jboolean JfrOptionSet::_sample_threads = JNI_TRUE;
 jboolean JfrOptionSet::_retransform = JNI_TRUE;
@@ -322,6 +340,9 @@ bool JfrOptionSet::initialize(Thread* thread) {
     set_retransform(_dcmd_retransform.value());
   }
   set_old_object_queue_size(_dcmd_old_object_queue_size.value());
+  if (!adjust_flush_interval()) {
+    return false;
+  }
   return adjust_memory_options();
 }
 
@@ -638,6 +659,33 @@ static bool ensure_valid_minimum_sizes() {
   return true;
 }
 
+static const jlong MIN_FLUSH_INTERVAL_MILLIS = 10;
+
+/**
+ * A zero flush interval disables periodic flushing, data then only becomes
+ * visible in the repository on chunk rotation. Non-zero values are kept at
+ * millisecond granularity and must not be less than MIN_FLUSH_INTERVAL_MILLIS.
+ */
+bool JfrOptionSet::adjust_flush_interval() {
+  const jlong nanos = _dcmd_flushinterval.value()._nanotime;
+  if (nanos < 0) {
+    log_error(arguments) ("Value specified for option \"%s\" must not be negative", _dcmd_flushinterval.name());
+    return false;
+  }
+  if (nanos == 0) {
+    set_flush_interval(0);
+    return true;
+  }
+  const jlong millis = nanos / NANOSECS_PER_MILLISEC;
+  if (millis < MIN_FLUSH_INTERVAL_MILLIS) {
+    log_error(arguments) ("Value specified for option \"%s\" is lower than the minimum of " JLONG_FORMAT " ms",
+                          _dcmd_flushinterval.name(), MIN_FLUSH_INTERVAL_MILLIS);
+    return false;
+  }
+  set_flush_interval(millis);
+  return true;
+}
+
 /**
  * Starting with the initial set of memory values from the user,
  * sanitize, enforce min/max rules and adjust to a set of consistent options.
@@ -33,6 +33,7 @@
 #include "jfr/recorder/repository/jfrChunkRotation.hpp"
 #include "jfr/recorder/repository/jfrChunkWriter.hpp"
 #include "jfr/recorder/repository/jfrRepository.hpp"
+#include "jfr/recorder/service/jfrOptionSet.hpp"
 #include "jfr/recorder/service/jfrPostBox.hpp"
 #include "jfr/recorder/service/jfrRecorderService.hpp"
 #include "jfr/recorder/stacktrace/jfrStackTraceRepository.hpp"
@@ -132,7 +133,7 @@ class RotationLock : public StackObj {
   bool not_acquired() const { return !_acquired; }
 };
 
-static int64_t write_checkpoint_event_prologue(JfrChunkWriter& cw, u8 type_id) {
+static int64_t write_checkpoint_event_prologue(JfrChunkWriter& cw, u8 type_id, bool flushpoint) {
   const int64_t last_cp_offset = cw.last_checkpoint_offset();
   const int64_t delta_to_last_checkpoint = 0 == last_cp_offset ? 0 : last_cp_offset - cw.current_offset();
   cw.reserve(sizeof(u4));
@@ -140,7 +141,7 @@ static int64_t write_checkpoint_event_prologue(JfrChunkWriter& cw, u8 type_id) {
   cw.write(JfrTicks::now());
   cw.write((int64_t)0); // duration
   cw.write(delta_to_last_checkpoint);
-  cw.write<bool>(false); // flushpoint
+  cw.write<bool>(flushpoint);
   cw.write((u4)1); // nof types in this checkpoint
   cw.write(type_id);
   const int64_t number_of_elements_offset = cw.current_offset();
@@ -154,17 +155,19 @@ class WriteCheckpointEvent : public StackObj {
   JfrChunkWriter& _cw;
   u8 _type_id;
   ContentFunctor& _content_functor;
+  bool _flushpoint;
  public:
-  WriteCheckpointEvent(JfrChunkWriter& cw, u8 type_id, ContentFunctor& functor) :
+  WriteCheckpointEvent(JfrChunkWriter& cw, u8 type_id, ContentFunctor& functor, bool flushpoint = false) :
     _cw(cw),
     _type_id(type_id),
-    _content_functor(functor) {
+    _content_functor(functor),
+    _flushpoint(flushpoint) {
     assert(_cw.is_valid(), "invariant");
   }
   bool process() {
     // current_cp_offset is also offset for the event size header field
     const int64_t current_cp_offset = _cw.current_offset();
-    const int64_t num_elements_offset = write_checkpoint_event_prologue(_cw, _type_id);
+    const int64_t num_elements_offset = write_checkpoint_event_prologue(_cw, _type_id, _flushpoint);
     // invocation
     _content_functor.process();
     const u4 number_of_elements = (u4)_content_functor.processed();
@@ -227,6 +230,7 @@ class WriteStackTraceRepository : public StackObj {
 };
 
 static bool recording = false;
+static jlong last_flush_millis = 0;
 
 static void set_recording_state(bool is_recording) {
   OrderAccess::storestore();
@@ -256,6 +260,7 @@ void JfrRecorderService::start() {
   set_recording_state(true);
   assert(is_recording(), "invariant");
   open_new_chunk();
+  last_flush_millis = os::javaTimeMillis();
   log_debug(jfr, system)("Recording STARTED");
 }
 
@@ -327,6 +332,7 @@ void JfrRecorderService::rotate(int msgs) {
   if (msgs & (MSGBIT(MSG_STOP))) {
     stop();
   }
+  last_flush_millis = os::javaTimeMillis();
 }
 
 void JfrRecorderService::prepare_for_vm_error_rotation() {
@@ -392,14 +398,14 @@ typedef WriteCheckpointEvent<WriteStackTraceRepository> WriteStackTraceCheckpoin
 typedef WriteCheckpointEvent<WriteStringPool> WriteStringPoolCheckpoint;
 typedef WriteCheckpointEvent<WriteStringPoolSafepoint> WriteStringPoolCheckpointSafepoint;
 
-static void write_stacktrace_checkpoint(JfrStackTraceRepository& stack_trace_repo, JfrChunkWriter& chunkwriter, bool clear) {
+static void write_stacktrace_checkpoint(JfrStackTraceRepository& stack_trace_repo, JfrChunkWriter& chunkwriter, bool clear, bool flushpoint = false) {
   WriteStackTraceRepository write_stacktrace_repo(stack_trace_repo, chunkwriter, clear);
-  WriteStackTraceCheckpoint write_stack_trace_checkpoint(chunkwriter, TYPE_STACKTRACE, write_stacktrace_repo);
+  WriteStackTraceCheckpoint write_stack_trace_checkpoint(chunkwriter, TYPE_STACKTRACE, write_stacktrace_repo, flushpoint);
   write_stack_trace_checkpoint.process();
 }
-static void write_stringpool_checkpoint(JfrStringPool& string_pool, JfrChunkWriter& chunkwriter) {
+static void write_stringpool_checkpoint(JfrStringPool& string_pool, JfrChunkWriter& chunkwriter, bool flushpoint = false) {
   WriteStringPool write_string_pool(string_pool);
-  WriteStringPoolCheckpoint write_string_pool_checkpoint(chunkwriter, TYPE_STRING, write_string_pool);
+  WriteStringPoolCheckpoint write_string_pool_checkpoint(chunkwriter, TYPE_STRING, write_string_pool, flushpoint);
   write_string_pool_checkpoint.process();
 }
 
@@ -533,6 +539,92 @@ void JfrRecorderService::process_full_buffers() {
   }
 }
 
+//
+// flush sequence
+//
+//  lock stream lock ->
+//    write stack trace checkpoint (flushpoint) ->
+//      write string pool checkpoint (flushpoint) ->
+//        write storage ->
+//          release stream lock ->
+//            write type set (flushpoint) ->
+//              lock metadata descriptor (if updated) ->
+//                lock stream lock ->
+//                  write outstanding checkpoints ->
+//                    write metadata event (if updated) ->
+//                      update chunk header ->
+//                        release stream lock
+//
+// Unlike a rotation, a flush does not involve a safepoint or an epoch shift.
+// The type set is written after the storage, so that it covers the klasses
+// and methods tagged by the events just written. It needs locks that can
+// safepoint, so neither the stream lock nor the metadata descriptor lock
+// can be held meanwhile. Data written to the chunk becomes visible to
+// readers only when the chunk header is updated.
+//
+void JfrRecorderService::flush() {
+  if (!is_recording() || !_storage.control().to_disk() || !_chunkwriter.is_valid()) {
+    return;
+  }
+  RotationLock rl(Thread::current());
+  if (rl.not_acquired()) {
+    return;
+  }
+  ResourceMark rm;
+  HandleMark hm;
+  {
+    MutexLocker stream_lock(JfrStream_lock, Mutex::_no_safepoint_check_flag);
+    assert(_chunkwriter.is_valid(), "invariant");
+    write_stacktrace_checkpoint(_stack_trace_repository, _chunkwriter, false, true);
+    write_stringpool_checkpoint(_string_pool, _chunkwriter, true);
+    _storage.write();
+  }
+  _checkpoint_manager.flush_type_set();
+  // Java could be in the process of updating the metadata descriptor,
+  // do not wait for it as that is not safepoint safe.
+  bool write_metadata = false;
+  if (JfrMetadataEvent::try_lock()) {
+    write_metadata = _chunkwriter.last_metadata_offset() == 0 || JfrMetadataEvent::has_pending_update();
+    if (!write_metadata) {
+      JfrMetadataEvent::unlock();
+    }
+  }
+  MutexLocker stream_lock(JfrStream_lock, Mutex::_no_safepoint_check_flag);
+  _checkpoint_manager.flush();
+  if (!write_metadata && _chunkwriter.last_metadata_offset() == 0) {
+    // no metadata in the current chunk yet, update the header on the next flush
+    return;
+  }
+  // write_metadata_event() releases the metadata descriptor lock
+  const int64_t metadata_offset = write_metadata ? write_metadata_event(_chunkwriter) : _chunkwriter.last_metadata_offset();
+  _chunkwriter.flush_chunk(metadata_offset);
+  log_trace(jfr, system)("Flushpoint at " INT64_FORMAT " bytes", _chunkwriter.size_written());
+}
+
+void JfrRecorderService::flush_if_due() {
+  const jlong interval = JfrOptionSet::flush_interval();
+  if (interval == 0 || !is_recording()) {
+    return;
+  }
+  const jlong now = os::javaTimeMillis();
+  if (now - last_flush_millis < interval) {
+    return;
+  }
+  last_flush_millis = now;
+  flush();
+}
+
+// Number of millis the recorder thread can wait for messages before the
+// next flush is due, 0 if it can wait indefinitely.
+jlong JfrRecorderService::flush_timeout() {
+  const jlong interval = JfrOptionSet::flush_interval();
+  if (interval == 0 || !is_recording()) {
+    return 0;
+  }
+  const jlong remaining = interval - (os::javaTimeMillis() - last_flush_millis);
+  return remaining > 0 ? remaining : 1;
+}
+
 void JfrRecorderService::scavenge() {
   _storage.scavenge();
 }
@@ -69,6 +69,9 @@ class JfrRecorderService : public StackObj {
   void start();
   void rotate(int msgs);
   void process_full_buffers();
+  void flush();
+  void flush_if_due();
+  static jlong flush_timeout();
   void scavenge();
   void evaluate_chunk_size_for_rotation();
   static bool is_recording();
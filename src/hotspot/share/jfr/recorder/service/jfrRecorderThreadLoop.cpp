@@ -55,7 +55,8 @@ void recorderthread_entry(JavaThread* thread, Thread* unused) {
     // JFR MESSAGE LOOP PROCESSING - BEGIN
     while (!done) {
       if (post_box.is_empty()) {
-        JfrMsg_lock->wait();
+        // a non-zero timeout wakes the loop up for periodic flushpoints
+        JfrMsg_lock->wait(JfrRecorderService::flush_timeout());
       }
       msgs = post_box.collect();
       JfrMsg_lock->unlock();
@@ -72,6 +73,8 @@ void recorderthread_entry(JavaThread* thread, Thread* unused) {
         service.start();
       } else if (ROTATE) {
         service.rotate(msgs);
+      } else {
+        service.flush_if_due();
       }
       JfrMsg_lock->lock();
       post_box.notify_waiters();
@@ -36,6 +36,7 @@
 #include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/thread.inline.hpp"
 
@@ -71,12 +72,20 @@ JfrStringPool::~JfrStringPool() {
 }
 
 static const size_t unlimited_mspace_size = 0;
-static const size_t string_pool_cache_count = 2;
+static const size_t string_pool_min_cache_count = 2;
+static const size_t string_pool_max_cache_count = 8;
 static const size_t string_pool_buffer_size = 512 * K;
 
+// Leases are acquired lock-free from the cached buffers. Only when all of them
+// are in use does a thread allocate a transient buffer under the mspace lock,
+// so size the cache for the number of threads that can write concurrently.
+static size_t string_pool_cache_count() {
+  return MIN2(MAX2((size_t)os::active_processor_count(), string_pool_min_cache_count), string_pool_max_cache_count);
+}
+
 bool JfrStringPool::initialize() {
   assert(_free_list_mspace == NULL, "invariant");
-  _free_list_mspace = new JfrStringPoolMspace(string_pool_buffer_size, unlimited_mspace_size, string_pool_cache_count, this);
+  _free_list_mspace = new JfrStringPoolMspace(string_pool_buffer_size, unlimited_mspace_size, string_pool_cache_count(), this);
   if (_free_list_mspace == NULL || !_free_list_mspace->initialize()) {
     return false;
   }
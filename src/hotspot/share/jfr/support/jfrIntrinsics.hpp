@@ -32,6 +32,19 @@
 #include "jfr/support/jfrThreadExtension.hpp"
 #include "jfr/utilities/jfrTime.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceIdMacros.hpp"
+#include "memory/allocation.hpp"
+
+class Klass;
+
+// Runtime support for the compiled JVM.getClassId(). A klass tagged in use
+// for the first time in an epoch has to be enqueued, see JfrTraceIdKlassQueue,
+// so compiled code only reads the trace id of a klass that is already tagged
+// in the current epoch and otherwise calls use_klass(), a leaf.
+class JfrIntrinsicSupport : AllStatic {
+ public:
+  static address epoch_address();
+  static jlong use_klass(Klass* klass);
+};
 
 #define JFR_TEMPLATES(template) \
   template(jdk_jfr_internal_JVM,          "jdk/jfr/internal/JVM")
@@ -45,6 +45,14 @@ template <> OopStorage* WeakHandle<vm_resolved_method_table_data>::get_storage()
   return ResolvedMethodTable::weak_storage();
 }
 
+template <> OopStorage* WeakHandle<vm_jvmti_tag_map_data>::get_storage() {
+  return SystemDictionary::vm_weak_oop_storage();
+}
+
+template <> OopStorage* WeakHandle<vm_allocation_sample_data>::get_storage() {
+  return SystemDictionary::vm_weak_oop_storage();
+}
+
 template <WeakHandleType T>
 WeakHandle<T> WeakHandle<T>::create(Handle obj) {
   assert(obj() != NULL, "no need to create weak null oop");
@@ -80,3 +88,5 @@ void WeakHandle<T>::print_on(outputStream* st) const {
 template class WeakHandle<vm_class_loader_data>;
 template class WeakHandle<vm_string_table_data>;
 template class WeakHandle<vm_resolved_method_table_data>;
+template class WeakHandle<vm_jvmti_tag_map_data>;
+template class WeakHandle<vm_allocation_sample_data>;
@@ -2899,7 +2899,7 @@ bool LibraryCallKit::inline_native_time_funcs(address funcAddr, const char* func
 
 /*
 * oop -> myklass
-* myklass->trace_id |= USED
+* if (!(myklass->trace_id & USED_THIS_EPOCH)) JfrIntrinsicSupport::use_klass(myklass)
 * return myklass->trace_id & ~0x3
 */
 bool LibraryCallKit::inline_native_classID() {
@@ -2911,10 +2911,25 @@ bool LibraryCallKit::inline_native_classID() {
   Node* insp = basic_plus_adr(kls, in_bytes(offset));
   Node* tvalue = make_load(NULL, insp, TypeLong::LONG, T_LONG, MemNode::unordered);
 
-  Node* clsused = longcon(0x01l); // set the class bit
-  Node* orl = _gvn.transform(new OrLNode(tvalue, clsused));
-  const TypePtr *adr_type = _gvn.type(insp)->isa_ptr();
-  store_to_memory(control(), insp, orl, T_LONG, adr_type, MemNode::unordered);
+  // The bit tagging a klass in use is 1 in the first epoch and 2 in the second.
+  // A klass must be enqueued when first tagged in an epoch, which is left to
+  // the runtime; tagging does not change the id bits of tvalue.
+  Node* epoch_adr = makecon(TypeRawPtr::make(JfrIntrinsicSupport::epoch_address()));
+  Node* epoch = make_load(NULL, epoch_adr, TypeInt::BOOL, T_BOOLEAN, MemNode::unordered);
+  Node* epoch_bit = _gvn.transform(new LShiftLNode(longcon(0x01l), epoch));
+  Node* used = _gvn.transform(new AndLNode(tvalue, epoch_bit));
+
+  IdealKit ideal(this);
+#define __ ideal.
+  __ if_then(used, BoolTest::eq, longcon(0), PROB_UNLIKELY_MAG(3)); {
+    sync_kit(ideal);
+    make_runtime_call(RC_LEAF, OptoRuntime::class_id_Type(),
+                      CAST_FROM_FN_PTR(address, JfrIntrinsicSupport::use_klass),
+                      "use_klass", TypePtr::BOTTOM, kls);
+    __ sync_kit(this);
+  } __ end_if();
+  final_sync(ideal);
+#undef __
 
 #ifdef TRACE_ID_META_BITS
   Node* mbits = longcon(~TRACE_ID_META_BITS);
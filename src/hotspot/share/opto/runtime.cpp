@@ -1160,6 +1160,22 @@ const TypeFunc* OptoRuntime::osr_end_Type() {
   return TypeFunc::make(domain, range);
 }
 
+#if INCLUDE_JFR
+const TypeFunc* OptoRuntime::class_id_Type() {
+  // create input type (domain)
+  const Type **fields = TypeTuple::fields(1);
+  fields[TypeFunc::Parms+0] = TypeKlassPtr::OBJECT; // Klass*
+  const TypeTuple *domain = TypeTuple::make(TypeFunc::Parms+1, fields);
+
+  // create result type
+  fields = TypeTuple::fields(2);
+  fields[TypeFunc::Parms+0] = TypeLong::LONG;       // trace id
+  fields[TypeFunc::Parms+1] = Type::HALF;
+  const TypeTuple *range = TypeTuple::make(TypeFunc::Parms+2, fields);
+  return TypeFunc::make(domain, range);
+}
+#endif
+
 //-------------- methodData update helpers
 
 const TypeFunc* OptoRuntime::profile_receiver_type_Type() {
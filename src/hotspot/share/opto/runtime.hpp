@@ -304,6 +304,11 @@ private:
   // leaf methodData routine types
   static const TypeFunc* profile_receiver_type_Type();
 
+#if INCLUDE_JFR
+  // leaf tagging a klass for JVM.getClassId()
+  static const TypeFunc* class_id_Type();
+#endif
+
   // leaf on stack replacement interpreter accessor types
   static const TypeFunc* fetch_int_Type();
   static const TypeFunc* fetch_long_Type();
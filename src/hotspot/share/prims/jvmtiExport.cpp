@@ -1464,16 +1464,24 @@ void JvmtiExport::post_thread_end(JavaThread *thread) {
   }
 }
 
-void JvmtiExport::post_object_free(JvmtiEnv* env, jlong tag) {
-  assert(SafepointSynchronize::is_at_safepoint(), "must be executed at safepoint");
-  assert(env->is_enabled(JVMTI_EVENT_OBJECT_FREE), "checking");
+void JvmtiExport::post_object_free(JvmtiEnv* env, GrowableArray<jlong>* objects) {
+  assert(objects != NULL, "Nothing to post");
+  JavaThread* thread = JavaThread::current();
+  if (!env->is_enabled(JVMTI_EVENT_OBJECT_FREE)) {
+    return; // the event type has been disabled in the meantime
+  }
 
-  EVT_TRIG_TRACE(JVMTI_EVENT_OBJECT_FREE, ("[?] Trg Object Free triggered" ));
-  EVT_TRACE(JVMTI_EVENT_OBJECT_FREE, ("[?] Evt Object Free sent"));
+  EVT_TRIG_TRACE(JVMTI_EVENT_OBJECT_FREE, ("[%s] Trg Object Free triggered",
+                                           JvmtiTrace::safe_get_thread_name(thread)));
 
+  JvmtiJavaThreadEventTransition jet(thread);
   jvmtiEventObjectFree callback = env->callbacks()->ObjectFree;
   if (callback != NULL) {
-    (*callback)(env->jvmti_external(), tag);
+    for (int index = 0; index < objects->length(); index++) {
+      EVT_TRACE(JVMTI_EVENT_OBJECT_FREE, ("[%s] Evt Object Free sent",
+                                          JvmtiTrace::safe_get_thread_name(thread)));
+      (*callback)(env->jvmti_external(), objects->at(index));
+    }
   }
 }
 
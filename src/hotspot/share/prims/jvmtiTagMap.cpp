@@ -41,6 +41,7 @@
 #include "oops/objArrayOop.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/typeArrayOop.inline.hpp"
+#include "oops/weakHandle.inline.hpp"
 #include "prims/jvmtiEventController.hpp"
 #include "prims/jvmtiEventController.inline.hpp"
 #include "prims/jvmtiExport.hpp"
@@ -69,20 +70,26 @@
 
 // JvmtiTagHashmapEntry
 //
-// Each entry encapsulates a reference to the tagged object
+// Each entry encapsulates a weak reference to the tagged object
 // and the tag value. In addition an entry includes a next pointer which
 // is used to chain entries together.
+//
+// The reference to the tagged object is a WeakHandle allocated in the
+// VM weak OopStorage. The GC processes it, together with all other VM
+// weak handles, as part of its (parallel or concurrent) OopStorage weak
+// processing. References to dead objects are cleared by the GC and the
+// entries are removed lazily, outside of GC pauses.
 
 class JvmtiTagHashmapEntry : public CHeapObj<mtInternal> {
  private:
   friend class JvmtiTagMap;
 
-  oop _object;                          // tagged object
-  jlong _tag;                           // the tag
-  JvmtiTagHashmapEntry* _next;          // next on the list
+  WeakHandle<vm_jvmti_tag_map_data> _object; // tagged object
+  jlong _tag;                                // the tag
+  JvmtiTagHashmapEntry* _next;               // next on the list
 
   inline void init(oop object, jlong tag) {
-    _object = object;
+    _object = WeakHandle<vm_jvmti_tag_map_data>::create(Handle(Thread::current(), object));
     _tag = tag;
     _next = NULL;
   }
@@ -90,20 +97,20 @@ class JvmtiTagHashmapEntry : public CHeapObj<mtInternal> {
   // constructor
   JvmtiTagHashmapEntry(oop object, jlong tag) { init(object, tag); }
 
+  // release the weak reference, the entry can then be deleted or reused
+  inline void release() {
+    _object.release();
+    _object = WeakHandle<vm_jvmti_tag_map_data>();
+  }
+
  public:
 
   // accessor methods
-  inline oop* object_addr() { return &_object; }
-  inline oop object()       { return NativeAccess<ON_PHANTOM_OOP_REF>::oop_load(object_addr()); }
+  inline oop object()       { return _object.resolve(); }
   // Peek at the object without keeping it alive. The returned object must be
   // kept alive using a normal access if it leaks out of a thread transition from VM.
-  inline oop object_peek()  {
-    return NativeAccess<ON_PHANTOM_OOP_REF | AS_NO_KEEPALIVE>::oop_load(object_addr());
-  }
-
-  inline oop object_raw() {
-    return RawAccess<>::oop_load(object_addr());
-  }
+  // Returns NULL if the object has been found dead by the GC.
+  inline oop object_peek()  { return _object.peek(); }
 
   inline jlong tag() const  { return _tag; }
 
@@ -130,9 +137,13 @@ class JvmtiTagHashmapEntry : public CHeapObj<mtInternal> {
 //
 // A hashmap maintains a count of the number entries in the hashmap
 // and resizes if the number of entries exceeds a given threshold.
-// The threshold is specified as a percentage of the size - for
-// example a threshold of 0.75 will trigger the hashmap to resize
-// if the number of entries is >75% of table size.
+// The threshold is specified as a load factor, the average length
+// of a chain, relative to the size of the table. The size of the table
+// is always a power of two and doubles on each resize.
+//
+// As the GC may move objects, entries may be found at positions that no
+// longer match the address of the object. The owning JvmtiTagMap is
+// notified by the GC and rehashes the table before the next use.
 //
 // A hashmap provides functions for adding, removing, and finding
 // entries. It also provides a function to iterate over all entries
@@ -149,9 +160,13 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     initial_trace_threshold = small_trace_threshold
   };
 
-  static int _sizes[];                  // array of possible hashmap sizes
-  int _size;                            // actual size of the table
-  int _size_index;                      // index into size table
+  enum {
+    initial_size_log = 12,                           // 4096 buckets
+    max_size_log = 30                                // upper bound for resizing
+  };
+
+  int _size;                            // actual size of the table, a power of two
+  int _size_log;                        // log2 of the size
 
   int _entry_count;                     // number of entries in the hashmap
 
@@ -168,9 +183,9 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
   int trace_threshold() const                   { return _trace_threshold; }
 
   // initialize the hashmap
-  void init(int size_index=0, float load_factor=4.0f) {
-    int initial_size =  _sizes[size_index];
-    _size_index = size_index;
+  void init(int size_log=initial_size_log, float load_factor=4.0f) {
+    int initial_size = 1 << size_log;
+    _size_log = size_log;
     _size = initial_size;
     _entry_count = 0;
     _trace_threshold = initial_trace_threshold;
@@ -188,11 +203,13 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     }
   }
 
-  // hash a given key (oop) with the specified size
+  // hash a given key (oop) with the specified size, a power of two
   static unsigned int hash(oop key, int size) {
     const oop obj = Access<>::resolve(key);
-    const unsigned int hash = Universe::heap()->hash_oop(obj);
-    return hash % size;
+    unsigned int hash = Universe::heap()->hash_oop(obj);
+    // fold the upper bits into the lower bits used to index the table
+    hash ^= (hash >> 15) ^ (hash >> 23);
+    return hash & (size - 1);
   }
 
   // hash a given key (oop)
@@ -200,15 +217,15 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     return hash(key, _size);
   }
 
-  // resize the hashmap - allocates a large table and re-hashes
+  // resize the hashmap - allocates a larger table and re-hashes
   // all entries into the new table.
   void resize() {
-    int new_size_index = _size_index+1;
-    int new_size = _sizes[new_size_index];
-    if (new_size < 0) {
+    int new_size_log = _size_log + 1;
+    if (new_size_log > max_size_log) {
       // hashmap already at maximum capacity
       return;
     }
+    int new_size = 1 << new_size_log;
 
     // allocate new table
     size_t s = new_size * sizeof(JvmtiTagHashmapEntry*);
@@ -225,22 +242,16 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
       new_table[i] = NULL;
     }
 
-    // rehash all entries into the new table
+    // rehash all entries into the new table, entries for dead
+    // objects keep their relative position until they are removed.
     for (i=0; i<_size; i++) {
       JvmtiTagHashmapEntry* entry = _table[i];
       while (entry != NULL) {
         JvmtiTagHashmapEntry* next = entry->next();
         oop key = entry->object_peek();
-        assert(key != NULL, "jni weak reference cleared!!");
-        unsigned int h = hash(key, new_size);
-        JvmtiTagHashmapEntry* anchor = new_table[h];
-        if (anchor == NULL) {
-          new_table[h] = entry;
-          entry->set_next(NULL);
-        } else {
-          entry->set_next(anchor);
-          new_table[h] = entry;
-        }
+        unsigned int h = (key == NULL) ? (unsigned int)i : hash(key, new_size);
+        entry->set_next(new_table[h]);
+        new_table[h] = entry;
         entry = next;
       }
     }
@@ -248,7 +259,7 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     // free old table and update settings.
     os::free((void*)_table);
     _table = new_table;
-    _size_index = new_size_index;
+    _size_log = new_size_log;
     _size = new_size;
 
     // compute new resize threshold
@@ -280,23 +291,18 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
  public:
 
   // create a JvmtiTagHashmap of a preferred size and optionally a load factor.
-  // The preferred size is rounded down to an actual size.
+  // The preferred size is rounded up to a power of two.
   JvmtiTagHashmap(int size, float load_factor=0.0f) {
-    int i=0;
-    while (_sizes[i] < size) {
-      if (_sizes[i] < 0) {
-        assert(i > 0, "sanity check");
-        i--;
-        break;
-      }
-      i++;
+    int size_log = initial_size_log;
+    while ((1 << size_log) < size && size_log < max_size_log) {
+      size_log++;
     }
 
     // if a load factor is specified then use it, otherwise use default
     if (load_factor > 0.01f) {
-      init(i, load_factor);
+      init(size_log, load_factor);
     } else {
-      init(i);
+      init(size_log);
     }
   }
 
@@ -380,12 +386,6 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
   void entry_iterate(JvmtiTagHashmapEntryClosure* closure);
 };
 
-// possible hashmap sizes - odd primes that roughly double in size.
-// To avoid excessive resizing the odd primes from 4801-76831 and
-// 76831-307261 have been removed. The list must be terminated by -1.
-int JvmtiTagHashmap::_sizes[] =  { 4801, 76831, 307261, 614563, 1228891,
-    2457733, 4915219, 9830479, 19660831, 39321619, 78643219, -1 };
-
 
 // A supporting class for iterating over all entries in Hashmap
 class JvmtiTagHashmapEntryClosure {
@@ -443,7 +443,9 @@ JvmtiTagMap::JvmtiTagMap(JvmtiEnv* env) :
   _env(env),
   _lock(Mutex::nonleaf+2, "JvmtiTagMap._lock", false),
   _free_entries(NULL),
-  _free_entries_count(0)
+  _free_entries_count(0),
+  _needs_rehashing(false),
+  _needs_cleaning(false)
 {
   assert(JvmtiThreadState_lock->is_locked(), "sanity check");
   assert(((JvmtiEnvBase *)env)->tag_map() == NULL, "tag map already exists for environment");
@@ -467,6 +469,7 @@ JvmtiTagMap::~JvmtiTagMap() {
     JvmtiTagHashmapEntry* entry = table[j];
     while (entry != NULL) {
       JvmtiTagHashmapEntry* next = entry->next();
+      entry->release();
       delete entry;
       entry = next;
     }
@@ -507,6 +510,7 @@ JvmtiTagHashmapEntry* JvmtiTagMap::create_entry(oop ref, jlong tag) {
 // destroy an entry by returning it to the free list
 void JvmtiTagMap::destroy_entry(JvmtiTagHashmapEntry* entry) {
   assert(SafepointSynchronize::is_at_safepoint() || is_locked(), "checking");
+  entry->release();
   // limit the size of the free list
   if (_free_entries_count >= max_free_entries) {
     delete entry;
@@ -544,6 +548,138 @@ bool JvmtiTagMap::is_empty() {
   return hashmap()->entry_count() == 0;
 }
 
+// Bring the hashmap up to date after a GC: entries for dead objects are
+// removed and, if objects may have moved, live entries are rehashed.
+//
+// The tags of removed entries are collected in objects for the caller to
+// post ObjectFree events once the lock has been released. If objects is
+// NULL and ObjectFree events are enabled, dead entries are left in place
+// to be removed by a later call that can post the events.
+void JvmtiTagMap::check_hashmap(GrowableArray<jlong>* objects) {
+  assert(SafepointSynchronize::is_at_safepoint() || is_locked(), "checking");
+  if (!_needs_cleaning && !_needs_rehashing) {
+    return;
+  }
+
+  const bool post_object_free = env()->is_enabled(JVMTI_EVENT_OBJECT_FREE);
+  const bool remove_dead = !post_object_free || objects != NULL;
+  const bool rehash = _needs_rehashing;
+
+  // counters used for trace message
+  int freed = 0;
+  int moved = 0;
+
+  JvmtiTagHashmap* hashmap = this->hashmap();
+
+  // reenable sizing (if disabled)
+  hashmap->set_resizing_enabled(true);
+
+  JvmtiTagHashmapEntry** table = hashmap->table();
+  int size = hashmap->size();
+
+  JvmtiTagHashmapEntry* delayed_add = NULL;
+
+  for (int pos = 0; pos < size && hashmap->entry_count() > 0; ++pos) {
+    JvmtiTagHashmapEntry* entry = table[pos];
+    JvmtiTagHashmapEntry* prev = NULL;
+
+    while (entry != NULL) {
+      JvmtiTagHashmapEntry* next = entry->next();
+      oop obj = entry->object_peek();
+
+      // has object been GC'ed
+      if (obj == NULL) {
+        if (remove_dead) {
+          // grab the tag
+          jlong tag = entry->tag();
+          guarantee(tag != 0, "checking");
+
+          // remove GC'ed entry from hashmap and return the
+          // entry to the free list
+          hashmap->remove(prev, pos, entry);
+          destroy_entry(entry);
+
+          // record the tag for the event to the profiler
+          if (post_object_free) {
+            objects->append(tag);
+          }
+
+          ++freed;
+        } else {
+          prev = entry;
+        }
+      } else if (rehash) {
+        // if the object has moved then re-hash it and move its
+        // entry to its new location.
+        unsigned int new_pos = JvmtiTagHashmap::hash(obj, size);
+        if (new_pos != (unsigned int)pos) {
+          if (prev == NULL) {
+            table[pos] = next;
+          } else {
+            prev->set_next(next);
+          }
+          if (new_pos < (unsigned int)pos) {
+            entry->set_next(table[new_pos]);
+            table[new_pos] = entry;
+          } else {
+            // Delay adding this entry to it's new position as we'd end up
+            // hitting it again during this iteration.
+            entry->set_next(delayed_add);
+            delayed_add = entry;
+          }
+          moved++;
+        } else {
+          // object didn't move
+          prev = entry;
+        }
+      } else {
+        prev = entry;
+      }
+
+      entry = next;
+    }
+  }
+
+  // Re-add all the entries which were kept aside
+  while (delayed_add != NULL) {
+    JvmtiTagHashmapEntry* next = delayed_add->next();
+    // a concurrent GC may have cleared the reference in the meantime
+    oop obj = delayed_add->object_peek();
+    unsigned int pos = (obj == NULL) ? 0 : JvmtiTagHashmap::hash(obj, size);
+    delayed_add->set_next(table[pos]);
+    table[pos] = delayed_add;
+    delayed_add = next;
+  }
+
+  _needs_rehashing = false;
+  _needs_cleaning = !remove_dead;
+
+  log_debug(jvmti, objecttagging)("(%d->%d, %d freed, %d total moves)",
+                                  hashmap->_entry_count + freed, hashmap->_entry_count, freed, moved);
+}
+
+// post ObjectFree events for the tags collected by check_hashmap()
+void JvmtiTagMap::post_dead_objects(GrowableArray<jlong>* const objects) {
+  assert(Thread::current()->is_Java_thread(), "Must post from JavaThread");
+  assert(!is_locked(), "must not post while holding the tag map lock");
+  if (objects != NULL && objects->length() > 0) {
+    JvmtiExport::post_object_free(env(), objects);
+    log_debug(jvmti, objecttagging)("%d free object posted", objects->length());
+  }
+}
+
+// remove dead entries, rehash if needed and post ObjectFree events for
+// the removed entries; called by Java threads outside of the tag map lock.
+void JvmtiTagMap::remove_dead_entries_and_post() {
+  ResourceMark rm;
+  GrowableArray<jlong> objects;
+  {
+    MutexLocker ml(lock());
+    check_hashmap(&objects);
+  }
+  post_dead_objects(&objects);
+}
+
 
 // Return the tag value for an object, or 0 if the object is
 // not tagged
@@ -728,9 +864,16 @@ class TwoOopCallbackWrapper : public CallbackWrapper {
 // This function is performance critical. If many threads attempt to tag objects
 // around the same time then it's possible that the Mutex associated with the
 // tag map will be a hot lock.
+//
+// ObjectFree events are not posted here, as the agent may hold a lock around
+// SetTag that it also takes in the callback. Dead entries are left to the
+// ServiceThread, see remove_dead_entries_and_post().
 void JvmtiTagMap::set_tag(jobject object, jlong tag) {
   MutexLocker ml(lock());
 
+  // rehash the tag map if a GC happened after it was last checked
+  check_hashmap(NULL);
+
   // resolve the object
   oop o = JNIHandles::resolve_non_null(object);
 
@@ -763,6 +906,9 @@ void JvmtiTagMap::set_tag(jobject object, jlong tag) {
 jlong JvmtiTagMap::get_tag(jobject object) {
   MutexLocker ml(lock());
 
+  // rehash the tag map if a GC happened after it was last checked
+  check_hashmap(NULL);
+
   // resolve the object
   oop o = JNIHandles::resolve_non_null(object);
 
@@ -1261,14 +1407,19 @@ static jint invoke_primitive_field_callback_for_instance_fields(
 class VM_HeapIterateOperation: public VM_Operation {
  private:
   ObjectClosure* _blk;
+  JvmtiTagMap* _tag_map;
  public:
-  VM_HeapIterateOperation(ObjectClosure* blk) { _blk = blk; }
+  VM_HeapIterateOperation(ObjectClosure* blk, JvmtiTagMap* tag_map) :
+    _blk(blk), _tag_map(tag_map) {}
 
   VMOp_Type type() const { return VMOp_HeapIterateOperation; }
   void doit() {
     // allows class files maps to be cached during iteration
     ClassFieldMapCacheMark cm;
 
+    // rehash the tag map if a GC happened after it was last checked
+    _tag_map->check_hashmap(NULL);
+
     // make sure that heap is parsable (fills TLABs with filler objects)
     Universe::heap()->ensure_parsability(false);  // no need to retire TLABs
 
@@ -1489,13 +1640,14 @@ void JvmtiTagMap::iterate_over_heap(jvmtiHeapObjectFilter object_filter,
                                     jvmtiHeapObjectCallback heap_object_callback,
                                     const void* user_data)
 {
+  remove_dead_entries_and_post();
   MutexLocker ml(Heap_lock);
   IterateOverHeapObjectClosure blk(this,
                                    klass,
                                    object_filter,
                                    heap_object_callback,
                                    user_data);
-  VM_HeapIterateOperation op(&blk);
+  VM_HeapIterateOperation op(&blk, this);
   VMThread::execute(&op);
 }
 
@@ -1506,13 +1658,14 @@ void JvmtiTagMap::iterate_through_heap(jint heap_filter,
                                        const jvmtiHeapCallbacks* callbacks,
                                        const void* user_data)
 {
+  remove_dead_entries_and_post();
   MutexLocker ml(Heap_lock);
   IterateThroughHeapObjectClosure blk(this,
                                       klass,
                                       heap_filter,
                                       callbacks,
                                       user_data);
-  VM_HeapIterateOperation op(&blk);
+  VM_HeapIterateOperation op(&blk, this);
   VMThread::execute(&op);
 }
 
@@ -1553,7 +1706,11 @@ class TagObjectCollector : public JvmtiTagHashmapEntryClosure {
         // SATB marking similar to other j.l.ref.Reference referents. This is
         // achieved by using a phantom load in the object() accessor.
         oop o = entry->object();
-        assert(o != NULL && Universe::heap()->is_in_reserved(o), "sanity check");
+        if (o == NULL) {
+          // cleared by a concurrent GC, will be removed on the next check
+          continue;
+        }
+        assert(Universe::heap()->is_in_reserved(o), "sanity check");
         jobject ref = JNIHandles::make_local(JavaThread::current(), o);
         _object_results->append(ref);
         _tag_results->append((uint64_t)entry->tag());
@@ -1608,6 +1765,7 @@ jvmtiError JvmtiTagMap::get_objects_with_tags(const jlong* tags,
   {
     // iterate over all tagged objects
     MutexLocker ml(lock());
+    check_hashmap(NULL);
     entry_iterate(&collector);
   }
   return collector.result(count_ptr, object_result_ptr, tag_result_ptr);
@@ -3237,6 +3395,9 @@ void VM_HeapWalkOperation::doit() {
 
   assert(visit_stack()->is_empty(), "visit stack must be empty");
 
+  // rehash the tag map if a GC happened after it was last checked
+  _tag_map->check_hashmap(NULL);
+
   // the heap walk starts with an initial object or the heap roots
   if (initial_object().is_null()) {
     // If either collect_stack_roots() or collect_simple_roots()
@@ -3278,6 +3439,7 @@ void JvmtiTagMap::iterate_over_reachable_objects(jvmtiHeapRootCallback heap_root
                                                  jvmtiStackReferenceCallback stack_ref_callback,
                                                  jvmtiObjectReferenceCallback object_ref_callback,
                                                  const void* user_data) {
+  remove_dead_entries_and_post();
   MutexLocker ml(Heap_lock);
   BasicHeapWalkContext context(heap_root_callback, stack_ref_callback, object_ref_callback);
   VM_HeapWalkOperation op(this, Handle(), context, user_data);
@@ -3291,6 +3453,7 @@ void JvmtiTagMap::iterate_over_objects_reachable_from_object(jobject object,
   oop obj = JNIHandles::resolve(object);
   Handle initial_object(Thread::current(), obj);
 
+  remove_dead_entries_and_post();
   MutexLocker ml(Heap_lock);
   BasicHeapWalkContext context(NULL, NULL, object_ref_callback);
   VM_HeapWalkOperation op(this, initial_object, context, user_data);
@@ -3307,6 +3470,7 @@ void JvmtiTagMap::follow_references(jint heap_filter,
   oop obj = JNIHandles::resolve(object);
   Handle initial_object(Thread::current(), obj);
 
+  remove_dead_entries_and_post();
   MutexLocker ml(Heap_lock);
   AdvancedHeapWalkContext context(heap_filter, klass, callbacks);
   VM_HeapWalkOperation op(this, initial_object, context, user_data);
@@ -3314,6 +3478,11 @@ void JvmtiTagMap::follow_references(jint heap_filter,
 }
 
 
+// The tagged objects are referenced through the VM weak OopStorage which
+// the GC processes along with its other weak OopStorage phases. All that
+// is left to do here, inside the pause, is to notify the tag maps that
+// their entries may have moved or died. The hashmaps are brought up to
+// date lazily, outside of the pause, before they are next used.
 void JvmtiTagMap::weak_oops_do(BoolObjectClosure* is_alive, OopClosure* f) {
   // No locks during VM bring-up (0 threads) and no safepoints after main
   // thread creation and before VMThread creation (1 thread); initial GC
@@ -3322,108 +3491,49 @@ void JvmtiTagMap::weak_oops_do(BoolObjectClosure* is_alive, OopClosure* f) {
          SafepointSynchronize::is_at_safepoint(),
          "must be executed at a safepoint");
   if (JvmtiEnv::environments_might_exist()) {
+    bool has_object_free_events = false;
     JvmtiEnvIterator it;
     for (JvmtiEnvBase* env = it.first(); env != NULL; env = it.next(env)) {
       JvmtiTagMap* tag_map = env->tag_map_acquire();
       if (tag_map != NULL && !tag_map->is_empty()) {
-        tag_map->do_weak_oops(is_alive, f);
+        tag_map->gc_notification();
+        if (env->is_enabled(JVMTI_EVENT_OBJECT_FREE)) {
+          has_object_free_events = true;
+        }
       }
     }
+    if (has_object_free_events) {
+      // have the ServiceThread post the ObjectFree events for entries
+      // cleared by this GC, without waiting for the next use of the tag map
+      MutexLocker ml(Service_lock, Mutex::_no_safepoint_check_flag);
+      _has_object_free_events = true;
+      Service_lock->notify_all();
+    }
   }
 }
 
-void JvmtiTagMap::do_weak_oops(BoolObjectClosure* is_alive, OopClosure* f) {
-
-  // does this environment have the OBJECT_FREE event enabled
-  bool post_object_free = env()->is_enabled(JVMTI_EVENT_OBJECT_FREE);
-
-  // counters used for trace message
-  int freed = 0;
-  int moved = 0;
-
-  JvmtiTagHashmap* hashmap = this->hashmap();
-
-  // reenable sizing (if disabled)
-  hashmap->set_resizing_enabled(true);
-
-  // if the hashmap is empty then we can skip it
-  if (hashmap->_entry_count == 0) {
-    return;
-  }
-
-  // now iterate through each entry in the table
-
-  JvmtiTagHashmapEntry** table = hashmap->table();
-  int size = hashmap->size();
-
-  JvmtiTagHashmapEntry* delayed_add = NULL;
-
-  for (int pos = 0; pos < size; ++pos) {
-    JvmtiTagHashmapEntry* entry = table[pos];
-    JvmtiTagHashmapEntry* prev = NULL;
-
-    while (entry != NULL) {
-      JvmtiTagHashmapEntry* next = entry->next();
+void JvmtiTagMap::gc_notification() {
+  _needs_rehashing = true;
+  _needs_cleaning = true;
+}
 
-      // has object been GC'ed
-      if (!is_alive->do_object_b(entry->object_raw())) {
-        // grab the tag
-        jlong tag = entry->tag();
-        guarantee(tag != 0, "checking");
-
-        // remove GC'ed entry from hashmap and return the
-        // entry to the free list
-        hashmap->remove(prev, pos, entry);
-        destroy_entry(entry);
-
-        // post the event to the profiler
-        if (post_object_free) {
-          JvmtiExport::post_object_free(env(), tag);
-        }
+volatile bool JvmtiTagMap::_has_object_free_events = false;
 
-        ++freed;
-      } else {
-        f->do_oop(entry->object_addr());
-        oop new_oop = entry->object_raw();
-
-        // if the object has moved then re-hash it and move its
-        // entry to its new location.
-        unsigned int new_pos = JvmtiTagHashmap::hash(new_oop, size);
-        if (new_pos != (unsigned int)pos) {
-          if (prev == NULL) {
-            table[pos] = next;
-          } else {
-            prev->set_next(next);
-          }
-          if (new_pos < (unsigned int)pos) {
-            entry->set_next(table[new_pos]);
-            table[new_pos] = entry;
-          } else {
-            // Delay adding this entry to it's new position as we'd end up
-            // hitting it again during this iteration.
-            entry->set_next(delayed_add);
-            delayed_add = entry;
-          }
-          moved++;
-        } else {
-          // object didn't move
-          prev = entry;
-        }
-      }
+bool JvmtiTagMap::has_object_free_events_and_reset() {
+  assert_lock_strong(Service_lock);
+  bool result = _has_object_free_events;
+  _has_object_free_events = false;
+  return result;
+}
 
-      entry = next;
+// called by the ServiceThread
+void JvmtiTagMap::flush_all_object_free_events() {
+  assert(Thread::current()->is_Java_thread(), "Must post from JavaThread");
+  JvmtiEnvIterator it;
+  for (JvmtiEnvBase* env = it.first(); env != NULL; env = it.next(env)) {
+    JvmtiTagMap* tag_map = env->tag_map_acquire();
+    if (tag_map != NULL && env->is_enabled(JVMTI_EVENT_OBJECT_FREE)) {
+      tag_map->remove_dead_entries_and_post();
     }
   }
-
-  // Re-add all the entries which were kept aside
-  while (delayed_add != NULL) {
-    JvmtiTagHashmapEntry* next = delayed_add->next();
-    unsigned int pos = JvmtiTagHashmap::hash(delayed_add->object_raw(), size);
-    delayed_add->set_next(table[pos]);
-    table[pos] = delayed_add;
-    delayed_add = next;
-  }
-
-  log_debug(jvmti, objecttagging)("(%d->%d, %d freed, %d total moves)",
-                                  hashmap->_entry_count + freed, hashmap->_entry_count, freed, moved);
 }
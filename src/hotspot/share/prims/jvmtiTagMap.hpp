@@ -31,6 +31,7 @@
 #include "jvmtifiles/jvmti.h"
 #include "jvmtifiles/jvmtiEnv.hpp"
 #include "memory/allocation.hpp"
+#include "utilities/growableArray.hpp"
 
 // forward references
 class JvmtiTagHashmap;
@@ -51,6 +52,11 @@ class JvmtiTagMap :  public CHeapObj<mtInternal> {
   JvmtiTagHashmapEntry* _free_entries;              // free list for this environment
   int _free_entries_count;                          // number of entries on the free list
 
+  bool                  _needs_rehashing;           // objects may have moved since the last check
+  bool                  _needs_cleaning;            // objects may have died since the last check
+
+  static volatile bool  _has_object_free_events;    // ObjectFree events pending after a GC
+
   // create a tag map
   JvmtiTagMap(JvmtiEnv* env);
 
@@ -58,7 +64,9 @@ class JvmtiTagMap :  public CHeapObj<mtInternal> {
   inline Mutex* lock()                      { return &_lock; }
   inline JvmtiEnv* env() const              { return _env; }
 
-  void do_weak_oops(BoolObjectClosure* is_alive, OopClosure* f);
+  void gc_notification();
+  void post_dead_objects(GrowableArray<jlong>* const objects);
+  void remove_dead_entries_and_post();
 
   // iterate over all entries in this tag map
   void entry_iterate(JvmtiTagHashmapEntryClosure* closure);
@@ -77,6 +85,9 @@ class JvmtiTagMap :  public CHeapObj<mtInternal> {
   // returns true if the hashmaps are empty
   bool is_empty();
 
+  // remove dead entries and rehash after a GC
+  void check_hashmap(GrowableArray<jlong>* objects);
+
   // return tag for the given environment
   static JvmtiTagMap* tag_map_for(JvmtiEnv* env);
 
@@ -122,6 +133,10 @@ class JvmtiTagMap :  public CHeapObj<mtInternal> {
 
   static void weak_oops_do(
       BoolObjectClosure* is_alive, OopClosure* f) NOT_JVMTI_RETURN;
+
+  // ObjectFree events for entries cleared by the GC, posted by the ServiceThread
+  static bool has_object_free_events_and_reset() NOT_JVMTI_RETURN_(false);
+  static void flush_all_object_free_events() NOT_JVMTI_RETURN;
 };
 
 #endif // SHARE_PRIMS_JVMTITAGMAP_HPP
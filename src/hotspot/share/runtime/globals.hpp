@@ -558,12 +558,28 @@ const size_t minimumSymbolTableSize = 1024;
           "directory) of the dump file (defaults to java_pid<pid>.hprof "   \
           "in the working directory)")                                      \
                                                                             \
+  product(bool, AllocationSiteProfiling, false,                             \
+          "Sample allocations and track the live bytes allocated at each "  \
+          "allocation site, see the GC.heap_profile diagnostic command")    \
+                                                                            \
+  product(intx, AllocationSiteProfilingInterval, 512*K,                     \
+          "Average number of bytes allocated between two samples taken "    \
+          "by AllocationSiteProfiling")                                     \
+          range(0, max_jint)                                                \
+                                                                            \
   develop(bool, BreakAtWarning, false,                                      \
           "Execute breakpoint upon encountering VM warning")                \
                                                                             \
   product(ccstr, NativeMemoryTracking, "off",                               \
           "Native memory tracking options")                                 \
                                                                             \
+  product(size_t, NMTDetailSampleInterval, 0,                               \
+          "With detail tracking, record the call sites of mallocs smaller " \
+          "than this many bytes only about once per this many bytes "       \
+          "allocated, and scale them up in reports (0 records every call "  \
+          "site)")                                                          \
+          range(0, max_uintx)                                               \
+                                                                            \
   diagnostic(bool, PrintNMTStatistics, false,                               \
           "Print native memory tracking summary data if it is on")          \
                                                                             \
@@ -576,6 +592,11 @@ const size_t minimumSymbolTableSize = 1024;
   product(bool, PrintExtendedThreadInfo, false,                             \
           "Print more information in thread dump")                          \
                                                                             \
+  product(bool, HandshakeThreadDump, false,                                 \
+          "Print thread dumps by handshaking one Java thread at a time "    \
+          "instead of stopping all threads at a safepoint. The threads "    \
+          "are not captured at the same point in time")                     \
+                                                                            \
   diagnostic(bool, TraceNMethodInstalls, false,                             \
           "Trace nmethod installation")                                     \
                                                                             \
@@ -2217,6 +2238,29 @@ const size_t minimumSymbolTableSize = 1024;
           "up to a multiple of the native os page size.")                   \
           range(128, 32*64*K)                                               \
                                                                             \
+  product(bool, PerfDataThreadRecords, false,                               \
+          "Publish per-thread CPU time and allocated bytes records in "     \
+          "the PerfData memory region")                                     \
+                                                                            \
+  product(intx, PerfDataMaxThreadRecords, 4096,                             \
+          "Maximum number of threads with a record when "                   \
+          "PerfDataThreadRecords is enabled")                               \
+          range(1, 64*K)                                                    \
+                                                                            \
+  product(intx, PerfDataThreadRecordsInterval, 1000,                        \
+          "Interval (in milliseconds) between updates of the "              \
+          "PerfDataThreadRecords")                                          \
+          range(PeriodicTask::min_interval, max_jint)                       \
+                                                                            \
+  product(bool, UseHardwareCounters, false,                                 \
+          "Count hardware events such as cycles and cache misses per "      \
+          "thread and compilation, and per GC phase with G1 "               \
+          "(Linux only)")                                                   \
+                                                                            \
+  diagnostic(bool, UseHardwareCountersRdpmc, true,                          \
+          "Read the hardware counters of the current thread with rdpmc "    \
+          "where the kernel allows it")                                     \
+                                                                            \
   product(intx, PerfMaxStringConstLength, 1024,                             \
           "Maximum PerfStringConstant string length before truncation")     \
           range(32, 32*K)                                                   \
@@ -2243,6 +2287,11 @@ const size_t minimumSymbolTableSize = 1024;
   product(bool, StartAttachListener, false,                                 \
           "Always start Attach Listener at VM startup")                     \
                                                                             \
+  product(uint, AttachListenerWorkerThreads, 2,                             \
+          "Number of threads executing attach operations concurrently. "    \
+          "Zero executes them on the Attach Listener thread")               \
+          range(0, 16)                                                      \
+                                                                            \
   product(bool, EnableDynamicAgentLoading, true,                            \
           "Allow tools to load agents with the attach mechanism")           \
                                                                             \
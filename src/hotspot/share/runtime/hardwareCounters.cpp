@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/globals_extension.hpp"
+#include "runtime/hardwareCounters.hpp"
+#include "runtime/thread.inline.hpp"
+#include "utilities/ostream.hpp"
+
+#if defined(LINUX)
+#include "hardwareCounters_linux.hpp"
+#else
+// Counting is only implemented with perf_event_open on Linux.
+class HardwareCounterSet : public CHeapObj<mtInternal> {
+ public:
+  static bool is_supported()                                { return false; }
+  void open()                                               {}
+  bool read(HardwareCounterValues* values, bool is_current) { return false; }
+};
+#endif
+
+bool HardwareCounters::_enabled = false;
+
+void HardwareCounters::initialize() {
+  if (!UseHardwareCounters) {
+    return;
+  }
+  if (!HardwareCounterSet::is_supported()) {
+    warning("Hardware performance counters are not available on this system");
+    FLAG_SET_DEFAULT(UseHardwareCounters, false);
+    return;
+  }
+  _enabled = true;
+  log_info(os)("Hardware performance counters enabled");
+}
+
+const char* HardwareCounters::name(Counter counter) {
+  switch (counter) {
+    case cycles:       return "Cycles";
+    case instructions: return "Instructions";
+    case llc_misses:   return "LLC Misses";
+    case dtlb_misses:  return "dTLB Misses";
+    default:           ShouldNotReachHere(); return NULL;
+  }
+}
+
+void HardwareCounters::start(Thread* current) {
+  assert(current == Thread::current(), "must be the current thread");
+  if (!_enabled || current->hardware_counters() != NULL) {
+    return;
+  }
+  // The set is kept even if no counter could be opened, so that the
+  // thread does not retry on every read.
+  HardwareCounterSet* set = new HardwareCounterSet();
+  set->open();
+  current->set_hardware_counters(set);
+}
+
+void HardwareCounters::stop(Thread* thread) {
+  HardwareCounterSet* set = thread->hardware_counters();
+  if (set != NULL) {
+    thread->set_hardware_counters(NULL);
+    delete set;
+  }
+}
+
+bool HardwareCounters::read(Thread* thread, HardwareCounterValues* values) {
+  if (!_enabled) {
+    return false;
+  }
+  bool is_current = thread == Thread::current_or_null();
+  HardwareCounterSet* set = thread->hardware_counters();
+  if (set == NULL) {
+    if (!is_current) {
+      return false;
+    }
+    start(thread);
+    set = thread->hardware_counters();
+  }
+  return set->read(values, is_current);
+}
+
+void HardwareCounterValues::clear() {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    _values[i] = 0;
+  }
+}
+
+bool HardwareCounterValues::is_zero() const {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    if (_values[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HardwareCounterValues::set_delta(const HardwareCounterValues& start, const HardwareCounterValues& end) {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    // Scaled counts of multiplexed counters are estimates and may go backwards.
+    _values[i] = end._values[i] > start._values[i] ? end._values[i] - start._values[i] : 0;
+  }
+}
+
+void HardwareCounterValues::add(const HardwareCounterValues& other) {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    _values[i] += other._values[i];
+  }
+}
+
+void HardwareCounterValues::print_on(outputStream* st) const {
+  for (int i = 0; i < HardwareCounters::num_counters; i++) {
+    st->print("%s%s: " UINT64_FORMAT, i == 0 ? "" : ", ",
+              HardwareCounters::name((HardwareCounters::Counter)i), _values[i]);
+  }
+  if (cycles() != 0) {
+    st->print(", IPC: %.2f", (double)instructions() / (double)cycles());
+  }
+}
+
+HardwareCounterSpan::HardwareCounterSpan(Thread* current) :
+  _thread(current), _start(), _started(false) {
+  if (HardwareCounters::is_enabled()) {
+    _started = HardwareCounters::read(_thread, &_start);
+  }
+}
+
+bool HardwareCounterSpan::stop(HardwareCounterValues* delta) {
+  HardwareCounterValues end;
+  if (!_started || !HardwareCounters::read(_thread, &end)) {
+    return false;
+  }
+  delta->set_delta(_start, end);
+  return true;
+}
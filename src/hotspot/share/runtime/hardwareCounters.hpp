@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_RUNTIME_HARDWARECOUNTERS_HPP
+#define SHARE_RUNTIME_HARDWARECOUNTERS_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class HardwareCounterSet;
+class HardwareCounterValues;
+class outputStream;
+class Thread;
+
+// Hardware performance counters of single threads, such as cycles and
+// cache misses. Only events in user mode are counted, so that the counters
+// can be used without special privileges.
+//
+// The counters of a thread are opened by the thread itself, either when it
+// starts or lazily on its first read, and are closed when the Thread is
+// deleted. Counting is only implemented on Linux, with perf_event_open.
+// Where the kernel allows it, the current thread reads its counters with
+// rdpmc instead of a system call.
+class HardwareCounters : AllStatic {
+ public:
+  enum Counter {
+    cycles,
+    instructions,
+    llc_misses,
+    dtlb_misses,
+    num_counters
+  };
+
+ private:
+  static bool _enabled;
+
+ public:
+  static void initialize();
+  static bool is_enabled() { return _enabled; }
+
+  static const char* name(Counter counter);
+
+  // Starts counting for the current thread.
+  static void start(Thread* current);
+  // Releases the counters of a thread that is being deleted.
+  static void stop(Thread* thread);
+
+  // Reads the counters of a thread. Reading another thread is only safe
+  // while that thread is protected from deletion, e.g. by a ThreadsListHandle.
+  static bool read(Thread* thread, HardwareCounterValues* values);
+};
+
+class HardwareCounterValues {
+ private:
+  u8 _values[HardwareCounters::num_counters];
+
+ public:
+  HardwareCounterValues() { clear(); }
+
+  void clear();
+  bool is_zero() const;
+
+  u8 get(HardwareCounters::Counter counter) const { return _values[counter]; }
+  void set(HardwareCounters::Counter counter, u8 value) { _values[counter] = value; }
+
+  u8 cycles() const       { return get(HardwareCounters::cycles); }
+  u8 instructions() const { return get(HardwareCounters::instructions); }
+  u8 llc_misses() const   { return get(HardwareCounters::llc_misses); }
+  u8 dtlb_misses() const  { return get(HardwareCounters::dtlb_misses); }
+
+  // Sets this to the counts since start.
+  void set_delta(const HardwareCounterValues& start, const HardwareCounterValues& end);
+  void add(const HardwareCounterValues& other);
+
+  void print_on(outputStream* st) const;
+};
+
+// Counts the hardware events of the current thread from construction to
+// a call of stop().
+class HardwareCounterSpan : public StackObj {
+ private:
+  Thread*               _thread;
+  HardwareCounterValues _start;
+  bool                  _started;
+
+ public:
+  HardwareCounterSpan(Thread* current);
+
+  // Returns false if nothing was counted.
+  bool stop(HardwareCounterValues* delta);
+};
+
+#endif // SHARE_RUNTIME_HARDWARECOUNTERS_HPP
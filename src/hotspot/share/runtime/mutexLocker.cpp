@@ -154,6 +154,9 @@ Mutex*   DCmdFactory_lock             = NULL;
 #if INCLUDE_NMT
 Mutex*   NMTQuery_lock                = NULL;
 #endif
+#if INCLUDE_SERVICES
+Monitor* AttachListener_lock          = NULL;
+#endif
 #if INCLUDE_CDS
 #if INCLUDE_JVMTI
 Mutex*   CDSClassFileStream_lock      = NULL;
@@ -356,6 +359,9 @@ void mutex_init() {
 #if INCLUDE_NMT
   def(NMTQuery_lock                , PaddedMutex  , max_nonleaf, false, Monitor::_safepoint_check_always);
 #endif
+#if INCLUDE_SERVICES
+  def(AttachListener_lock          , PaddedMonitor, leaf,        true,  Monitor::_safepoint_check_always); // attach operation queue
+#endif
 #if INCLUDE_CDS
 #if INCLUDE_JVMTI
   def(CDSClassFileStream_lock      , PaddedMutex  , max_nonleaf, false, Monitor::_safepoint_check_always);
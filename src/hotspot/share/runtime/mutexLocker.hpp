@@ -133,6 +133,9 @@ extern Mutex*   DCmdFactory_lock;                // serialize access to DCmdFact
 #if INCLUDE_NMT
 extern Mutex*   NMTQuery_lock;                   // serialize NMT Dcmd queries
 #endif
+#if INCLUDE_SERVICES
+extern Monitor* AttachListener_lock;             // protects the queue of attach operations waiting for a worker
+#endif
 #if INCLUDE_CDS
 #if INCLUDE_JVMTI
 extern Mutex*   CDSClassFileStream_lock;         // FileMapInfo::open_stream_for_jvmti
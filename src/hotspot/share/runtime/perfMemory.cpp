@@ -36,6 +36,7 @@
 #include "runtime/perfMemory.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/statSampler.hpp"
+#include "services/threadPerfRecords.hpp"
 #include "utilities/align.hpp"
 #include "utilities/globalDefinitions.hpp"
 
@@ -50,6 +51,8 @@ static const size_t PERFDATA_FILENAME_LEN = sizeof(PERFDATA_NAME) +
 char*                    PerfMemory::_start = NULL;
 char*                    PerfMemory::_end = NULL;
 char*                    PerfMemory::_top = NULL;
+char*                    PerfMemory::_reserved = NULL;
+size_t                   PerfMemory::_reserved_size = 0;
 size_t                   PerfMemory::_capacity = 0;
 int                      PerfMemory::_initialized = false;
 PerfDataPrologue*        PerfMemory::_prologue = NULL;
@@ -93,7 +96,10 @@ void PerfMemory::initialize() {
     // initialization already performed
     return;
 
-  size_t capacity = align_up(PerfDataMemorySize,
+  // memory at the end of the region that is not part of the entry list
+  size_t reserved_size = align_up(ThreadPerfRecords::memory_size(), sizeof(jlong));
+
+  size_t capacity = align_up((size_t)PerfDataMemorySize + reserved_size,
                              os::vm_allocation_granularity());
 
   log_debug(perf, memops)("PerfDataMemorySize = " SIZE_FORMAT ","
@@ -132,8 +138,12 @@ void PerfMemory::initialize() {
                             _capacity);
 
     _prologue = (PerfDataPrologue *)_start;
-    _end = _start + _capacity;
+    _end = _start + _capacity - reserved_size;
     _top = _start + sizeof(PerfDataPrologue);
+    if (reserved_size > 0) {
+      _reserved = _end;
+      _reserved_size = reserved_size;
+    }
   }
 
   assert(_prologue != NULL, "prologue pointer must be initialized");
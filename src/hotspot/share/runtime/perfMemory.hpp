@@ -118,6 +118,8 @@ class PerfMemory : AllStatic {
     static char*  _start;
     static char*  _end;
     static char*  _top;
+    static char*  _reserved;
+    static size_t _reserved_size;
     static size_t _capacity;
     static PerfDataPrologue*  _prologue;
     static int    _initialized;
@@ -137,6 +139,12 @@ class PerfMemory : AllStatic {
     static char* end() { return _end; }
     static size_t used() { return (size_t) (_top - _start); }
     static size_t capacity() { return _capacity; }
+    // memory reserved at the end of the region, following the PerfData
+    // entries but not part of the entry list. Its layout is defined by
+    // its producer, external readers locate it using PerfData constants.
+    // NULL if not reserved or if the region is not shared.
+    static char* reserved() { return _reserved; }
+    static size_t reserved_size() { return _reserved_size; }
     static bool is_initialized();
     static bool is_destroyed() { return _destroyed; }
     static bool is_usable() { return is_initialized() && !is_destroyed(); }
@@ -35,6 +35,7 @@
 #include "runtime/perfData.inline.hpp"
 #include "runtime/statSampler.hpp"
 #include "runtime/vm_version.hpp"
+#include "services/threadPerfRecords.hpp"
 
 // --------------------------------------------------------
 // StatSamplerTask
@@ -170,6 +171,8 @@ void StatSampler::collect_sample() {
   assert(_sampled != NULL, "list not initialized");
 
   sample_data(_sampled);
+
+  ThreadPerfRecords::sample();
 }
 
 /*
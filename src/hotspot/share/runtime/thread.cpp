@@ -72,6 +72,7 @@
 #include "runtime/frame.inline.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/handshake.hpp"
+#include "runtime/hardwareCounters.hpp"
 #include "runtime/init.hpp"
 #include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/java.hpp"
@@ -256,6 +257,7 @@ Thread::Thread() {
   NOT_PRODUCT(_skip_gcalot = false;)
   _jvmti_env_iteration_count = 0;
   set_allocated_bytes(0);
+  _hardware_counters = NULL;
   _vm_operation_started_count = 0;
   _vm_operation_completed_count = 0;
   _current_pending_monitor = NULL;
@@ -465,6 +467,8 @@ Thread::~Thread() {
   delete handle_area();
   delete metadata_handles();
 
+  HardwareCounters::stop(this);
+
   // SR_handler uses this as a termination indicator -
   // needs to happen before os::free_thread()
   delete _SR_lock;
@@ -1975,6 +1979,9 @@ void JavaThread::run() {
 
   }
 
+  // Count hardware events over the whole lifetime of the thread
+  HardwareCounters::start(this);
+
   // We call another function to do the rest so we are sure that the stack addresses used
   // from there will be lower than the stack base just computed.
   thread_main_inner();
@@ -3194,9 +3201,11 @@ const char* JavaThread::get_thread_name() const {
   // early safepoints can hit while current thread does not yet have TLS
   if (!SafepointSynchronize::is_at_safepoint()) {
     Thread *cur = Thread::current();
-    if (!(cur->is_Java_thread() && cur == this)) {
+    if (!(cur->is_Java_thread() && cur == this) &&
+        !(cur->is_VM_thread() && has_handshake())) {
       // Current JavaThreads are allowed to get their own name without
-      // the Threads_lock.
+      // the Threads_lock, as is the VM thread while it processes a
+      // handshake on this thread's behalf.
       assert_locked_or_safepoint(Threads_lock);
     }
   }
@@ -3871,6 +3880,9 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
   // Initialize output stream logging
   ostream_init_log();
 
+  // Must be before the first thread counts its hardware events
+  HardwareCounters::initialize();
+
   // Convert -Xrun to -agentlib: if there is no JVM_OnLoad
   // Must be before create_vm_init_agents()
   if (Arguments::init_libraries_at_startup()) {
@@ -3919,6 +3931,8 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
   // crash Linux VM, see notes in os_linux.cpp.
   main_thread->create_stack_guard_pages();
 
+  HardwareCounters::start(main_thread);
+
   // Initialize Java-Level synchronization subsystem
   ObjectMonitor::Initialize();
 
@@ -4766,9 +4780,7 @@ JavaThread *Threads::owning_thread_from_monitor_owner(ThreadsList * t_list,
 }
 
 // Threads::print_on() is called at safepoint by VM_PrintThreads operation.
-void Threads::print_on(outputStream* st, bool print_stacks,
-                       bool internal_format, bool print_concurrent_locks,
-                       bool print_extended_info) {
+void Threads::print_header_on(outputStream* st) {
   char buf[32];
   st->print_raw_cr(os::local_time_string(buf, sizeof(buf)));
 
@@ -4777,6 +4789,23 @@ void Threads::print_on(outputStream* st, bool print_stacks,
                VM_Version::vm_release(),
                VM_Version::vm_info_string());
   st->cr();
+}
+
+void Threads::print_non_java_threads_on(outputStream* st) {
+  VMThread::vm_thread()->print_on(st);
+  st->cr();
+  Universe::heap()->print_gc_threads_on(st);
+  WatcherThread* wt = WatcherThread::watcher_thread();
+  if (wt != NULL) {
+    wt->print_on(st);
+    st->cr();
+  }
+}
+
+void Threads::print_on(outputStream* st, bool print_stacks,
+                       bool internal_format, bool print_concurrent_locks,
+                       bool print_extended_info) {
+  print_header_on(st);
 
 #if INCLUDE_SERVICES
   // Dump concurrent locks
@@ -4807,14 +4836,7 @@ void Threads::print_on(outputStream* st, bool print_stacks,
 #endif // INCLUDE_SERVICES
   }
 
-  VMThread::vm_thread()->print_on(st);
-  st->cr();
-  Universe::heap()->print_gc_threads_on(st);
-  WatcherThread* wt = WatcherThread::watcher_thread();
-  if (wt != NULL) {
-    wt->print_on(st);
-    st->cr();
-  }
+  print_non_java_threads_on(st);
 
   st->flush();
 }
@@ -85,6 +85,7 @@ class DeoptResourceMark;
 class jvmtiDeferredLocalVariableSet;
 
 class GCTaskQueue;
+class HardwareCounterSet;
 class ThreadClosure;
 class ICRefillVerifier;
 class IdealGraphPrinter;
@@ -398,6 +399,7 @@ class Thread: public ThreadShadow {
   jlong _allocated_bytes;                       // Cumulative number of bytes allocated on
                                                 // the Java heap
   ThreadHeapSampler _heap_sampler;              // For use when sampling the memory.
+  HardwareCounterSet* volatile _hardware_counters; // Hardware performance counters, if enabled
 
   ThreadStatisticalInfo _statistical_info;      // Statistics about the thread
 
@@ -611,6 +613,9 @@ class Thread: public ThreadShadow {
 
   ThreadHeapSampler& heap_sampler()     { return _heap_sampler; }
 
+  inline HardwareCounterSet* hardware_counters() const;
+  inline void set_hardware_counters(HardwareCounterSet* set);
+
   ThreadStatisticalInfo& statistical_info() { return _statistical_info; }
 
   JFR_ONLY(DEFINE_THREAD_LOCAL_ACCESSOR_JFR;)
@@ -2295,6 +2300,8 @@ class Threads: AllStatic {
 
   // Verification
   static void verify();
+  static void print_header_on(outputStream* st);
+  static void print_non_java_threads_on(outputStream* st);
   static void print_on(outputStream* st, bool print_stacks, bool internal_format, bool print_concurrent_locks, bool print_extended_info);
   static void print(bool print_stacks, bool internal_format) {
     // this function is only used by debug.cpp
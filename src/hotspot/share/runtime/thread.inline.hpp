@@ -82,6 +82,14 @@ inline jlong Thread::cooked_allocated_bytes() {
   return allocated_bytes;
 }
 
+inline HardwareCounterSet* Thread::hardware_counters() const {
+  return OrderAccess::load_acquire(&_hardware_counters);
+}
+
+inline void Thread::set_hardware_counters(HardwareCounterSet* set) {
+  OrderAccess::release_store(&_hardware_counters, set);
+}
+
 inline ThreadsList* Thread::cmpxchg_threads_hazard_ptr(ThreadsList* exchange_value, ThreadsList* compare_value) {
   return (ThreadsList*)Atomic::cmpxchg(exchange_value, &_threads_hazard_ptr, compare_value);
 }
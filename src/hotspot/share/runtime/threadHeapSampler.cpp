@@ -24,10 +24,12 @@
  */
 
 #include "precompiled.hpp"
+#include "prims/jvmtiExport.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/threadHeapSampler.hpp"
+#include "services/allocationSiteProfiler.hpp"
 
 // Cheap random number generator.
 uint64_t ThreadHeapSampler::_rnd;
@@ -133,11 +135,18 @@ void ThreadHeapSampler::check_for_sampling(oop obj, size_t allocation_size, size
   }
 
   JvmtiExport::sampled_object_alloc_event_collector(obj);
+  if (AllocationSiteProfiler::is_enabled()) {
+    AllocationSiteProfiler::record_sample(obj, allocation_size);
+  }
 
   size_t overflow_bytes = total_allocated_bytes - _bytes_until_sample;
   pick_next_sample(overflow_bytes);
 }
 
+bool ThreadHeapSampler::is_enabled() {
+  return JvmtiExport::should_post_sampled_object_alloc() || AllocationSiteProfiler::is_enabled();
+}
+
 int ThreadHeapSampler::get_sampling_interval() {
   return OrderAccess::load_acquire(&_sampling_interval);
 }
@@ -62,6 +62,9 @@ class ThreadHeapSampler {
 
   void check_for_sampling(oop obj, size_t size_in_bytes, size_t bytes_allocated_before);
 
+  // True if allocations are sampled for JVMTI or the AllocationSiteProfiler.
+  static bool is_enabled();
+
   static void set_sampling_interval(int sampling_interval);
   static int get_sampling_interval();
 };
@@ -128,6 +128,7 @@
   template(ICBufferFull)                          \
   template(ScavengeMonitors)                      \
   template(PrintMetadata)                         \
+  template(PrintGCWorkerTimeline)                 \
   template(GTestExecuteAtSafepoint)               \
   template(JFROldObject)                          \
 
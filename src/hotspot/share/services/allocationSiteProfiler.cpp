@@ -0,0 +1,568 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/method.hpp"
+#include "oops/symbol.hpp"
+#include "oops/weakHandle.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "runtime/mutex.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/threadHeapSampler.hpp"
+#include "runtime/vframe.inline.hpp"
+#include "services/allocationSiteProfiler.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/resourceHash.hpp"
+
+static const int MaxFrames = 64;
+static const unsigned int SiteTableSize = 4096;
+static const int MinPurgeThreshold = 1024;
+
+// One frame of an allocation site. The method is only compared against
+// frames being interned, never dereferenced, so the site stays usable
+// after the class of the method has been unloaded.
+class AllocationSiteFrame {
+ public:
+  const Method* _method;
+  int           _bci;
+  int           _line;
+  Symbol*       _klass_name;
+  Symbol*       _name;
+  Symbol*       _signature;
+  Symbol*       _source_file;
+
+  bool matches(const Method* method, int bci) const {
+    return _method == method && _bci == bci &&
+           _name == method->name() && _klass_name == method->klass_name();
+  }
+};
+
+class AllocationSite : public CHeapObj<mtInternal> {
+ private:
+  AllocationSite*      _next;
+  unsigned int         _hash;
+  int                  _num_frames;
+  int                  _num_samples;
+  AllocationSiteFrame* _frames;
+
+  // Estimated live objects and bytes, only valid while writing a profile.
+  double               _objects;
+  double               _bytes;
+
+ public:
+  AllocationSite(unsigned int hash, int num_frames, const Method** methods, const int* bcis);
+  ~AllocationSite();
+
+  AllocationSite* next() const                  { return _next; }
+  void set_next(AllocationSite* next)           { _next = next; }
+  AllocationSite** next_addr()                  { return &_next; }
+  unsigned int hash() const                     { return _hash; }
+  int num_frames() const                        { return _num_frames; }
+  const AllocationSiteFrame& frame_at(int i) const { return _frames[i]; }
+
+  int num_samples() const                       { return _num_samples; }
+  void add_sample()                             { _num_samples++; }
+  int remove_sample()                           { return --_num_samples; }
+
+  double objects() const                        { return _objects; }
+  double bytes() const                          { return _bytes; }
+  void reset_estimate()                         { _objects = 0; _bytes = 0; }
+  void add_to_estimate(double objects, double bytes) {
+    _objects += objects;
+    _bytes += bytes;
+  }
+
+  bool matches(unsigned int hash, int num_frames, const Method** methods, const int* bcis) const;
+};
+
+AllocationSite::AllocationSite(unsigned int hash, int num_frames, const Method** methods, const int* bcis) :
+  _next(NULL), _hash(hash), _num_frames(num_frames), _num_samples(0),
+  _frames(NEW_C_HEAP_ARRAY(AllocationSiteFrame, MAX2(num_frames, 1), mtInternal)),
+  _objects(0), _bytes(0) {
+  for (int i = 0; i < num_frames; i++) {
+    const Method* m = methods[i];
+    AllocationSiteFrame& f = _frames[i];
+    f._method = m;
+    f._bci = bcis[i];
+    f._line = m->line_number_from_bci(bcis[i]);
+    f._klass_name = m->klass_name();
+    f._name = m->name();
+    f._signature = m->signature();
+    f._source_file = m->method_holder()->source_file_name();
+    f._klass_name->increment_refcount();
+    f._name->increment_refcount();
+    f._signature->increment_refcount();
+    if (f._source_file != NULL) {
+      f._source_file->increment_refcount();
+    }
+  }
+}
+
+AllocationSite::~AllocationSite() {
+  for (int i = 0; i < _num_frames; i++) {
+    AllocationSiteFrame& f = _frames[i];
+    f._klass_name->decrement_refcount();
+    f._name->decrement_refcount();
+    f._signature->decrement_refcount();
+    if (f._source_file != NULL) {
+      f._source_file->decrement_refcount();
+    }
+  }
+  FREE_C_HEAP_ARRAY(AllocationSiteFrame, _frames);
+}
+
+bool AllocationSite::matches(unsigned int hash, int num_frames, const Method** methods, const int* bcis) const {
+  if (_hash != hash || _num_frames != num_frames) {
+    return false;
+  }
+  for (int i = 0; i < num_frames; i++) {
+    if (!_frames[i].matches(methods[i], bcis[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class AllocationSample {
+ public:
+  WeakHandle<vm_allocation_sample_data> _obj;
+  AllocationSite*                       _site;
+  size_t                                _size;
+  size_t                                _interval;
+
+  AllocationSample() : _obj(), _site(NULL), _size(0), _interval(0) {}
+
+  // Number of allocations of this size the sample stands for. An
+  // allocation of size bytes is sampled with probability
+  // 1 - exp(-size / interval), so its inverse is an unbiased weight.
+  double weight() const {
+    if (_interval == 0) {
+      return 1.0;
+    }
+    return 1.0 / (1.0 - exp(-(double)_size / (double)_interval));
+  }
+};
+
+// The site table and the sample list are protected by _lock, which is
+// never taken with a safepoint check so that samples can be recorded
+// while the sampled oop is still unhandled.
+static Mutex* _lock = NULL;
+static AllocationSite** _sites = NULL;
+static GrowableArray<AllocationSample>* _samples = NULL;
+static int _purge_threshold = MinPurgeThreshold;
+
+void AllocationSiteProfiler::initialize() {
+  if (!is_enabled()) {
+    return;
+  }
+  _lock = new Mutex(Mutex::leaf, "AllocationSiteProfiler_lock", true,
+                    Monitor::_safepoint_check_never);
+  _sites = NEW_C_HEAP_ARRAY(AllocationSite*, SiteTableSize, mtInternal);
+  memset(_sites, 0, SiteTableSize * sizeof(AllocationSite*));
+  _samples = new (ResourceObj::C_HEAP, mtInternal) GrowableArray<AllocationSample>(MinPurgeThreshold, true, mtInternal);
+  ThreadHeapSampler::set_sampling_interval((int)AllocationSiteProfilingInterval);
+}
+
+static AllocationSite* lookup_or_add_site(unsigned int hash, int num_frames, const Method** methods, const int* bcis) {
+  assert(_lock->owned_by_self(), "invariant");
+  AllocationSite** bucket = &_sites[hash % SiteTableSize];
+  for (AllocationSite* site = *bucket; site != NULL; site = site->next()) {
+    if (site->matches(hash, num_frames, methods, bcis)) {
+      return site;
+    }
+  }
+  AllocationSite* site = new AllocationSite(hash, num_frames, methods, bcis);
+  site->set_next(*bucket);
+  *bucket = site;
+  return site;
+}
+
+static void remove_sample_from_site(AllocationSite* site) {
+  assert(_lock->owned_by_self(), "invariant");
+  if (site->remove_sample() > 0) {
+    return;
+  }
+  AllocationSite** link = &_sites[site->hash() % SiteTableSize];
+  while (*link != site) {
+    link = (*link)->next_addr();
+  }
+  *link = site->next();
+  delete site;
+}
+
+// Drops the samples whose objects have been cleared by GC, together with
+// the sites that no longer have any live samples.
+static void purge_dead_samples() {
+  assert(_lock->owned_by_self(), "invariant");
+  int live = 0;
+  for (int i = 0; i < _samples->length(); i++) {
+    AllocationSample* sample = _samples->adr_at(i);
+    if (sample->_obj.peek() == NULL) {
+      sample->_obj.release();
+      remove_sample_from_site(sample->_site);
+    } else {
+      _samples->at_put(live++, *sample);
+    }
+  }
+  _samples->trunc_to(live);
+  _purge_threshold = MAX2(2 * live, MinPurgeThreshold);
+}
+
+void AllocationSiteProfiler::record_sample(oop obj, size_t size_in_bytes) {
+  Thread* thread = Thread::current();
+  if (!thread->is_Java_thread()) {
+    return;
+  }
+  JavaThread* jt = (JavaThread*)thread;
+
+  const Method* methods[MaxFrames];
+  int bcis[MaxFrames];
+  int num_frames = 0;
+  unsigned int hash = 0;
+  if (jt->has_last_Java_frame()) {
+    for (vframeStream vfst(jt); !vfst.at_end() && num_frames < MaxFrames; vfst.next()) {
+      methods[num_frames] = vfst.method();
+      bcis[num_frames] = vfst.bci();
+      hash = 31 * hash + (unsigned int)((uintptr_t)methods[num_frames] >> LogBytesPerWord);
+      hash = 31 * hash + (unsigned int)bcis[num_frames];
+      num_frames++;
+    }
+  }
+
+  Handle h(jt, obj);
+  MutexLocker ml(_lock, Mutex::_no_safepoint_check_flag);
+  AllocationSample sample;
+  sample._site = lookup_or_add_site(hash, num_frames, methods, bcis);
+  sample._obj = WeakHandle<vm_allocation_sample_data>::create(h);
+  sample._size = size_in_bytes;
+  sample._interval = (size_t)ThreadHeapSampler::get_sampling_interval();
+  sample._site->add_sample();
+  _samples->append(sample);
+  if (_samples->length() >= _purge_threshold) {
+    purge_dead_samples();
+  }
+}
+
+// Writes protocol buffer fields to a stream.
+class ProtoWriter : public StackObj {
+ private:
+  enum { VARINT = 0, LENGTH_DELIMITED = 2 };
+  outputStream* _out;
+
+  void write_byte(u1 b)                   { _out->write((const char*)&b, 1); }
+  void write_tag(int field, int wire_type) { write_varint(((u8)field << 3) | wire_type); }
+
+ public:
+  ProtoWriter(outputStream* out) : _out(out) {}
+
+  void write_varint(u8 value) {
+    while (value >= 0x80) {
+      write_byte((u1)(value | 0x80));
+      value >>= 7;
+    }
+    write_byte((u1)value);
+  }
+
+  void write_int(int field, u8 value) {
+    write_tag(field, VARINT);
+    write_varint(value);
+  }
+
+  void write_bytes(int field, const char* data, size_t len) {
+    write_tag(field, LENGTH_DELIMITED);
+    write_varint(len);
+    _out->write(data, len);
+  }
+
+  void write_string(int field, const char* s) {
+    write_bytes(field, s, strlen(s));
+  }
+
+  void write_message(int field, bufferedStream* message) {
+    write_bytes(field, message->base(), message->size());
+  }
+};
+
+// Keys of the tables shared between the samples of a profile. The hash
+// functions are class members since template arguments need linkage.
+class FunctionKey {
+ public:
+  Symbol* _klass_name;
+  Symbol* _name;
+  Symbol* _signature;
+
+  static unsigned hash(const FunctionKey& key) {
+    return primitive_hash(key._klass_name) ^ primitive_hash(key._name) * 31 ^ primitive_hash(key._signature) * 961;
+  }
+
+  static bool equals(const FunctionKey& a, const FunctionKey& b) {
+    return a._klass_name == b._klass_name && a._name == b._name && a._signature == b._signature;
+  }
+};
+
+class StringKey : AllStatic {
+ public:
+  static unsigned hash(const char* const& s) {
+    unsigned hash = 0;
+    for (const char* p = s; *p != '\0'; p++) {
+      hash = 31 * hash + (unsigned char)*p;
+    }
+    return hash;
+  }
+
+  static bool equals(const char* const& a, const char* const& b) {
+    return strcmp(a, b) == 0;
+  }
+};
+
+// Encodes a profile in the format of pprof's profile.proto. Strings,
+// functions and locations are shared between the samples that use them.
+class PprofWriter : public StackObj {
+ private:
+  // Field numbers from profile.proto
+  enum {
+    profile_sample_type   = 1,
+    profile_sample        = 2,
+    profile_location      = 4,
+    profile_function      = 5,
+    profile_string_table  = 6,
+    profile_time_nanos    = 9,
+    profile_period_type   = 11,
+    profile_period        = 12,
+    value_type_type       = 1,
+    value_type_unit       = 2,
+    sample_location_id    = 1,
+    sample_value          = 2,
+    location_id           = 1,
+    location_line         = 4,
+    line_function_id      = 1,
+    line_line             = 2,
+    function_id           = 1,
+    function_name         = 2,
+    function_system_name  = 3,
+    function_filename     = 4
+  };
+
+  ProtoWriter _out;
+  GrowableArray<const char*> _strings;
+  ResourceHashtable<const char*, int, StringKey::hash, StringKey::equals> _string_ids;
+  ResourceHashtable<FunctionKey, u8, FunctionKey::hash, FunctionKey::equals> _function_ids;
+  ResourceHashtable<u8, u8> _location_ids;
+  u8 _num_functions;
+  u8 _num_locations;
+
+  int string_id(const char* s) {
+    int* id = _string_ids.get(s);
+    if (id != NULL) {
+      return *id;
+    }
+    int new_id = _strings.length();
+    _strings.append(s);
+    _string_ids.put(s, new_id);
+    return new_id;
+  }
+
+  void write_value_type(int field, const char* type, const char* unit) {
+    bufferedStream msg;
+    ProtoWriter w(&msg);
+    w.write_int(value_type_type, string_id(type));
+    w.write_int(value_type_unit, string_id(unit));
+    _out.write_message(field, &msg);
+  }
+
+  u8 function_id_for(const AllocationSiteFrame& f) {
+    FunctionKey key;
+    key._klass_name = f._klass_name;
+    key._name = f._name;
+    key._signature = f._signature;
+    u8* id = _function_ids.get(key);
+    if (id != NULL) {
+      return *id;
+    }
+    u8 new_id = ++_num_functions;
+    _function_ids.put(key, new_id);
+
+    stringStream name;
+    name.print("%s.%s", f._klass_name->as_klass_external_name(), f._name->as_C_string());
+    stringStream system_name;
+    system_name.print("%s%s", name.as_string(), f._signature->as_C_string());
+
+    bufferedStream msg;
+    ProtoWriter w(&msg);
+    w.write_int(function_id, new_id);
+    w.write_int(function_name, string_id(name.as_string()));
+    w.write_int(function_system_name, string_id(system_name.as_string()));
+    if (f._source_file != NULL) {
+      w.write_int(function_filename, string_id(f._source_file->as_C_string()));
+    }
+    _out.write_message(profile_function, &msg);
+    return new_id;
+  }
+
+  u8 location_id_for(const AllocationSiteFrame& f) {
+    u8 function = function_id_for(f);
+    u8 key = (function << 32) | (u4)MAX2(f._line, 0);
+    u8* id = _location_ids.get(key);
+    if (id != NULL) {
+      return *id;
+    }
+    u8 new_id = ++_num_locations;
+    _location_ids.put(key, new_id);
+
+    bufferedStream line;
+    ProtoWriter lw(&line);
+    lw.write_int(line_function_id, function);
+    if (f._line > 0) {
+      lw.write_int(line_line, f._line);
+    }
+    bufferedStream msg;
+    ProtoWriter w(&msg);
+    w.write_int(location_id, new_id);
+    w.write_message(location_line, &line);
+    _out.write_message(profile_location, &msg);
+    return new_id;
+  }
+
+ public:
+  PprofWriter(outputStream* out) : _out(out), _strings(64), _num_functions(0), _num_locations(0) {
+    string_id("");
+  }
+
+  void write_header(size_t interval) {
+    write_value_type(profile_sample_type, "inuse_objects", "count");
+    write_value_type(profile_sample_type, "inuse_space", "bytes");
+    write_value_type(profile_period_type, "space", "bytes");
+    _out.write_int(profile_period, interval);
+    _out.write_int(profile_time_nanos, (u8)os::javaTimeMillis() * NANOSECS_PER_MILLISEC);
+  }
+
+  void write_sample(const AllocationSite* site, jlong objects, jlong bytes) {
+    bufferedStream location_ids;
+    ProtoWriter lw(&location_ids);
+    for (int i = 0; i < site->num_frames(); i++) {
+      lw.write_varint(location_id_for(site->frame_at(i)));
+    }
+    bufferedStream values;
+    ProtoWriter vw(&values);
+    vw.write_varint((u8)objects);
+    vw.write_varint((u8)bytes);
+
+    bufferedStream msg;
+    ProtoWriter w(&msg);
+    w.write_message(sample_location_id, &location_ids);
+    w.write_message(sample_value, &values);
+    _out.write_message(profile_sample, &msg);
+  }
+
+  void write_string_table() {
+    for (int i = 0; i < _strings.length(); i++) {
+      _out.write_string(profile_string_table, _strings.at(i));
+    }
+  }
+};
+
+// A site and its estimated live objects and bytes, as of the last purge.
+class SiteEstimate {
+ public:
+  AllocationSite* _site;
+  double          _objects;
+  double          _bytes;
+
+  SiteEstimate() : _site(NULL), _objects(0), _bytes(0) {}
+  SiteEstimate(AllocationSite* site, double objects, double bytes) :
+    _site(site), _objects(objects), _bytes(bytes) {}
+};
+
+bool AllocationSiteProfiler::write_profile(const char* path, outputStream* out) {
+  if (!is_enabled()) {
+    out->print_cr("Allocation site profiling is not enabled, use -XX:+AllocationSiteProfiling");
+    return false;
+  }
+
+  // Only the estimate is computed under the lock, which recording
+  // allocations blocks on. Each site is copied together with its estimate
+  // and pinned by an extra sample reference, so that it is not deleted by a
+  // purge while the profile is encoded.
+  ResourceMark rm;
+  GrowableArray<SiteEstimate> estimates;
+  int num_samples = 0;
+  {
+    MutexLocker ml(_lock, Mutex::_no_safepoint_check_flag);
+    purge_dead_samples();
+
+    for (unsigned int i = 0; i < SiteTableSize; i++) {
+      for (AllocationSite* site = _sites[i]; site != NULL; site = site->next()) {
+        site->reset_estimate();
+      }
+    }
+    for (int i = 0; i < _samples->length(); i++) {
+      const AllocationSample& sample = *_samples->adr_at(i);
+      double weight = sample.weight();
+      sample._site->add_to_estimate(weight, weight * sample._size);
+    }
+    for (unsigned int i = 0; i < SiteTableSize; i++) {
+      for (AllocationSite* site = _sites[i]; site != NULL; site = site->next()) {
+        site->add_sample();
+        estimates.append(SiteEstimate(site, site->objects(), site->bytes()));
+      }
+    }
+    num_samples = _samples->length();
+  }
+
+  bufferedStream profile(64 * K);
+  double live_bytes = 0;
+  PprofWriter writer(&profile);
+  writer.write_header((size_t)ThreadHeapSampler::get_sampling_interval());
+  for (int i = 0; i < estimates.length(); i++) {
+    const SiteEstimate& e = estimates.at(i);
+    writer.write_sample(e._site, (jlong)(e._objects + 0.5), (jlong)(e._bytes + 0.5));
+    live_bytes += e._bytes;
+  }
+  writer.write_string_table();
+  const int num_sites = estimates.length();
+
+  {
+    MutexLocker ml(_lock, Mutex::_no_safepoint_check_flag);
+    for (int i = 0; i < estimates.length(); i++) {
+      remove_sample_from_site(estimates.at(i)._site);
+    }
+  }
+
+  fileStream fs(path, "wb");
+  if (!fs.is_open()) {
+    out->print_cr("Unable to create %s: %s", path, os::strerror(errno));
+    return false;
+  }
+  fs.write(profile.base(), profile.size());
+  out->print_cr("Wrote %d allocation sites from %d live samples, estimated " SIZE_FORMAT " live bytes, to %s",
+                num_sites, num_samples, (size_t)live_bytes, path);
+  return true;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_SERVICES_ALLOCATIONSITEPROFILER_HPP
+#define SHARE_SERVICES_ALLOCATIONSITEPROFILER_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/oopsHierarchy.hpp"
+#include "runtime/globals.hpp"
+
+class outputStream;
+
+// AllocationSiteProfiler keeps the allocations picked by ThreadHeapSampler
+// that are still reachable, grouped by the Java stack that allocated them.
+// Each sample holds its object through a weak handle in the VM weak
+// OopStorage, so GC clears samples of dead objects without any help from
+// the profiler. A sample stands for about one sampling interval worth of
+// allocation, which makes the sampled sizes an estimate of the live bytes
+// allocated at each site that is cheap enough to keep up to date in
+// production.
+//
+// The estimate can be written in the pprof profile format with the
+// GC.heap_profile diagnostic command.
+class AllocationSiteProfiler : AllStatic {
+ public:
+  static bool is_enabled() { return AllocationSiteProfiling; }
+
+  static void initialize();
+
+  // Called by ThreadHeapSampler for every sampled allocation.
+  static void record_sample(oop obj, size_t size_in_bytes);
+
+  // Writes the live samples as an uncompressed pprof profile with the
+  // sample types inuse_objects and inuse_space. Returns false and reports
+  // the reason on out if the profile could not be written.
+  static bool write_profile(const char* path, outputStream* out);
+};
+
+#endif // SHARE_SERVICES_ALLOCATIONSITEPROFILER_HPP
@@ -23,9 +23,11 @@
  */
 
 #include "precompiled.hpp"
+#include "jvm.h"
 #include "classfile/javaClasses.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "gc/shared/gcVMOperations.hpp"
+#include "logging/log.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
 #include "oops/oop.inline.hpp"
@@ -37,13 +39,16 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/java.hpp"
 #include "runtime/javaCalls.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 #include "services/attachListener.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/heapDumper.hpp"
+#include "services/threadService.hpp"
 #include "services/writeableFlags.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/formatBuffer.hpp"
+#include "utilities/growableArray.hpp"
 
 volatile bool AttachListener::_initialized;
 
@@ -182,16 +187,15 @@ static jint thread_dump(AttachOperation* op, outputStream* out) {
   }
 
   // thread stacks
-  VM_PrintThreads op1(out, print_concurrent_locks, print_extended_info);
-  VMThread::execute(&op1);
+  ThreadDumpPrinter printer(out, print_concurrent_locks, print_extended_info);
+  printer.print_threads();
 
   // JNI global handles
   VM_PrintJNI op2(out);
   VMThread::execute(&op2);
 
   // Deadlock detection
-  VM_FindDeadlocks op3(out);
-  VMThread::execute(&op3);
+  printer.print_deadlocks();
 
   return JNI_OK;
 }
@@ -360,9 +364,86 @@ static AttachOperationFunctionInfo funcs[] = {
 
 
 
+// Executes an attach operation: examines the operation name (command),
+// dispatches to the corresponding function and sends the result and
+// any output to the client.
+static void execute_operation(AttachOperation* op) {
+  ResourceMark rm;
+  AttachReplyStream st(op);
+  jint res = JNI_OK;
+
+  // handle special detachall operation
+  if (strcmp(op->name(), AttachOperation::detachall_operation_name()) == 0) {
+    AttachListener::detachall();
+  } else if (!EnableDynamicAgentLoading && strcmp(op->name(), "load") == 0) {
+    st.print("Dynamic agent loading is not enabled. "
+             "Use -XX:+EnableDynamicAgentLoading to launch target VM.");
+    res = JNI_ERR;
+  } else {
+    // find the function to dispatch too
+    AttachOperationFunctionInfo* info = NULL;
+    for (int i=0; funcs[i].name != NULL; i++) {
+      const char* name = funcs[i].name;
+      assert(strlen(name) <= AttachOperation::name_length_max, "operation <= name_length_max");
+      if (strcmp(op->name(), name) == 0) {
+        info = &(funcs[i]);
+        break;
+      }
+    }
+
+    // check for platform dependent attach operation
+    if (info == NULL) {
+      info = AttachListener::pd_find_operation(op->name());
+    }
+
+    if (info != NULL) {
+      // dispatch to the function that implements this operation
+      res = (info->func)(op, &st);
+    } else {
+      st.print("Operation %s not recognized!", op->name());
+      res = JNI_ERR;
+    }
+  }
+
+  // A streaming reply has already reported success, so an error is
+  // reported by a trailer line at the end of the output
+  if (res != JNI_OK && op->is_streaming()) {
+    if (st.position() > 0) {
+      st.cr();
+    }
+    st.print_cr("%s%d", AttachOperation::streaming_error_trailer(), res);
+  }
+
+  // operation complete - send result and output to client
+  op->complete(res, &st);
+}
+
+// Operations waiting for a worker thread, protected by AttachListener_lock.
+// The operations are independent of each other: the diagnostic commands
+// behind most of them are MT-safe, as they can also be executed
+// concurrently through the DiagnosticCommand MBean.
+static GrowableArray<AttachOperation*>* _pending_operations = NULL;
+
+static void attach_worker_thread_entry(JavaThread* thread, TRAPS) {
+  assert(thread == Thread::current(), "Must be");
+
+  for (;;) {
+    AttachOperation* op;
+    {
+      MonitorLocker ml(AttachListener_lock);
+      while (_pending_operations->is_empty()) {
+        ml.wait();
+      }
+      op = _pending_operations->at(0);
+      _pending_operations->remove_at(0);
+    }
+    execute_operation(op);
+  }
+}
+
 // The Attach Listener threads services a queue. It dequeues an operation
-// from the queue, examines the operation name (command), and dispatches
-// to the corresponding function to perform the operation.
+// from the queue and hands it to a worker thread, or executes it itself
+// if there are no workers.
 
 static void attach_listener_thread_entry(JavaThread* thread, TRAPS) {
   os::set_priority(thread, NearMaxPriority);
@@ -374,6 +455,7 @@ static void attach_listener_thread_entry(JavaThread* thread, TRAPS) {
   if (AttachListener::pd_init() != 0) {
     return;
   }
+  AttachListener::start_workers();
   AttachListener::set_initialized();
 
   for (;;) {
@@ -382,46 +464,53 @@ static void attach_listener_thread_entry(JavaThread* thread, TRAPS) {
       return;   // dequeue failed or shutdown
     }
 
-    ResourceMark rm;
-    bufferedStream st;
-    jint res = JNI_OK;
-
-    // handle special detachall operation
-    if (strcmp(op->name(), AttachOperation::detachall_operation_name()) == 0) {
-      AttachListener::detachall();
-    } else if (!EnableDynamicAgentLoading && strcmp(op->name(), "load") == 0) {
-      st.print("Dynamic agent loading is not enabled. "
-               "Use -XX:+EnableDynamicAgentLoading to launch target VM.");
-      res = JNI_ERR;
+    // detachall is executed in order with the operations dequeued
+    if (_pending_operations == NULL ||
+        strcmp(op->name(), AttachOperation::detachall_operation_name()) == 0) {
+      execute_operation(op);
     } else {
-      // find the function to dispatch too
-      AttachOperationFunctionInfo* info = NULL;
-      for (int i=0; funcs[i].name != NULL; i++) {
-        const char* name = funcs[i].name;
-        assert(strlen(name) <= AttachOperation::name_length_max, "operation <= name_length_max");
-        if (strcmp(op->name(), name) == 0) {
-          info = &(funcs[i]);
-          break;
-        }
-      }
+      MonitorLocker ml(AttachListener_lock);
+      _pending_operations->append(op);
+      ml.notify();
+    }
+  }
+}
 
-      // check for platform dependent attach operation
-      if (info == NULL) {
-        info = AttachListener::pd_find_operation(op->name());
-      }
+AttachReplyStream::AttachReplyStream(AttachOperation* op) :
+  bufferedStream(), _op(op), _thread(Thread::current()),
+  _send_watermark(streaming_threshold), _failed(false) {
+}
 
-      if (info != NULL) {
-        // dispatch to the function that implements this operation
-        res = (info->func)(op, &st);
-      } else {
-        st.print("Operation %s not recognized!", op->name());
-        res = JNI_ERR;
-      }
-    }
+// Sends as much of the buffered output as the client accepts
+void AttachReplyStream::send_buffered() {
+  ssize_t n = _op->write_reply(buffer, buffer_pos);
+  if (n < 0) {
+    // The client is gone, keep buffering until complete()
+    _failed = true;
+    return;
+  }
+  memmove(buffer, buffer + n, buffer_pos - n);
+  buffer_pos -= n;
+  // A client that does not keep up lets the buffer grow; wait for it to
+  // double before trying again, so that each byte is moved O(1) times.
+  _send_watermark = MAX2(buffer_pos * 2, (size_t)streaming_threshold / 4);
+}
 
-    // operation complete - send result and output to client
-    op->complete(res, &st);
+void AttachReplyStream::write(const char* c, size_t len) {
+  bufferedStream::write(c, len);
+  if (_failed || size() < _send_watermark ||
+      Thread::current() != _thread || !_op->supports_streaming()) {
+    return;
   }
+
+  if (!_op->is_streaming()) {
+    if (!_op->write_result(JNI_OK)) {
+      _failed = true;
+      return;
+    }
+    _op->set_streaming();
+  }
+  send_buffered();
 }
 
 bool AttachListener::has_init_error(TRAPS) {
@@ -438,14 +527,11 @@ bool AttachListener::has_init_error(TRAPS) {
   }
 }
 
-// Starts the Attach Listener thread
-void AttachListener::init() {
-  EXCEPTION_MARK;
-
-  const char thread_name[] = "Attach Listener";
-  Handle string = java_lang_String::create_from_str(thread_name, THREAD);
+// Starts a thread in the system thread group, returns false on failure
+bool AttachListener::start_thread(const char* name, void (*entry)(JavaThread*, TRAPS), TRAPS) {
+  Handle string = java_lang_String::create_from_str(name, THREAD);
   if (has_init_error(THREAD)) {
-    return;
+    return false;
   }
 
   // Initialize thread_oop to put it into the system threadGroup
@@ -456,7 +542,7 @@ void AttachListener::init() {
                        string,
                        THREAD);
   if (has_init_error(THREAD)) {
-    return;
+    return false;
   }
 
   Klass* group = SystemDictionary::ThreadGroup_klass();
@@ -469,24 +555,62 @@ void AttachListener::init() {
                         thread_oop,
                         THREAD);
   if (has_init_error(THREAD)) {
-    return;
+    return false;
   }
 
+  JavaThread* new_thread;
   { MutexLocker mu(Threads_lock);
-    JavaThread* listener_thread = new JavaThread(&attach_listener_thread_entry);
+    new_thread = new JavaThread(entry);
 
     // Check that thread and osthread were created
-    if (listener_thread == NULL || listener_thread->osthread() == NULL) {
-      vm_exit_during_initialization("java.lang.OutOfMemoryError",
-                                    os::native_thread_creation_failed_msg());
+    if (new_thread != NULL && new_thread->osthread() != NULL) {
+      java_lang_Thread::set_thread(thread_oop(), new_thread);
+      java_lang_Thread::set_daemon(thread_oop());
+
+      new_thread->set_threadObj(thread_oop());
+      Threads::add(new_thread);
+      Thread::start(new_thread);
+      return true;
     }
+  }
 
-    java_lang_Thread::set_thread(thread_oop(), listener_thread);
-    java_lang_Thread::set_daemon(thread_oop());
+  // The threads may be started long after VM initialization, so do not
+  // exit: without workers the Attach Listener executes the operations
+  if (new_thread != NULL) {
+    new_thread->smr_delete();
+  }
+  log_warning(attach)("Failed to start %s: %s", name, os::native_thread_creation_failed_msg());
+  return false;
+}
+
+// Starts the Attach Listener thread
+void AttachListener::init() {
+  EXCEPTION_MARK;
+  start_thread("Attach Listener", &attach_listener_thread_entry, THREAD);
+}
 
-    listener_thread->set_threadObj(thread_oop());
-    Threads::add(listener_thread);
-    Thread::start(listener_thread);
+// Starts the worker threads. Without any, the Attach Listener thread
+// executes the operations itself.
+void AttachListener::start_workers() {
+  EXCEPTION_MARK;
+  if (AttachListenerWorkerThreads == 0) {
+    return;
+  }
+  GrowableArray<AttachOperation*>* pending =
+    new (ResourceObj::C_HEAP, mtInternal) GrowableArray<AttachOperation*>(4, true, mtInternal);
+  _pending_operations = pending;
+  uint started = 0;
+  for (uint i = 0; i < AttachListenerWorkerThreads; i++) {
+    char name[32];
+    jio_snprintf(name, sizeof(name), "Attach Listener Worker#%u", i);
+    if (!start_thread(name, &attach_worker_thread_entry, THREAD)) {
+      break;
+    }
+    started++;
+  }
+  if (started == 0) {
+    _pending_operations = NULL;
+    delete pending;
   }
 }
 
@@ -39,8 +39,14 @@
 // properties names and values to the output stream). When the function
 // complets the result value and any result data is returned to the client
 // tool.
+//
+// Operations are executed by a small pool of worker threads (see
+// AttachListenerWorkerThreads), so that a slow operation does not hold up
+// other clients.
 
 class AttachOperation;
+class JavaThread;
+class Thread;
 
 typedef jint (*AttachOperationFunction)(AttachOperation* op, outputStream* out);
 
@@ -94,10 +100,14 @@ class AttachListener: AllStatic {
 
   // dequeue the next operation
   static AttachOperation* dequeue();
+
+  // starts the threads executing attach operations
+  static void start_workers();
 #endif // !INCLUDE_SERVICES
 
  private:
   static bool has_init_error(TRAPS);
+  static bool start_thread(const char* name, void (*entry)(JavaThread*, TRAPS), TRAPS);
 };
 
 #if INCLUDE_SERVICES
@@ -113,6 +123,10 @@ class AttachOperation: public CHeapObj<mtInternal> {
   // clients detach
   static char* detachall_operation_name() { return (char*)"detachall"; }
 
+  // start of the last line of the output of an operation that failed after
+  // its reply started streaming with JNI_OK, followed by the result code
+  static const char* streaming_error_trailer() { return "Attach operation failed: "; }
+
  private:
   char _name[name_length_max+1];
   char _arg[arg_count_max][arg_length_max+1];
@@ -148,15 +162,64 @@ class AttachOperation: public CHeapObj<mtInternal> {
   }
 
   // create an operation of a given name
-  AttachOperation(const char* name) {
+  AttachOperation(const char* name) : _streaming(false) {
     set_name(name);
     for (int i=0; i<arg_count_max; i++) {
       set_arg(i, NULL);
     }
   }
 
-  // complete operation by sending result code and any result data to the client
+  // complete operation by sending result code and any result data to the client.
+  // If the reply is streaming, the result code and the output written so far
+  // have already been sent and only the remaining output is to be sent.
   virtual void complete(jint result, bufferedStream* result_stream) = 0;
+
+ private:
+  bool _streaming;
+
+ public:
+  bool is_streaming() const                     { return _streaming; }
+  void set_streaming()                          { _streaming = true; }
+
+  // Platforms that can send the reply while the operation is executing
+  // override these, see AttachReplyStream. write_result() sends the result
+  // code ahead of any output and returns false if the client is gone.
+  // write_reply() must not block: it returns the number of bytes the
+  // connection accepted, or -1 if the client is gone.
+  virtual bool supports_streaming() const       { return false; }
+  virtual bool write_result(jint result)        { ShouldNotReachHere(); return false; }
+  virtual ssize_t write_reply(const char* buf, size_t len) { ShouldNotReachHere(); return -1; }
+};
+
+// The output stream an attach operation writes its result data to.
+//
+// The result code has to be sent ahead of the result data, so output is
+// buffered. Once the buffered output exceeds streaming_threshold, the
+// operation is taken to have succeeded: JNI_OK is sent, and from then on
+// the output is sent while the operation executes, as far as the client
+// keeps up. An error raised after that point is reported by a trailer line
+// at the end of the output, see AttachOperation::streaming_error_trailer().
+// Whatever could not be sent yet stays buffered until complete().
+//
+// Output is only sent by the thread executing the operation, and never
+// blocks it. Output written by other threads, e.g. by the VM thread
+// executing a VM operation on behalf of the operation, is sent later.
+class AttachReplyStream : public bufferedStream {
+ private:
+  AttachOperation* _op;
+  Thread*          _thread;
+  size_t           _send_watermark;
+  bool             _failed;
+
+  void send_buffered();
+
+ public:
+  enum {
+    streaming_threshold = 64 * K
+  };
+
+  AttachReplyStream(AttachOperation* op);
+  virtual void write(const char* c, size_t len);
 };
 #endif // INCLUDE_SERVICES
 
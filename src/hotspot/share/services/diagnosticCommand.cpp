@@ -41,11 +41,13 @@
 #include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/os.hpp"
+#include "services/allocationSiteProfiler.hpp"
 #include "services/diagnosticArgument.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/diagnosticFramework.hpp"
 #include "services/heapDumper.hpp"
 #include "services/management.hpp"
+#include "services/threadService.hpp"
 #include "services/writeableFlags.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/events.hpp"
@@ -87,9 +89,11 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RunFinalizationDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapInfoDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<FinalizerInfoDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<GCWorkerTimelineDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
 #if INCLUDE_SERVICES
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapDumpDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassHistogramDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapProfileDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassStatsDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<SystemDictionaryDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassHierarchyDCmd>(full_export, true, false));
@@ -542,6 +546,59 @@ int HeapDumpDCmd::num_arguments() {
   }
 }
 
+HeapProfileDCmd::HeapProfileDCmd(outputStream* output, bool heap) :
+                                 DCmdWithParser(output, heap),
+  _filename("filename", "Name of the profile file", "STRING", true) {
+  _dcmdparser.add_dcmd_argument(&_filename);
+}
+
+void HeapProfileDCmd::execute(DCmdSource source, TRAPS) {
+  AllocationSiteProfiler::write_profile(_filename.value(), output());
+}
+
+int HeapProfileDCmd::num_arguments() {
+  ResourceMark rm;
+  HeapProfileDCmd* dcmd = new HeapProfileDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
+GCWorkerTimelineDCmd::GCWorkerTimelineDCmd(outputStream* output, bool heap) :
+                                           DCmdWithParser(output, heap),
+  _filename("filename", "Name of the trace file", "STRING", true) {
+  _dcmdparser.add_dcmd_argument(&_filename);
+}
+
+void GCWorkerTimelineDCmd::execute(DCmdSource source, TRAPS) {
+  if (!RecordGCWorkerTimeline) {
+    output()->print_cr("GC worker timeline is not recorded, use -XX:+RecordGCWorkerTimeline");
+    return;
+  }
+  fileStream fs(_filename.value());
+  if (!fs.is_open()) {
+    output()->print_cr("Could not open file %s", _filename.value());
+    return;
+  }
+  VM_PrintGCWorkerTimeline op(&fs);
+  VMThread::execute(&op);
+  output()->print_cr("GC worker timeline written to %s", _filename.value());
+}
+
+int GCWorkerTimelineDCmd::num_arguments() {
+  ResourceMark rm;
+  GCWorkerTimelineDCmd* dcmd = new GCWorkerTimelineDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
 ClassHistogramDCmd::ClassHistogramDCmd(outputStream* output, bool heap) :
                                        DCmdWithParser(output, heap),
   _all("-all", "Inspect all objects, including unreachable objects",
@@ -629,16 +686,15 @@ ThreadDumpDCmd::ThreadDumpDCmd(outputStream* output, bool heap) :
 
 void ThreadDumpDCmd::execute(DCmdSource source, TRAPS) {
   // thread stacks
-  VM_PrintThreads op1(output(), _locks.value(), _extended.value());
-  VMThread::execute(&op1);
+  ThreadDumpPrinter printer(output(), _locks.value(), _extended.value());
+  printer.print_threads();
 
   // JNI global handles
   VM_PrintJNI op2(output());
   VMThread::execute(&op2);
 
   // Deadlock detection
-  VM_FindDeadlocks op3(output());
-  VMThread::execute(&op3);
+  printer.print_deadlocks();
 }
 
 int ThreadDumpDCmd::num_arguments() {
@@ -350,8 +350,56 @@ public:
   static int num_arguments();
   virtual void execute(DCmdSource source, TRAPS);
 };
+
+class HeapProfileDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<char*> _filename;
+public:
+  HeapProfileDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "GC.heap_profile";
+  }
+  static const char* description() {
+    return "Write the estimated live bytes by allocation site in pprof format. "
+           "Requires -XX:+AllocationSiteProfiling.";
+  }
+  static const char* impact() {
+    return "Low: Depends on the number of sampled allocation sites.";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
 #endif // INCLUDE_SERVICES
 
+class GCWorkerTimelineDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<char*> _filename;
+public:
+  GCWorkerTimelineDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "GC.worker_timeline";
+  }
+  static const char* description() {
+    return "Write the recent activity of the parallel GC workers in Chrome "
+           "trace format. Requires -XX:+RecordGCWorkerTimeline.";
+  }
+  static const char* impact() {
+    return "Low: Depends on the number of GC workers and GCWorkerTimelineEvents.";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 // See also: inspectheap in attachListener.cpp
 class ClassHistogramDCmd : public DCmdWithParser {
 protected:
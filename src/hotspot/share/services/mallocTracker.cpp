@@ -24,12 +24,20 @@
 #include "precompiled.hpp"
 
 #include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
 #include "services/mallocSiteTable.hpp"
 #include "services/mallocTracker.hpp"
 #include "services/mallocTracker.inline.hpp"
 #include "services/memTracker.hpp"
 
-size_t MallocMemorySummary::_snapshot[CALC_OBJ_SIZE_IN_TYPE(MallocMemorySnapshot, size_t)];
+size_t MallocMemorySummary::_counters[CALC_OBJ_SIZE_IN_TYPE(MallocMemoryCounters, size_t)];
+size_t MallocTracker::_sample_interval = 0;
+#ifndef USE_LIBRARY_BASED_TLS_ONLY
+THREAD_LOCAL_DECL uint64_t MallocTracker::_sample_random = 0;
+#else
+uint64_t MallocTracker::_sample_random = 0;
+#endif
 
 // Total malloc'd memory amount
 size_t MallocMemorySnapshot::total() const {
@@ -60,9 +68,31 @@ void MallocMemorySnapshot::make_adjustment() {
 
 
 void MallocMemorySummary::initialize() {
-  assert(sizeof(_snapshot) >= sizeof(MallocMemorySnapshot), "Sanity Check");
+  assert(sizeof(_counters) >= sizeof(MallocMemoryCounters), "Sanity Check");
   // Uses placement new operator to initialize static area.
-  ::new ((void*)_snapshot)MallocMemorySnapshot();
+  ::new ((void*)_counters)MallocMemoryCounters();
+}
+
+// The number and amount of allocations a sampled allocation stands for.
+// An allocation is sampled with probability 1 / count, so both are unbiased.
+static inline void sample_weight(size_t size, size_t* amount, size_t* count) {
+  *count = MallocTracker::sample_count(size);
+  *amount = *count * size;
+}
+
+bool MallocTracker::take_sample(size_t size) {
+  uint64_t x = _sample_random;
+  bool sampled = x % sample_count(size) == 0;
+  if (x == 0) {
+    // first sample of this thread, seed its generator
+    x = (uint64_t)(uintptr_t)&_sample_random ^ (uint64_t)os::random() ^ UCONST64(0x9e3779b97f4a7c15);
+  }
+  // xorshift64
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  _sample_random = x;
+  return sampled;
 }
 
 void MallocHeader::release() const {
@@ -71,26 +101,47 @@ void MallocHeader::release() const {
 
   MallocMemorySummary::record_free(size(), flags());
   MallocMemorySummary::record_free_malloc_header(sizeof(MallocHeader));
-  if (MemTracker::tracking_level() == NMT_detail) {
-    MallocSiteTable::deallocation_at(size(), _bucket_idx, _pos_idx);
+  if (MemTracker::tracking_level() == NMT_detail && _site_recorded) {
+    size_t amount = size();
+    size_t count = 1;
+    if (_site_sampled) {
+      sample_weight(size(), &amount, &count);
+    }
+    MallocSiteTable::deallocation_at(amount, count, _bucket_idx, _pos_idx);
   }
 }
 
-bool MallocHeader::record_malloc_site(const NativeCallStack& stack, size_t size,
-  size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags) const {
-  bool ret = MallocSiteTable::allocation_at(stack, size, bucket_idx, pos_idx, flags);
+void MallocHeader::record_malloc_site(const NativeCallStack& stack, size_t size, MEMFLAGS flags) {
+  size_t amount = size;
+  size_t count = 1;
+  bool sampled = MallocTracker::is_sampled_size(size);
+  if (sampled) {
+    if (!MallocTracker::take_sample(size)) {
+      // Only accounted in summary
+      return;
+    }
+    sample_weight(size, &amount, &count);
+  }
 
-  // Something went wrong, could be OOM or overflow malloc site table.
-  // We want to keep tracking data under OOM circumstance, so transition to
-  // summary tracking.
-  if (!ret) {
+  size_t bucket_idx;
+  size_t pos_idx;
+  if (MallocSiteTable::allocation_at(stack, amount, count, &bucket_idx, &pos_idx, flags)) {
+    assert(bucket_idx <= MAX_MALLOCSITE_TABLE_SIZE, "Overflow bucket index");
+    assert(pos_idx <= MAX_BUCKET_LENGTH, "Overflow bucket position index");
+    _bucket_idx = bucket_idx;
+    _pos_idx = pos_idx;
+    _site_sampled = sampled ? 1 : 0;
+    _site_recorded = 1;
+  } else {
+    // Something went wrong, could be OOM or overflow malloc site table.
+    // We want to keep tracking data under OOM circumstance, so transition to
+    // summary tracking.
     MemTracker::transition_to(NMT_summary);
   }
-  return ret;
 }
 
 bool MallocHeader::get_stack(NativeCallStack& stack) const {
-  return MallocSiteTable::access_stack(stack, _bucket_idx, _pos_idx);
+  return _site_recorded && MallocSiteTable::access_stack(stack, _bucket_idx, _pos_idx);
 }
 
 bool MallocTracker::initialize(NMT_TrackingLevel level) {
@@ -104,6 +155,12 @@ bool MallocTracker::initialize(NMT_TrackingLevel level) {
   return true;
 }
 
+void MallocTracker::late_initialize(NMT_TrackingLevel level) {
+  if (level == NMT_detail) {
+    _sample_interval = NMTDetailSampleInterval;
+  }
+}
+
 bool MallocTracker::transition(NMT_TrackingLevel from, NMT_TrackingLevel to) {
   assert(from != NMT_off, "Can not transition from off state");
   assert(to != NMT_off, "Can not transition to off state");
@@ -28,6 +28,7 @@
 #if INCLUDE_NMT
 
 #include "memory/allocation.hpp"
+#include "memory/padded.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/threadCritical.hpp"
 #include "services/nmtCommon.hpp"
@@ -39,6 +40,7 @@
  * The counters are updated atomically.
  */
 class MemoryCounter {
+  friend class StripedMemoryCounter;
  private:
   volatile size_t   _count;
   volatile size_t   _size;
@@ -52,8 +54,8 @@ class MemoryCounter {
     DEBUG_ONLY(_peak_size  = 0;)
   }
 
-  inline void allocate(size_t sz) {
-    Atomic::inc(&_count);
+  inline void allocate(size_t sz, size_t cnt = 1) {
+    Atomic::add(cnt, &_count);
     if (sz > 0) {
       Atomic::add(sz, &_size);
       DEBUG_ONLY(_peak_size = MAX2(_peak_size, _size));
@@ -61,10 +63,10 @@ class MemoryCounter {
     DEBUG_ONLY(_peak_count = MAX2(_peak_count, _count);)
   }
 
-  inline void deallocate(size_t sz) {
-    assert(_count > 0, "Nothing allocated yet");
+  inline void deallocate(size_t sz, size_t cnt = 1) {
+    assert(_count >= cnt, "Nothing allocated yet");
     assert(_size >= sz, "deallocation > allocated");
-    Atomic::dec(&_count);
+    Atomic::sub(cnt, &_count);
     if (sz > 0) {
       Atomic::sub(sz, &_size);
     }
@@ -85,12 +87,99 @@ class MemoryCounter {
 
 };
 
+/*
+ * A memory counter that is striped over several cache lines.
+ * An update goes to the stripe picked by the calling thread, so that
+ * threads allocating concurrently rarely bounce the same cache line.
+ * The stripes are summed up on read. A single stripe can wrap around
+ * when memory is released by another thread than the one that
+ * allocated it, but the sum of all stripes is always exact.
+ */
+class StripedMemoryCounter {
+ private:
+  enum {
+    stripe_count = 16    // Must be power of 2
+  };
+
+  struct Stripe {
+    volatile size_t   _count;
+    volatile size_t   _size;
+    DEFINE_PAD_MINUS_SIZE(0, DEFAULT_CACHE_LINE_SIZE, 2 * sizeof(size_t));
+  };
+
+  Stripe _stripes[stripe_count];
+
+  // Threads run on disjoint stacks, so the address of a stack local
+  // is a cheap thread identity that works for threads not attached
+  // to the VM, and before the VM's thread structures are set up.
+  inline Stripe* stripe() {
+    volatile char marker;
+    uint64_t h = ((uint64_t)(uintptr_t)&marker) >> 16;
+    h *= UCONST64(0x9E3779B97F4A7C15);
+    return &_stripes[(size_t)(h >> 60) & (stripe_count - 1)];
+  }
+
+ public:
+  StripedMemoryCounter() {
+    for (int index = 0; index < stripe_count; index ++) {
+      _stripes[index]._count = 0;
+      _stripes[index]._size = 0;
+    }
+  }
+
+  inline void allocate(size_t sz) {
+    Stripe* s = stripe();
+    Atomic::inc(&s->_count);
+    if (sz > 0) {
+      Atomic::add(sz, &s->_size);
+    }
+  }
+
+  inline void deallocate(size_t sz) {
+    Stripe* s = stripe();
+    Atomic::dec(&s->_count);
+    if (sz > 0) {
+      Atomic::sub(sz, &s->_size);
+    }
+  }
+
+  inline void resize(ssize_t sz) {
+    if (sz != 0) {
+      Atomic::add(size_t(sz), &stripe()->_size);
+    }
+  }
+
+  size_t count() const {
+    size_t cnt = 0;
+    for (int index = 0; index < stripe_count; index ++) {
+      cnt += _stripes[index]._count;
+    }
+    return cnt;
+  }
+
+  size_t size() const {
+    size_t sz = 0;
+    for (int index = 0; index < stripe_count; index ++) {
+      sz += _stripes[index]._size;
+    }
+    return sz;
+  }
+
+  void copy_to(MemoryCounter* c) const {
+    c->_count = count();
+    c->_size  = size();
+    DEBUG_ONLY(c->_peak_count = MAX2(c->_peak_count, c->_count);)
+    DEBUG_ONLY(c->_peak_size  = MAX2(c->_peak_size,  c->_size);)
+  }
+};
+
 /*
  * Malloc memory used by a particular subsystem.
  * It includes the memory acquired through os::malloc()
  * call and arena's backing memory.
  */
 class MallocMemory {
+  friend class StripedMallocMemory;
  private:
   MemoryCounter _malloc;
   MemoryCounter _arena;
@@ -127,12 +216,52 @@ class MallocMemory {
   DEBUG_ONLY(inline const MemoryCounter& arena_counter()  const { return _arena;  })
 };
 
+/*
+ * Live counters of malloc memory used by a particular subsystem.
+ * See StripedMemoryCounter.
+ */
+class StripedMallocMemory {
+ private:
+  StripedMemoryCounter _malloc;
+  StripedMemoryCounter _arena;
+
+ public:
+  StripedMallocMemory() { }
+
+  inline void record_malloc(size_t sz) {
+    _malloc.allocate(sz);
+  }
+
+  inline void record_free(size_t sz) {
+    _malloc.deallocate(sz);
+  }
+
+  inline void record_new_arena() {
+    _arena.allocate(0);
+  }
+
+  inline void record_arena_free() {
+    _arena.deallocate(0);
+  }
+
+  inline void record_arena_size_change(ssize_t sz) {
+    _arena.resize(sz);
+  }
+
+  void copy_to(MallocMemory* m) const {
+    _malloc.copy_to(&m->_malloc);
+    _arena.copy_to(&m->_arena);
+  }
+};
+
 class MallocMemorySummary;
+class MallocMemoryCounters;
 
 // A snapshot of malloc'd memory, includes malloc memory
 // usage by types and memory used by tracking itself.
 class MallocMemorySnapshot : public ResourceObj {
   friend class MallocMemorySummary;
+  friend class MallocMemoryCounters;
 
  private:
   MallocMemory      _malloc[mt_number_of_types];
@@ -165,20 +294,38 @@ class MallocMemorySnapshot : public ResourceObj {
     return s->by_type(mtThreadStack)->malloc_count();
   }
 
+  // Make adjustment by subtracting chunks used by arenas
+  // from total chunks to get total free chunk size
+  void make_adjustment();
+};
+
+// The live malloc counters, updated on every malloc and free.
+// They are summed up into a MallocMemorySnapshot for reporting.
+class MallocMemoryCounters {
+ private:
+  StripedMallocMemory   _malloc[mt_number_of_types];
+  StripedMemoryCounter  _tracking_header;
+
+ public:
+  inline StripedMallocMemory* by_type(MEMFLAGS flags) {
+    int index = NMTUtil::flag_to_index(flags);
+    return &_malloc[index];
+  }
+
+  inline StripedMemoryCounter* malloc_overhead() {
+    return &_tracking_header;
+  }
+
   void copy_to(MallocMemorySnapshot* s) {
     // Need to make sure that mtChunks don't get deallocated while the
     // copy is going on, because their size is adjusted using this
     // buffer in make_adjustment().
     ThreadCritical tc;
-    s->_tracking_header = _tracking_header;
+    _tracking_header.copy_to(&s->_tracking_header);
     for (int index = 0; index < mt_number_of_types; index ++) {
-      s->_malloc[index] = _malloc[index];
+      _malloc[index].copy_to(&s->_malloc[index]);
     }
   }
-
-  // Make adjustment by subtracting chunks used by arenas
-  // from total chunks to get total free chunk size
-  void make_adjustment();
 };
 
 /*
@@ -186,53 +333,53 @@ class MallocMemorySnapshot : public ResourceObj {
  */
 class MallocMemorySummary : AllStatic {
  private:
-  // Reserve memory for placement of MallocMemorySnapshot object
-  static size_t _snapshot[CALC_OBJ_SIZE_IN_TYPE(MallocMemorySnapshot, size_t)];
+  // Reserve memory for placement of MallocMemoryCounters object
+  static size_t _counters[CALC_OBJ_SIZE_IN_TYPE(MallocMemoryCounters, size_t)];
 
  public:
    static void initialize();
 
    static inline void record_malloc(size_t size, MEMFLAGS flag) {
-     as_snapshot()->by_type(flag)->record_malloc(size);
+     as_counters()->by_type(flag)->record_malloc(size);
    }
 
    static inline void record_free(size_t size, MEMFLAGS flag) {
-     as_snapshot()->by_type(flag)->record_free(size);
+     as_counters()->by_type(flag)->record_free(size);
    }
 
    static inline void record_new_arena(MEMFLAGS flag) {
-     as_snapshot()->by_type(flag)->record_new_arena();
+     as_counters()->by_type(flag)->record_new_arena();
    }
 
    static inline void record_arena_free(MEMFLAGS flag) {
-     as_snapshot()->by_type(flag)->record_arena_free();
+     as_counters()->by_type(flag)->record_arena_free();
    }
 
    static inline void record_arena_size_change(ssize_t size, MEMFLAGS flag) {
-     as_snapshot()->by_type(flag)->record_arena_size_change(size);
+     as_counters()->by_type(flag)->record_arena_size_change(size);
    }
 
    static void snapshot(MallocMemorySnapshot* s) {
-     as_snapshot()->copy_to(s);
+     as_counters()->copy_to(s);
      s->make_adjustment();
    }
 
    // Record memory used by malloc tracking header
    static inline void record_new_malloc_header(size_t sz) {
-     as_snapshot()->malloc_overhead()->allocate(sz);
+     as_counters()->malloc_overhead()->allocate(sz);
    }
 
    static inline void record_free_malloc_header(size_t sz) {
-     as_snapshot()->malloc_overhead()->deallocate(sz);
+     as_counters()->malloc_overhead()->deallocate(sz);
    }
 
    // The memory used by malloc tracking headers
    static inline size_t tracking_overhead() {
-     return as_snapshot()->malloc_overhead()->size();
+     return as_counters()->malloc_overhead()->size();
    }
 
-  static MallocMemorySnapshot* as_snapshot() {
-    return (MallocMemorySnapshot*)_snapshot;
+  static MallocMemoryCounters* as_counters() {
+    return (MallocMemoryCounters*)_counters;
   }
 };
 
@@ -248,15 +395,19 @@ class MallocHeader {
   size_t           _size      : 64;
   size_t           _flags     : 8;
   size_t           _pos_idx   : 16;
-  size_t           _bucket_idx: 40;
-#define MAX_MALLOCSITE_TABLE_SIZE right_n_bits(40)
+  size_t           _site_recorded : 1;
+  size_t           _site_sampled  : 1;
+  size_t           _bucket_idx: 38;
+#define MAX_MALLOCSITE_TABLE_SIZE right_n_bits(38)
 #define MAX_BUCKET_LENGTH         right_n_bits(16)
 #else
   size_t           _size      : 32;
   size_t           _flags     : 8;
   size_t           _pos_idx   : 8;
-  size_t           _bucket_idx: 16;
-#define MAX_MALLOCSITE_TABLE_SIZE  right_n_bits(16)
+  size_t           _site_recorded : 1;
+  size_t           _site_sampled  : 1;
+  size_t           _bucket_idx: 14;
+#define MAX_MALLOCSITE_TABLE_SIZE  right_n_bits(14)
 #define MAX_BUCKET_LENGTH          right_n_bits(8)
 #endif  // _LP64
 
@@ -272,14 +423,9 @@ class MallocHeader {
     _flags = flags;
     set_size(size);
     if (level == NMT_detail) {
-      size_t bucket_idx;
-      size_t pos_idx;
-      if (record_malloc_site(stack, size, &bucket_idx, &pos_idx, flags)) {
-        assert(bucket_idx <= MAX_MALLOCSITE_TABLE_SIZE, "Overflow bucket index");
-        assert(pos_idx <= MAX_BUCKET_LENGTH, "Overflow bucket position index");
-        _bucket_idx = bucket_idx;
-        _pos_idx = pos_idx;
-      }
+      _site_recorded = 0;
+      _site_sampled = 0;
+      record_malloc_site(stack, size, flags);
     }
 
     MallocMemorySummary::record_malloc(size, flags);
@@ -297,8 +443,7 @@ class MallocHeader {
   inline void set_size(size_t size) {
     _size = size;
   }
-  bool record_malloc_site(const NativeCallStack& stack, size_t size,
-    size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags) const;
+  void record_malloc_site(const NativeCallStack& stack, size_t size, MEMFLAGS flags);
 };
 
 
@@ -308,8 +453,37 @@ class MallocTracker : AllStatic {
   // Initialize malloc tracker for specific tracking level
   static bool initialize(NMT_TrackingLevel level);
 
+  // Late initialization, after command line arguments are parsed
+  static void late_initialize(NMT_TrackingLevel level);
+
   static bool transition(NMT_TrackingLevel from, NMT_TrackingLevel to);
 
+  // In detail tracking, the call site of an allocation smaller than the
+  // sample interval is only recorded for one in sample_count(size) such
+  // allocations, picked at random, and then accounted at that site as
+  // sample_count(size) allocations. Zero records every allocation.
+  static inline size_t sample_interval() { return _sample_interval; }
+
+  // Whether the call site of a malloc of size bytes is subject to sampling
+  static inline bool is_sampled_size(size_t size) {
+    return size > 0 && size < _sample_interval;
+  }
+
+  // interval / size rounded to the nearest, at least 1 for a sampled size
+  static inline size_t sample_count(size_t size) {
+    return (_sample_interval + size / 2) / size;
+  }
+
+  // Whether the call site of the next malloc of size bytes on the current
+  // thread will be recorded. Lets callers skip walking the stack if not.
+  static inline bool will_record_site(size_t size) {
+    return !is_sampled_size(size) || _sample_random % sample_count(size) == 0;
+  }
+
+  // Whether the call site of a malloc of size bytes, subject to sampling,
+  // is recorded. Agrees with the preceding will_record_site(size).
+  static bool take_sample(size_t size);
+
   // malloc tracking header size for specific tracking level
   static inline size_t malloc_header_size(NMT_TrackingLevel level) {
     return (level == NMT_off) ? 0 : sizeof(MallocHeader);
@@ -366,6 +540,17 @@ class MallocTracker : AllStatic {
     MallocMemorySummary::record_arena_size_change(size, flags);
   }
  private:
+  // Set once at late initialization and never changed afterwards, so that
+  // a sampled allocation is released with the weight it was recorded with.
+  static size_t _sample_interval;
+
+  // The random number that decides on the next sample of the current thread
+#ifndef USE_LIBRARY_BASED_TLS_ONLY
+  static THREAD_LOCAL_DECL uint64_t _sample_random;
+#else
+  static uint64_t _sample_random;
+#endif
+
   static inline MallocHeader* malloc_header(void *memblock) {
     assert(memblock != NULL, "NULL pointer");
     MallocHeader* header = (MallocHeader*)((char*)memblock - sizeof(MallocHeader));
@@ -47,6 +47,7 @@
 #include "runtime/os.hpp"
 #include "runtime/thread.inline.hpp"
 #include "runtime/threadSMR.hpp"
+#include "services/allocationSiteProfiler.hpp"
 #include "services/classLoadingService.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/diagnosticFramework.hpp"
@@ -92,6 +93,7 @@ void management_init() {
 #else
   ThreadService::init();
 #endif // INCLUDE_MANAGEMENT
+  AllocationSiteProfiler::initialize();
 }
 
 #if INCLUDE_MANAGEMENT
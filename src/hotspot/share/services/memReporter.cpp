@@ -241,6 +241,11 @@ void MemDetailReporter::report_detail() {
   outputStream* out = output();
   out->print_cr("Details:\n");
 
+  if (MallocTracker::sample_interval() > 0) {
+    out->print_cr("Malloc sites are sampled every " SIZE_FORMAT " bytes, their sizes and counts are estimates.\n",
+      MallocTracker::sample_interval());
+  }
+
   report_malloc_sites();
   report_virtual_memory_allocation_sites();
 }
@@ -93,6 +93,7 @@ NMT_TrackingLevel MemTracker::init_tracking_level() {
 void MemTracker::init() {
   NMT_TrackingLevel level = tracking_level();
   if (level >= NMT_summary) {
+    MallocTracker::late_initialize(level);
     if (!VirtualMemoryTracker::late_initialize(level) ||
         !ThreadStackTracker::late_initialize(level)) {
       shutdown();
@@ -340,6 +341,7 @@ void MemTracker::tuning_statistics(outputStream* out) {
   out->print_cr("Native Memory Tracking Statistics:");
   out->print_cr("Malloc allocation site table size: %d", MallocSiteTable::hash_buckets());
   out->print_cr("             Tracking stack depth: %d", NMT_TrackingStackDepth);
+  out->print_cr("       Malloc site sample interval: " SIZE_FORMAT, MallocTracker::sample_interval());
   NOT_PRODUCT(out->print_cr("Peak concurrent access: %d", MallocSiteTable::access_peak_count());)
   out->print_cr(" ");
   walker.report_statistics(out);
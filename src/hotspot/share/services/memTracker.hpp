@@ -33,6 +33,7 @@
 
 #define CURRENT_PC   NativeCallStack::empty_stack()
 #define CALLER_PC    NativeCallStack::empty_stack()
+#define MALLOC_CALLER_PC(size) NativeCallStack::empty_stack()
 
 class Tracker : public StackObj {
  public:
@@ -91,6 +92,11 @@ extern volatile bool NMT_stack_walkable;
                     NativeCallStack(0, true) : NativeCallStack::empty_stack())
 #define CALLER_PC  ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable) ?  \
                     NativeCallStack(1, true) : NativeCallStack::empty_stack())
+// CALLER_PC for a malloc of size bytes. The stack is only walked if the call
+// site of the malloc will be recorded, see MallocTracker::sample_interval().
+#define MALLOC_CALLER_PC(size) ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable && \
+                                 MallocTracker::will_record_site(size)) ?                          \
+                                NativeCallStack(1, true) : NativeCallStack::empty_stack())
 
 class MemBaseline;
 
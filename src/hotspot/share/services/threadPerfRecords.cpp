@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "classfile/javaClasses.inline.hpp"
+#include "memory/allocation.inline.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/perfData.hpp"
+#include "runtime/perfMemory.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/threadSMR.hpp"
+#include "services/threadPerfRecords.hpp"
+#include "services/threadService.hpp"
+#include "utilities/align.hpp"
+
+enum RecordState {
+  record_free,
+  record_used,
+  record_released
+};
+
+// in the memory reserved at the end of the PerfData region
+static jlong* _records = NULL;
+// RecordState of each record
+static volatile jint* _states = NULL;
+static jint _capacity = 0;
+// where to start looking for a free record, protected by the Threads_lock
+static jint _next_free = 0;
+static jlong _last_sample_time = 0;
+
+static jlong* record_at(jint index) {
+  assert(index >= 0 && index < _capacity, "invariant");
+  return _records + (size_t)index * ThreadPerfRecords::record_length;
+}
+
+static void begin_update(jlong* record) {
+  record[ThreadPerfRecords::sequence_offset]++;
+  OrderAccess::storestore();
+}
+
+static void end_update(jlong* record) {
+  OrderAccess::release_store(&record[ThreadPerfRecords::sequence_offset],
+                             record[ThreadPerfRecords::sequence_offset] + 1);
+}
+
+bool ThreadPerfRecords::is_enabled() {
+  return UsePerfData && PerfDataThreadRecords;
+}
+
+size_t ThreadPerfRecords::memory_size() {
+  if (!is_enabled()) {
+    return 0;
+  }
+  return (size_t)PerfDataMaxThreadRecords * record_length * sizeof(jlong);
+}
+
+void ThreadPerfRecords::initialize(TRAPS) {
+  if (!is_enabled()) {
+    return;
+  }
+  char* const reserved = PerfMemory::reserved();
+  if (reserved == NULL) {
+    // the PerfData memory is not shared, no one could read the records
+    return;
+  }
+  const jint capacity = (jint)PerfDataMaxThreadRecords;
+  assert(PerfMemory::reserved_size() >= memory_size(), "invariant");
+  assert(is_aligned(reserved, sizeof(jlong)), "invariant");
+  PerfDataManager::create_constant(SUN_THREADS, "threadRecordLength",
+                                   PerfData::U_None, (jlong)record_length, CHECK);
+  PerfDataManager::create_constant(SUN_THREADS, "threadRecordCapacity",
+                                   PerfData::U_None, (jlong)capacity, CHECK);
+  PerfDataManager::create_constant(SUN_THREADS, "threadRecordsOffset",
+                                   PerfData::U_Bytes, (jlong)(reserved - PerfMemory::start()), CHECK);
+  jlong* const records = (jlong*)reserved;
+  memset(records, 0, memory_size());
+  _states = NEW_C_HEAP_ARRAY(jint, capacity, mtInternal);
+  for (jint i = 0; i < capacity; ++i) {
+    _states[i] = record_free;
+  }
+  _capacity = capacity;
+  _records = records;
+}
+
+void ThreadPerfRecords::add_thread(JavaThread* thread) {
+  assert(Threads_lock->owned_by_self(), "must have threads lock");
+  if (_records == NULL) {
+    return;
+  }
+  ThreadStatistics* const stat = thread->get_thread_stat();
+  assert(stat->perf_record() == -1, "invariant");
+  for (jint i = 0; i < _capacity; ++i) {
+    const jint index = (_next_free + i) % _capacity;
+    if (OrderAccess::load_acquire(&_states[index]) != record_free) {
+      continue;
+    }
+    _states[index] = record_used;
+    _next_free = index + 1;
+
+    // The thread object is not yet set for the initial
+    // thread and for threads attaching through JNI.
+    const oop thread_obj = thread->threadObj();
+    oop name = thread_obj != NULL ? java_lang_Thread::name(thread_obj) : (oop)NULL;
+    const OSThread* const os_thread = thread->osthread();
+
+    jlong* const record = record_at(index);
+    begin_update(record);
+    record[state_offset] = (jlong)thread->thread_state();
+    record[os_thread_id_offset] = os_thread != NULL ? (jlong)os_thread->thread_id() : 0;
+    record[java_thread_id_offset] = thread_obj != NULL ? java_lang_Thread::thread_id(thread_obj) : 0;
+    record[name_hash_offset] = name != NULL ? (jlong)java_lang_String::hash_code(name) : 0;
+    record[cpu_time_offset] = 0;
+    record[allocated_bytes_offset] = 0;
+    end_update(record);
+
+    stat->set_perf_record(index);
+    return;
+  }
+  // all records are in use, the thread is not published
+}
+
+void ThreadPerfRecords::remove_thread(JavaThread* thread) {
+  assert(Threads_lock->owned_by_self(), "must have threads lock");
+  ThreadStatistics* const stat = thread->get_thread_stat();
+  const int index = stat->perf_record();
+  if (index < 0) {
+    return;
+  }
+  stat->set_perf_record(-1);
+  // freed by the sampler, which might still be updating the record
+  OrderAccess::release_store(&_states[index], (jint)record_released);
+}
+
+void ThreadPerfRecords::sample() {
+  if (_records == NULL) {
+    return;
+  }
+  const jlong now = os::javaTimeNanos();
+  if (now - _last_sample_time < PerfDataThreadRecordsInterval * NANOSECS_PER_MILLISEC) {
+    return;
+  }
+  _last_sample_time = now;
+
+  const bool cpu_time_supported = os::is_thread_cpu_time_supported();
+  {
+    ThreadsListHandle tlh;
+    JavaThreadIterator jti(tlh.list());
+    for (JavaThread* jt = jti.first(); jt != NULL; jt = jti.next()) {
+      const int index = jt->get_thread_stat()->perf_record();
+      if (index < 0 || jt->is_terminated()) {
+        continue;
+      }
+      jlong* const record = record_at(index);
+      begin_update(record);
+      record[state_offset] = (jlong)jt->thread_state();
+      record[cpu_time_offset] = cpu_time_supported ? os::thread_cpu_time(jt) : -1;
+      record[allocated_bytes_offset] = jt->cooked_allocated_bytes();
+      end_update(record);
+    }
+  }
+
+  // No update from this pass can reach the records released
+  // so far, which makes them safe to reuse.
+  for (jint i = 0; i < _capacity; ++i) {
+    if (OrderAccess::load_acquire(&_states[i]) != record_released) {
+      continue;
+    }
+    jlong* const record = record_at(i);
+    begin_update(record);
+    for (int offset = state_offset; offset < record_length; ++offset) {
+      record[offset] = 0;
+    }
+    end_update(record);
+    OrderAccess::release_store(&_states[i], (jint)record_free);
+  }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_SERVICES_THREADPERFRECORDS_HPP
+#define SHARE_SERVICES_THREADPERFRECORDS_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/exceptions.hpp"
+
+class JavaThread;
+
+// ThreadPerfRecords publishes one record per live Java thread in the
+// PerfData memory region. External tools that map hsperfdata can read
+// per-thread CPU time and allocated bytes without attaching to the VM,
+// making JNI calls or taking the Threads_lock.
+//
+// The records are kept in the memory reserved at the end of the region,
+// outside the PerfData entry list, so jvmstat clients never see them.
+// Readers locate them with the sun.threads.threadRecordsOffset (bytes
+// from the start of the region), sun.threads.threadRecordCapacity and
+// sun.threads.threadRecordLength constants. Each record is an array of
+// record_length jlongs, in native byte order:
+//
+//   [0] sequence         odd while the record is being updated
+//   [1] state            JavaThreadState, 0 if the record is unused
+//   [2] os_thread_id     native thread id
+//   [3] java_thread_id   java.lang.Thread id, 0 if not known when added
+//   [4] name_hash        hash of the thread name when added, 0 if not known
+//   [5] cpu_time         in nanoseconds, -1 if not supported
+//   [6] allocated_bytes
+//
+// A reader copies a record and retries if the sequence was odd or changed.
+//
+// Records are assigned and released under the Threads_lock as threads are
+// added and removed, while the values are refreshed by the StatSampler
+// every PerfDataThreadRecordsInterval milliseconds. A released record only
+// becomes free once the sampler completes its next pass, so it can never
+// receive the values of the thread that used to own it.
+class ThreadPerfRecords : AllStatic {
+ public:
+  enum {
+    sequence_offset,
+    state_offset,
+    os_thread_id_offset,
+    java_thread_id_offset,
+    name_hash_offset,
+    cpu_time_offset,
+    allocated_bytes_offset,
+    record_length
+  };
+
+  static bool is_enabled();
+  // PerfData memory needed for the records, 0 if disabled
+  static size_t memory_size();
+
+  static void initialize(TRAPS);
+
+  // called with the Threads_lock held
+  static void add_thread(JavaThread* thread);
+  static void remove_thread(JavaThread* thread);
+
+  // called by the StatSampler
+  static void sample();
+};
+
+#endif // SHARE_SERVICES_THREADPERFRECORDS_HPP
@@ -34,6 +34,7 @@
 #include "oops/oop.inline.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/handles.inline.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/init.hpp"
 #include "runtime/objectMonitor.inline.hpp"
 #include "runtime/thread.inline.hpp"
@@ -41,7 +42,9 @@
 #include "runtime/vframe.hpp"
 #include "runtime/vmThread.hpp"
 #include "runtime/vmOperations.hpp"
+#include "services/threadPerfRecords.hpp"
 #include "services/threadService.hpp"
+#include "utilities/resourceHash.hpp"
 
 // TODO: we need to define a naming convention for perf counters
 // to distinguish counters for:
@@ -93,6 +96,8 @@ void ThreadService::init() {
   }
 
   _thread_allocated_memory_enabled = true; // Always on, so enable it
+
+  ThreadPerfRecords::initialize(CHECK);
 }
 
 void ThreadService::reset_peak_thread_count() {
@@ -128,6 +133,8 @@ void ThreadService::add_thread(JavaThread* thread, bool daemon) {
     _daemon_threads_count->inc();
     Atomic::inc(&_atomic_daemon_threads_count);
   }
+
+  ThreadPerfRecords::add_thread(thread);
 }
 
 void ThreadService::decrement_thread_counts(JavaThread* jt, bool daemon) {
@@ -147,6 +154,8 @@ void ThreadService::remove_thread(JavaThread* thread, bool daemon) {
   }
 
   assert(!thread->is_terminated(), "must not be terminated");
+  ThreadPerfRecords::remove_thread(thread);
+
   if (!thread->is_exiting()) {
     // JavaThread::exit() skipped calling current_thread_exiting()
     decrement_thread_counts(thread, daemon);
@@ -847,6 +856,7 @@ ThreadStatistics::ThreadStatistics() {
   _count_pending_reset = false;
   _timer_pending_reset = false;
   memset((void*) _perf_recursion_counts, 0, sizeof(_perf_recursion_counts));
+  _perf_record = -1;
 }
 
 void ThreadSnapshot::initialize(ThreadsList * t_list, JavaThread* thread) {
@@ -1014,6 +1024,163 @@ void DeadlockCycle::print_on_with(ThreadsList * t_list, outputStream* st) const
   JavaMonitorsInStackTrace = oldJavaMonitorsInStackTrace;
 }
 
+// Prints one Java thread into a buffer from within a handshake, and notes
+// which thread, if any, owns the lock the printed thread is blocked on.
+class ThreadDumpClosure : public ThreadClosure {
+ private:
+  ThreadsList*    _t_list;
+  bufferedStream* _buf;
+  bool            _print_extended_info;
+  JavaThread*     _lock_owner;
+  bool            _lock_owner_unknown;
+
+  void record_lock_owner(JavaThread* jt) {
+    _lock_owner = NULL;
+    _lock_owner_unknown = false;
+
+    ObjectMonitor* waitingToLockMonitor = (ObjectMonitor*)jt->current_pending_monitor();
+    if (waitingToLockMonitor != NULL) {
+      address currentOwner = (address)waitingToLockMonitor->owner();
+      if (currentOwner != NULL) {
+        _lock_owner = Threads::owning_thread_from_monitor_owner(_t_list, currentOwner);
+        // find_deadlocks_at_safepoint() reports an owner that cannot be
+        // found as a deadlock, so treat it as a reason to look closer.
+        _lock_owner_unknown = (_lock_owner == NULL);
+      }
+      return;
+    }
+
+    oop waitingToLockBlocker = jt->current_park_blocker();
+    Klass* aos_klass = SystemDictionary::java_util_concurrent_locks_AbstractOwnableSynchronizer_klass();
+    if (waitingToLockBlocker != NULL && aos_klass != NULL && waitingToLockBlocker->is_a(aos_klass)) {
+      oop threadObj = java_util_concurrent_locks_AbstractOwnableSynchronizer::get_owner_threadObj(waitingToLockBlocker);
+      _lock_owner = threadObj != NULL ? java_lang_Thread::thread(threadObj) : NULL;
+    }
+  }
+
+ public:
+  ThreadDumpClosure(ThreadsList* t_list, bufferedStream* buf, bool print_extended_info) :
+    _t_list(t_list), _buf(buf), _print_extended_info(print_extended_info),
+    _lock_owner(NULL), _lock_owner_unknown(false) {}
+
+  JavaThread* lock_owner() const   { return _lock_owner; }
+  bool lock_owner_unknown() const  { return _lock_owner_unknown; }
+
+  void do_thread(Thread* th) {
+    JavaThread* jt = (JavaThread*)th;
+    ResourceMark rm;
+    jt->print_on(_buf, _print_extended_info);
+    jt->print_stack_on(_buf);
+    _buf->cr();
+    record_lock_owner(jt);
+  }
+};
+
+ThreadDumpPrinter::ThreadDumpPrinter(outputStream* st, bool print_concurrent_locks, bool print_extended_info) :
+  _st(st),
+  _print_concurrent_locks(print_concurrent_locks),
+  _print_extended_info(print_extended_info),
+  // Concurrent locks are found by walking the heap, which needs a safepoint
+  // anyway, and without thread-local handshakes every handshake would be one.
+  _at_safepoint(print_concurrent_locks || !HandshakeThreadDump || !ThreadLocalHandshakes),
+  _deadlock_suspected(true) {}
+
+void ThreadDumpPrinter::print_threads() {
+  if (_at_safepoint) {
+    VM_PrintThreads op(_st, _print_concurrent_locks, _print_extended_info);
+    VMThread::execute(&op);
+  } else {
+    print_threads_with_handshakes();
+  }
+}
+
+void ThreadDumpPrinter::print_threads_with_handshakes() {
+  ResourceMark rm;
+  ThreadsListHandle tlh;
+  ThreadsList* t_list = tlh.list();
+  int num_threads = (int)t_list->length();
+
+  Threads::print_header_on(_st);
+  ThreadsSMRSupport::print_info_on(_st);
+  _st->cr();
+
+  // Lock graph as seen by the handshakes: owner[i] is the index of the
+  // thread owning the lock that thread i is blocked on, or -1.
+  int* owner = NEW_RESOURCE_ARRAY(int, num_threads);
+  JavaThread** owner_thread = NEW_RESOURCE_ARRAY(JavaThread*, num_threads);
+  bool has_edges = false;
+  bool has_unknown_owner = false;
+
+  bufferedStream buf;
+  for (int i = 0; i < num_threads; i++) {
+    JavaThread* jt = t_list->thread_at(i);
+    ThreadDumpClosure cl(t_list, &buf, _print_extended_info);
+    owner_thread[i] = NULL;
+    if (!Handshake::execute(&cl, jt)) {
+      // The thread has exited.
+      continue;
+    }
+    _st->write(buf.base(), buf.size());
+    _st->flush();
+    buf.reset();
+
+    owner_thread[i] = cl.lock_owner();
+    has_edges |= (cl.lock_owner() != NULL);
+    has_unknown_owner |= cl.lock_owner_unknown();
+  }
+
+  Threads::print_non_java_threads_on(_st);
+  _st->flush();
+
+  if (has_unknown_owner) {
+    _deadlock_suspected = true;
+    return;
+  }
+  _deadlock_suspected = false;
+  if (!has_edges) {
+    return;
+  }
+
+  ResourceHashtable<JavaThread*, int> index_of;
+  for (int i = 0; i < num_threads; i++) {
+    index_of.put(t_list->thread_at(i), i);
+  }
+  for (int i = 0; i < num_threads; i++) {
+    int* index = owner_thread[i] != NULL ? index_of.get(owner_thread[i]) : NULL;
+    owner[i] = index != NULL ? *index : -1;
+  }
+
+  // Every thread waits for at most one other, so walking from each thread
+  // either ends or runs into a cycle. A cycle is only new if it closes on
+  // a thread visited by the current walk.
+  int* visited_by = NEW_RESOURCE_ARRAY(int, num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    visited_by[i] = -1;
+  }
+  for (int i = 0; i < num_threads && !_deadlock_suspected; i++) {
+    int previous = -1;
+    int current = i;
+    while (current != -1 && visited_by[current] == -1) {
+      visited_by[current] = i;
+      previous = current;
+      current = owner[current];
+    }
+    if (current != -1 && visited_by[current] == i && current != previous) {
+      _deadlock_suspected = true;
+    }
+  }
+}
+
+void ThreadDumpPrinter::print_deadlocks() {
+  // The handshakes see each thread at a different time, so a suspected
+  // cycle is confirmed and printed at a safepoint. A real deadlock does not
+  // change between handshakes and is always suspected.
+  if (_deadlock_suspected) {
+    VM_FindDeadlocks op(_st);
+    VMThread::execute(&op);
+  }
+}
+
 ThreadsListEnumerator::ThreadsListEnumerator(Thread* cur_thread,
                                              bool include_jvmti_agent_threads,
                                              bool include_jni_attaching_threads) {
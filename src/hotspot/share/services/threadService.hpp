@@ -143,6 +143,10 @@ private:
   int           _perf_recursion_counts[6];
   elapsedTimer  _perf_timers[6];
 
+  // Index of the thread's record in ThreadPerfRecords, -1 if none.
+  // Only changed with the Threads_lock held.
+  int           _perf_record;
+
   // utility functions
   void  check_and_reset_count()            {
                                              if (!_count_pending_reset) return;
@@ -181,6 +185,9 @@ public:
   void contended_enter_begin()             { check_and_reset_timer(); _contended_enter_timer.start(); }
   void contended_enter_end()               { _contended_enter_timer.stop(); check_and_reset_timer(); }
 
+  int  perf_record() const                 { return _perf_record; }
+  void set_perf_record(int index)          { _perf_record = index; }
+
   void reset_count_stat()                  { _count_pending_reset = true; }
   void reset_time_stat()                   { _timer_pending_reset = true; }
 
@@ -412,6 +419,28 @@ class DeadlockCycle : public CHeapObj<mtInternal> {
   void           print_on_with(ThreadsList * t_list, outputStream* st) const;
 };
 
+// Prints a thread dump in the format of VM_PrintThreads. Unless
+// java.util.concurrent locks are requested, the Java threads are printed
+// one at a time from a handshake rather than all at once at a safepoint,
+// and each thread's output is written to the stream as soon as it has been
+// captured. The lock dependencies seen by the handshakes are kept so that
+// print_deadlocks() only needs a safepoint if they suggest a deadlock.
+class ThreadDumpPrinter : public StackObj {
+ private:
+  outputStream* _st;
+  bool          _print_concurrent_locks;
+  bool          _print_extended_info;
+  bool          _at_safepoint;
+  bool          _deadlock_suspected;
+
+  void print_threads_with_handshakes();
+ public:
+  ThreadDumpPrinter(outputStream* st, bool print_concurrent_locks, bool print_extended_info);
+
+  void print_threads();
+  void print_deadlocks();
+};
+
 // Utility class to get list of java threads.
 class ThreadsListEnumerator : public StackObj {
 private:
@@ -79,6 +79,34 @@ Java_sun_nio_ch_EPoll_ctl(JNIEnv *env, jclass clazz, jint epfd,
     return (res == 0) ? 0 : errno;
 }
 
+/*
+ * Applies count interest updates with one JNI transition. The updates are
+ * an array of jint quadruples at address: the epoll_ctl opcode, the file
+ * descriptor, the events, and a slot for the result, which is set to 0 or
+ * the errno of the failed epoll_ctl. Returns the number of failed updates.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_EPoll_ctlBatch(JNIEnv *env, jclass clazz, jint epfd,
+                               jlong address, jint count)
+{
+    jint *update = jlong_to_ptr(address);
+    struct epoll_event event;
+    jint failed = 0;
+    int i;
+
+    for (i = 0; i < count; i++, update += 4) {
+        event.events = update[2];
+        event.data.fd = update[1];
+        if (epoll_ctl(epfd, (int)update[0], (int)update[1], &event) == 0) {
+            update[3] = 0;
+        } else {
+            update[3] = errno;
+            failed++;
+        }
+    }
+    return failed;
+}
+
 JNIEXPORT jint JNICALL
 Java_sun_nio_ch_EPoll_wait(JNIEnv *env, jclass clazz, jint epfd,
                            jlong address, jint numfds, jint timeout)
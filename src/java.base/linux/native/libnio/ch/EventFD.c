@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "jni.h"
+#include "jni_util.h"
+#include "jlong.h"
+#include "nio.h"
+#include "nio_util.h"
+
+/*
+ * An eventfd is used to wake up a selector. It needs a single descriptor
+ * where a pipe needs two, and any number of wakeups before the selector
+ * drains it are merged into its counter.
+ */
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_EventFD_eventfd0(JNIEnv *env, jclass clazz)
+{
+    int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (efd < 0) {
+        JNU_ThrowIOExceptionWithLastError(env, "eventfd failed");
+        return IOS_THROWN;
+    }
+    return efd;
+}
+
+JNIEXPORT void JNICALL
+Java_sun_nio_ch_EventFD_set0(JNIEnv *env, jclass clazz, jint efd)
+{
+    uint64_t one = 1;
+    ssize_t res;
+
+    RESTARTABLE(write(efd, &one, sizeof(one)), res);
+    /* EAGAIN means that the counter is saturated, so it is set already */
+    if (res < 0 && errno != EAGAIN) {
+        JNU_ThrowIOExceptionWithLastError(env, "eventfd write failed");
+    }
+}
+
+/*
+ * Resets the counter. Returns true if the eventfd was set.
+ */
+JNIEXPORT jboolean JNICALL
+Java_sun_nio_ch_EventFD_drain0(JNIEnv *env, jclass clazz, jint efd)
+{
+    uint64_t value;
+    ssize_t res;
+
+    RESTARTABLE(read(efd, &value, sizeof(value)), res);
+    if (res < 0) {
+        if (errno != EAGAIN) {
+            JNU_ThrowIOExceptionWithLastError(env, "eventfd read failed");
+        }
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
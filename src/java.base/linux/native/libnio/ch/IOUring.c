@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Native methods of sun.nio.ch.IOUring, an io_uring instance that
+ * dispatchers use instead of one system call per read or write.
+ *
+ * Operations are first prepared in the submission queue, which is shared
+ * memory and needs no system call, and then submitted in a batch with a
+ * single io_uring_enter. Completions are copied from the completion queue
+ * into a native array in the layout of struct io_uring_cqe, which the
+ * Java code reads like the epoll_event array of sun.nio.ch.EPoll.
+ *
+ * The system calls are made directly so that no liburing is needed. If
+ * the headers or the kernel do not support io_uring, isAvailable returns
+ * false and the dispatchers keep using epoll and blocking calls. The
+ * kernel must also copy the data of an operation when it is submitted
+ * (IORING_FEAT_SUBMIT_STABLE, Linux 5.5), see prepare_rw.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "jni.h"
+#include "jni_util.h"
+#include "jvm.h"
+#include "jlong.h"
+#include "nio.h"
+#include "nio_util.h"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_FEAT_SUBMIT_STABLE
+#define HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifdef HAVE_IO_URING
+
+/* The system call numbers are the same on all architectures since 5.1 */
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup     425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter     426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register  427
+#endif
+
+typedef struct {
+    int ring_fd;
+
+    /* submission queue */
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_entries;
+    unsigned *sq_array;
+    struct io_uring_sqe *sqes;
+    /* iovecs of the prepared vectored operations, one per submission slot,
+       only used until the operation is submitted */
+    struct iovec *iovecs;
+
+    /* completion queue */
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+} ring_t;
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+/*
+ * Without IORING_FEAT_SUBMIT_STABLE, an operation that the kernel completes
+ * asynchronously may read its iovec after submission, when the slot can
+ * already be reused.
+ */
+static int is_supported(struct io_uring_params *p) {
+    return (p->features & IORING_FEAT_SUBMIT_STABLE) != 0;
+}
+
+static void unmap_ring(ring_t *ring) {
+    if (ring->sqes != NULL) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring != NULL) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != NULL) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    free(ring->iovecs);
+}
+
+static int map_ring(ring_t *ring, struct io_uring_params *p) {
+    char *sq;
+    char *cq;
+
+    ring->sq_ring_size = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+    sq = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) {
+        return -1;
+    }
+    ring->sq_ring = sq;
+    ring->sq_head = (unsigned *)(sq + p->sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + p->sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + p->sq_off.ring_mask);
+    ring->sq_entries = (unsigned *)(sq + p->sq_off.ring_entries);
+    ring->sq_array = (unsigned *)(sq + p->sq_off.array);
+
+    ring->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        return -1;
+    }
+
+    ring->cq_ring_size = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+    cq = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING);
+    if (cq == MAP_FAILED) {
+        return -1;
+    }
+    ring->cq_ring = cq;
+    ring->cq_head = (unsigned *)(cq + p->cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + p->cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + p->cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + p->cq_off.cqes);
+
+    ring->iovecs = calloc(p->sq_entries, sizeof(struct iovec));
+    return (ring->iovecs == NULL) ? -1 : 0;
+}
+
+/*
+ * Returns the next free submission queue entry, or NULL if the queue is
+ * full and must be submitted first. The entry only becomes visible to the
+ * kernel in publish_sqe.
+ */
+static struct io_uring_sqe *next_sqe(ring_t *ring, unsigned *index) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *ring->sq_tail;
+    struct io_uring_sqe *sqe;
+
+    if (tail - head >= *ring->sq_entries) {
+        return NULL;
+    }
+    *index = tail & *ring->sq_mask;
+    sqe = &ring->sqes[*index];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static void publish_sqe(ring_t *ring, unsigned index) {
+    unsigned tail = *ring->sq_tail;
+    ring->sq_array[tail & *ring->sq_mask] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * The iovec of a vectored operation is kept in the slot of its submission
+ * queue entry. The slot is reused once the entry has been consumed by
+ * io_uring_enter, which is safe as the kernel copies the iovec on
+ * submission (IORING_FEAT_SUBMIT_STABLE).
+ */
+static jint prepare_rw(ring_t *ring, int vectored_op, int fixed_op, jint fd,
+                       jlong address, jint len, jlong offset, jint bufIndex,
+                       jlong userData)
+{
+    unsigned index;
+    struct io_uring_sqe *sqe = next_sqe(ring, &index);
+    if (sqe == NULL) {
+        return IOS_UNAVAILABLE;
+    }
+    sqe->fd = fd;
+    sqe->off = (__u64)offset;
+    sqe->user_data = (__u64)userData;
+    if (bufIndex >= 0) {
+        /* registered buffer, no page pinning per operation */
+        sqe->opcode = fixed_op;
+        sqe->addr = (__u64)(uintptr_t)jlong_to_ptr(address);
+        sqe->len = (__u32)len;
+        sqe->buf_index = (__u16)bufIndex;
+    } else {
+        struct iovec *iov = &ring->iovecs[index];
+        iov->iov_base = jlong_to_ptr(address);
+        iov->iov_len = (size_t)len;
+        sqe->opcode = vectored_op;
+        sqe->addr = (__u64)(uintptr_t)iov;
+        sqe->len = 1;
+    }
+    publish_sqe(ring, index);
+    return 0;
+}
+
+#endif /* HAVE_IO_URING */
+
+JNIEXPORT jboolean JNICALL
+Java_sun_nio_ch_IOUring_isAvailable(JNIEnv *env, jclass clazz)
+{
+#ifdef HAVE_IO_URING
+    struct io_uring_params p;
+    int fd;
+
+    memset(&p, 0, sizeof(p));
+    fd = io_uring_setup(2, &p);
+    if (fd < 0) {
+        return JNI_FALSE;
+    }
+    close(fd);
+    return is_supported(&p) ? JNI_TRUE : JNI_FALSE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_cqeSize(JNIEnv *env, jclass clazz)
+{
+#ifdef HAVE_IO_URING
+    return sizeof(struct io_uring_cqe);
+#else
+    return 0;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_cqeUserDataOffset(JNIEnv *env, jclass clazz)
+{
+#ifdef HAVE_IO_URING
+    return offsetof(struct io_uring_cqe, user_data);
+#else
+    return 0;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_cqeResultOffset(JNIEnv *env, jclass clazz)
+{
+#ifdef HAVE_IO_URING
+    return offsetof(struct io_uring_cqe, res);
+#else
+    return 0;
+#endif
+}
+
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_IOUring_create(JNIEnv *env, jclass clazz, jint entries)
+{
+#ifdef HAVE_IO_URING
+    struct io_uring_params p;
+    ring_t *ring = calloc(1, sizeof(ring_t));
+    if (ring == NULL) {
+        JNU_ThrowOutOfMemoryError(env, NULL);
+        return 0;
+    }
+    memset(&p, 0, sizeof(p));
+    ring->ring_fd = io_uring_setup((unsigned)entries, &p);
+    if (ring->ring_fd < 0) {
+        JNU_ThrowIOExceptionWithLastError(env, "io_uring_setup failed");
+        free(ring);
+        return 0;
+    }
+    if (!is_supported(&p)) {
+        JNU_ThrowByName(env, "java/lang/UnsupportedOperationException",
+                        "io_uring does not support IORING_FEAT_SUBMIT_STABLE");
+        close(ring->ring_fd);
+        free(ring);
+        return 0;
+    }
+    if (map_ring(ring, &p) != 0) {
+        JNU_ThrowIOExceptionWithLastError(env, "io_uring mmap failed");
+        unmap_ring(ring);
+        close(ring->ring_fd);
+        free(ring);
+        return 0;
+    }
+    return ptr_to_jlong(ring);
+#else
+    JNU_ThrowByName(env, "java/lang/UnsupportedOperationException", "io_uring not supported");
+    return 0;
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_sun_nio_ch_IOUring_close(JNIEnv *env, jclass clazz, jlong handle)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    unmap_ring(ring);
+    close(ring->ring_fd);
+    free(ring);
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_prepareRead(JNIEnv *env, jclass clazz, jlong handle,
+                                    jint fd, jlong address, jint len,
+                                    jlong offset, jint bufIndex, jlong userData)
+{
+#ifdef HAVE_IO_URING
+    return prepare_rw(jlong_to_ptr(handle), IORING_OP_READV, IORING_OP_READ_FIXED,
+                      fd, address, len, offset, bufIndex, userData);
+#else
+    return IOS_UNSUPPORTED;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_prepareWrite(JNIEnv *env, jclass clazz, jlong handle,
+                                     jint fd, jlong address, jint len,
+                                     jlong offset, jint bufIndex, jlong userData)
+{
+#ifdef HAVE_IO_URING
+    return prepare_rw(jlong_to_ptr(handle), IORING_OP_WRITEV, IORING_OP_WRITE_FIXED,
+                      fd, address, len, offset, bufIndex, userData);
+#else
+    return IOS_UNSUPPORTED;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_preparePoll(JNIEnv *env, jclass clazz, jlong handle,
+                                    jint fd, jint events, jlong userData)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    unsigned index;
+    struct io_uring_sqe *sqe = next_sqe(ring, &index);
+    if (sqe == NULL) {
+        return IOS_UNAVAILABLE;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll_events = (__u16)events;
+    sqe->user_data = (__u64)userData;
+    publish_sqe(ring, index);
+    return 0;
+#else
+    return IOS_UNSUPPORTED;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_prepareFsync(JNIEnv *env, jclass clazz, jlong handle,
+                                     jint fd, jboolean metaData, jlong userData)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    unsigned index;
+    struct io_uring_sqe *sqe = next_sqe(ring, &index);
+    if (sqe == NULL) {
+        return IOS_UNAVAILABLE;
+    }
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->fsync_flags = metaData ? 0 : IORING_FSYNC_DATASYNC;
+    sqe->user_data = (__u64)userData;
+    publish_sqe(ring, index);
+    return 0;
+#else
+    return IOS_UNSUPPORTED;
+#endif
+}
+
+/*
+ * Submits all prepared operations and, if minComplete > 0, waits until
+ * that many operations have completed. Returns the number of operations
+ * submitted.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_submit(JNIEnv *env, jclass clazz, jlong handle,
+                               jint minComplete)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    unsigned to_submit = *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned flags = (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0;
+    int res;
+
+    if (to_submit == 0 && minComplete <= 0) {
+        return 0;
+    }
+    res = io_uring_enter(ring->ring_fd, to_submit, (unsigned)minComplete, flags);
+    if (res < 0) {
+        if (errno == EINTR) {
+            return IOS_INTERRUPTED;
+        } else if (errno == EAGAIN || errno == EBUSY) {
+            /* completion queue is full, the caller must poll first */
+            return IOS_UNAVAILABLE;
+        } else {
+            JNU_ThrowIOExceptionWithLastError(env, "io_uring_enter failed");
+            return IOS_THROWN;
+        }
+    }
+    return res;
+#else
+    return IOS_UNSUPPORTED;
+#endif
+}
+
+/*
+ * Copies up to max completions to the array of struct io_uring_cqe at
+ * address and returns their number. Does not block.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_poll(JNIEnv *env, jclass clazz, jlong handle,
+                             jlong address, jint max)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    struct io_uring_cqe *cqes = jlong_to_ptr(address);
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    jint n = 0;
+
+    while (head != tail && n < max) {
+        cqes[n++] = ring->cqes[head & *ring->cq_mask];
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    return n;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Registers the buffers described by the array of count struct iovec at
+ * address, so that reads and writes into them can use a buffer index
+ * instead of pinning the pages for each operation.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_registerBuffers(JNIEnv *env, jclass clazz, jlong handle,
+                                        jlong address, jint count)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    int res = io_uring_register(ring->ring_fd, IORING_REGISTER_BUFFERS,
+                                jlong_to_ptr(address), (unsigned)count);
+    return (res == 0) ? 0 : errno;
+#else
+    return ENOSYS;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_unregisterBuffers(JNIEnv *env, jclass clazz, jlong handle)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    int res = io_uring_register(ring->ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+    return (res == 0) ? 0 : errno;
+#else
+    return ENOSYS;
+#endif
+}
+
+/*
+ * Registers an eventfd that is signalled on each completion, so that a
+ * thread blocked in epoll_wait can also wait for completions.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_IOUring_registerEventFd(JNIEnv *env, jclass clazz, jlong handle,
+                                        jint efd)
+{
+#ifdef HAVE_IO_URING
+    ring_t *ring = jlong_to_ptr(handle);
+    int fd = efd;
+    int res = io_uring_register(ring->ring_fd, IORING_REGISTER_EVENTFD, &fd, 1);
+    return (res == 0) ? 0 : errno;
+#else
+    return ENOSYS;
+#endif
+}
@@ -98,6 +98,7 @@
 #else /* Unix */
 #include <unistd.h>
 #include <dirent.h>
+#include <pthread.h>
 #endif /* Unix */
 
 #if defined(_AIX)
@@ -280,30 +281,122 @@ isWildcard(const char *filename)
         (! exists(filename));
 }
 
+/*
+ * Directories of different wildcards are listed in parallel, which helps
+ * most when they are on network file systems. The expansions are spliced
+ * into the class path in their original order.
+ */
+#define MAX_EXPANSION_THREADS 8
+
+typedef struct {
+    const char *wildcard;
+    JLI_List expanded;
+} WildcardExpansion;
+
+/* Expands every MAX_EXPANSION_THREADS-th wildcard starting at first */
+static void
+expandEvery(WildcardExpansion *expansions, size_t first, size_t count)
+{
+    size_t i;
+    for (i = first; i < count; i += MAX_EXPANSION_THREADS)
+        expansions[i].expanded = wildcardFileList(expansions[i].wildcard);
+}
+
+#ifndef _WIN32
+typedef struct {
+    WildcardExpansion *expansions;
+    size_t first;
+    size_t count;
+} ExpansionTask;
+
+static void *
+expandWildcardThread(void *arg)
+{
+    ExpansionTask *task = (ExpansionTask *) arg;
+    expandEvery(task->expansions, task->first, task->count);
+    return NULL;
+}
+#endif
+
+static void
+expandWildcards(WildcardExpansion *expansions, size_t count)
+{
+    size_t i, started = 0;
+#ifndef _WIN32
+    pthread_t threads[MAX_EXPANSION_THREADS];
+    ExpansionTask tasks[MAX_EXPANSION_THREADS];
+    if (count > 1) {
+        for (; started < count && started < MAX_EXPANSION_THREADS; started++) {
+            tasks[started].expansions = expansions;
+            tasks[started].first = started;
+            tasks[started].count = count;
+            if (pthread_create(&threads[started], NULL, expandWildcardThread,
+                               &tasks[started]) != 0)
+                break;
+        }
+    }
+    for (i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+#endif
+    /* The wildcards left to threads that were not started */
+    for (i = started; i < count && i < MAX_EXPANSION_THREADS; i++)
+        expandEvery(expansions, i, count);
+}
+
 static int
 FileList_expandWildcards(JLI_List fl)
 {
-    size_t i, j;
+    size_t i, j, count = 0;
     int expandedCnt = 0;
+    WildcardExpansion *expansions;
+    JLI_List result;
+
+    expansions = (WildcardExpansion *)
+        JLI_MemAlloc(fl->size * sizeof(WildcardExpansion));
     for (i = 0; i < fl->size; i++) {
         if (isWildcard(fl->elements[i])) {
-            JLI_List expanded = wildcardFileList(fl->elements[i]);
-            if (expanded != NULL && expanded->size > 0) {
-                expandedCnt++;
-                JLI_MemFree(fl->elements[i]);
-                JLI_List_ensureCapacity(fl, fl->size + expanded->size);
-                for (j = fl->size - 1; j >= i+1; j--)
-                    fl->elements[j+expanded->size-1] = fl->elements[j];
-                for (j = 0; j < expanded->size; j++)
-                    fl->elements[i+j] = expanded->elements[j];
-                i += expanded->size - 1;
-                fl->size += expanded->size - 1;
-                /* fl expropriates expanded's elements. */
-                expanded->size = 0;
-            }
-            JLI_List_free(expanded);
+            expansions[count].wildcard = fl->elements[i];
+            expansions[count].expanded = NULL;
+            count++;
+        }
+    }
+    if (count == 0) {
+        JLI_MemFree(expansions);
+        return 0;
+    }
+
+    expandWildcards(expansions, count);
+
+    result = JLI_List_new(fl->size);
+    for (i = 0, j = 0; i < fl->size; i++) {
+        JLI_List expanded;
+        if (j == count || fl->elements[i] != expansions[j].wildcard) {
+            JLI_List_add(result, fl->elements[i]);
+            continue;
+        }
+        expanded = expansions[j++].expanded;
+        if (expanded != NULL && expanded->size > 0) {
+            size_t k;
+            expandedCnt++;
+            JLI_MemFree(fl->elements[i]);
+            for (k = 0; k < expanded->size; k++)
+                JLI_List_add(result, expanded->elements[k]);
+            /* result expropriates expanded's elements. */
+            expanded->size = 0;
+        } else {
+            JLI_List_add(result, fl->elements[i]);
         }
+        JLI_List_free(expanded);
     }
+    JLI_MemFree(expansions);
+
+    /* fl expropriates result's elements. */
+    JLI_MemFree(fl->elements);
+    fl->elements = result->elements;
+    fl->size = result->size;
+    fl->capacity = result->capacity;
+    result->elements = NULL;
+    JLI_List_free(result);
     return expandedCnt;
 }
 
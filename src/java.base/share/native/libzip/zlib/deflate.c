@@ -1290,6 +1290,14 @@ local void lm_init(s)
 }
 
 #ifndef FASTEST
+
+/* On 64-bit little-endian targets compare the strings a word at a time. */
+#if !defined(UNALIGNED_OK) && defined(Z_U8) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__aarch64__)) && \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define LONGEST_MATCH_WORDS
+#endif
+
 /* ===========================================================================
  * Set match_start to the longest match starting at the given string and
  * return its length. Matches shorter or equal to prev_length are discarded,
@@ -1409,6 +1417,23 @@ local uInt longest_match(s, cur_match)
         scan += 2, match++;
         Assert(*scan == *match, "match[2]?");
 
+#ifdef LONGEST_MATCH_WORDS
+        /* Compare 8 bytes at a time and locate the first difference from
+         * the lowest set bit. This reads the same bytes as the loop below,
+         * up to strstart + 258, and finds the same length.
+         */
+        do {
+            Z_U8 scan_word, match_word, diff;
+            zmemcpy((Bytef *)&scan_word, scan + 1, 8);
+            zmemcpy((Bytef *)&match_word, match + 1, 8);
+            diff = scan_word ^ match_word;
+            if (diff != 0) {
+                scan += 1 + (__builtin_ctzll(diff) >> 3);
+                break;
+            }
+            scan += 8, match += 8;
+        } while (scan < strend);
+#else
         /* We check for insufficient lookahead only every 8th comparison;
          * the 256th check will be made at strstart + 258.
          */
@@ -1418,6 +1443,7 @@ local uInt longest_match(s, cur_match)
                  *++scan == *++match && *++scan == *++match &&
                  *++scan == *++match && *++scan == *++match &&
                  scan < strend);
+#endif
 
         Assert(scan <= s->window + (unsigned)(s->window_size - 1),
                "wild scan");
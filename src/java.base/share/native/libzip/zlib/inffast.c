@@ -274,6 +274,30 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 }
                 else {
                     from = out - dist;          /* copy direct from output */
+                    if (dist < 8 && len >= 16) {
+                        /* The match repeats every dist bytes, so once a few
+                           bytes are copied, it can be copied from a multiple
+                           of dist back that is at least 8 */
+                        op = (dist + 7) / dist * dist;
+                        len -= op - dist;
+                        do {
+                            *out++ = *from++;
+                        } while (++dist < op);
+                        from = out - dist;
+                    }
+                    if (dist >= 8) {            /* chunks cannot overlap */
+                        while (len >= 8) {
+                            zmemcpy(out, from, 8);
+                            out += 8;
+                            from += 8;
+                            len -= 8;
+                        }
+                        while (len) {
+                            *out++ = *from++;
+                            len--;
+                        }
+                        continue;
+                    }
                     do {                        /* minimum length is three */
                         *out++ = *from++;
                         *out++ = *from++;
@@ -30,6 +30,7 @@
 /* @(#) $Id$ */
 
 #include "zutil.h"
+#include "zsimd.h"
 
 local uLong adler32_combine_ OF((uLong adler1, uLong adler2, z_off64_t len2));
 
@@ -111,6 +112,11 @@ uLong ZEXPORT adler32_z(adler, buf, len)
     if (buf == Z_NULL)
         return 1L;
 
+#ifdef ZSIMD_X86
+    if (len >= ZSIMD_ADLER32_MIN_LEN && zsimd_has_ssse3())
+        return adler32_ssse3(adler | (sum2 << 16), buf, len);
+#endif
+
     /* in case short lengths are provided, keep it somewhat fast */
     if (len < 16) {
         while (len--) {
@@ -52,6 +52,7 @@
 #endif /* MAKECRCH */
 
 #include "zutil.h"      /* for Z_U4, Z_U8, z_crc_t, and FAR definitions */
+#include "zsimd.h"      /* for crc32_pclmul */
 
  /*
   A CRC of a message is computed on N braids of words in the message, where
@@ -784,6 +785,19 @@ unsigned long ZEXPORT crc32_z(crc, buf, len)
     /* Pre-condition the CRC */
     crc = (~crc) & 0xffffffff;
 
+#ifdef ZSIMD_X86
+
+    /* Fold whole 16-byte blocks with carry-less multiplication, leaving less
+       than 16 bytes to the code below. */
+    if (len >= ZSIMD_CRC32_MIN_LEN && zsimd_has_pclmul()) {
+        z_size_t blocks = len & ~(z_size_t)15;
+        crc = crc32_pclmul((z_crc_t)crc, buf, blocks);
+        buf += blocks;
+        len -= blocks;
+    }
+
+#endif
+
 #ifdef W
 
     /* If provided enough bytes, do a braided CRC calculation. */
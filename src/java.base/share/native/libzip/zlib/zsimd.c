@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+/* zsimd.c -- x86-64 vector versions of the CRC-32 and Adler-32 checksums
+ *
+ * The CRC-32 folding follows "Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ Instruction" by Gopal et al. (Intel, 2009), with the
+ * constants for the bit-reflected zlib polynomial given at its end.
+ */
+
+#include "zsimd.h"
+
+#ifdef ZSIMD_X86
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#define ZSIMD_UNKNOWN (-1)
+
+local int has_pclmul = ZSIMD_UNKNOWN;
+local int has_ssse3 = ZSIMD_UNKNOWN;
+
+/* Races only store the same values twice. */
+local void zsimd_detect()
+{
+    unsigned eax, ebx, ecx, edx;
+    int pclmul = 0, ssse3 = 0;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        ssse3 = (ecx & bit_SSSE3) != 0;
+        pclmul = ssse3 && (ecx & bit_SSE4_1) != 0 && (ecx & bit_PCLMUL) != 0;
+    }
+    has_ssse3 = ssse3;
+    has_pclmul = pclmul;
+}
+
+int ZLIB_INTERNAL zsimd_has_pclmul()
+{
+    if (has_pclmul == ZSIMD_UNKNOWN)
+        zsimd_detect();
+    return has_pclmul;
+}
+
+int ZLIB_INTERNAL zsimd_has_ssse3()
+{
+    if (has_ssse3 == ZSIMD_UNKNOWN)
+        zsimd_detect();
+    return has_ssse3;
+}
+
+/* ========================================================================= */
+__attribute__((target("sse4.1,pclmul")))
+z_crc_t ZLIB_INTERNAL crc32_pclmul(z_crc_t crc, const unsigned char FAR *buf,
+                                   z_size_t len)
+{
+    static const Z_U8 k1k2[2] __attribute__((aligned(16))) =
+        { 0x0154442bd4, 0x01c6e41596 };
+    static const Z_U8 k3k4[2] __attribute__((aligned(16))) =
+        { 0x01751997d0, 0x00ccaa009e };
+    static const Z_U8 k5k0[2] __attribute__((aligned(16))) =
+        { 0x0163cd6124, 0x0000000000 };
+    static const Z_U8 poly[2] __attribute__((aligned(16))) =
+        { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    /* Load the first 64 bytes into four accumulators. */
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    buf += 64;
+    len -= 64;
+
+    /* Fold four 16-byte lanes in parallel. */
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        buf += 64;
+        len -= 64;
+    }
+
+    /* Fold the four lanes into one. */
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* Fold any remaining 16-byte blocks. */
+    while (len >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)buf);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        buf += 16;
+        len -= 16;
+    }
+
+    /* Fold 128 bits to 64 bits. */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits. */
+    x0 = _mm_load_si128((const __m128i *)poly);
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (z_crc_t)_mm_extract_epi32(x1, 1);
+}
+
+/* ========================================================================= */
+#define BASE 65521U     /* largest prime smaller than 65536 */
+#define NMAX 5552       /* see adler32.c */
+#define BLOCK 32        /* bytes summed per iteration */
+
+__attribute__((target("ssse3")))
+uLong ZLIB_INTERNAL adler32_ssse3(uLong adler, const Bytef *buf, z_size_t len)
+{
+    /* Weights of the bytes of a block in the second sum, the first byte
+       being added to it the most often. */
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                       24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                                       8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    unsigned s1 = (unsigned)(adler & 0xffff);
+    unsigned s2 = (unsigned)((adler >> 16) & 0xffff);
+    z_size_t blocks = len / BLOCK;
+
+    len -= blocks * BLOCK;
+    while (blocks) {
+        /* As many blocks as can be summed before a modulo is needed. */
+        unsigned n = blocks < NMAX / BLOCK ? (unsigned)blocks : NMAX / BLOCK;
+        __m128i v_ps = _mm_setr_epi32((int)(s1 * n), 0, 0, 0);
+        __m128i v_s2 = _mm_setr_epi32((int)s2, 0, 0, 0);
+        __m128i v_s1 = zero;
+        __m128i sum;
+
+        blocks -= n;
+        do {
+            const __m128i bytes1 = _mm_loadu_si128((const __m128i *)buf);
+            const __m128i bytes2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+
+            /* Every earlier block adds its bytes BLOCK times more. */
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            buf += BLOCK;
+        } while (--n);
+
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        /* Add up the lanes. */
+        sum = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4e));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+        s1 += (unsigned)_mm_cvtsi128_si32(sum);
+        sum = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4e));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+        s2 = (unsigned)_mm_cvtsi128_si32(sum);
+
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+
+    /* Sum the last bytes one at a time. */
+    while (len--) {
+        s1 += *buf++;
+        s2 += s1;
+    }
+    s1 %= BASE;
+    s2 %= BASE;
+
+    return (uLong)s1 | ((uLong)s2 << 16);
+}
+
+#endif /* ZSIMD_X86 */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+/* zsimd.h -- x86-64 vector versions of the CRC-32 and Adler-32 checksums
+ *
+ * The functions are compiled for SSSE3, SSE4.1 and PCLMULQDQ with target
+ * attributes, so the rest of zlib keeps its baseline instruction set.
+ * Callers must check zsimd_has_pclmul() or zsimd_has_ssse3() first. Both
+ * return the same checksums as the portable code.
+ */
+
+#ifndef ZSIMD_H
+#define ZSIMD_H
+
+#include "zutil.h"
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(NO_ZSIMD)
+#  define ZSIMD_X86
+#endif
+
+#ifdef ZSIMD_X86
+
+/* CRC-32 is folded 64 bytes at a time, so shorter buffers are left to the
+   braided code. */
+#define ZSIMD_CRC32_MIN_LEN 64
+
+/* Adler-32 is summed 32 bytes at a time. */
+#define ZSIMD_ADLER32_MIN_LEN 64
+
+int ZLIB_INTERNAL zsimd_has_pclmul OF((void));
+int ZLIB_INTERNAL zsimd_has_ssse3 OF((void));
+
+/* Continues the CRC of len bytes, where len is at least ZSIMD_CRC32_MIN_LEN
+   and a multiple of 16. Like the inner loops of crc32_z(), it works on the
+   inverted CRC. */
+z_crc_t ZLIB_INTERNAL crc32_pclmul OF((z_crc_t crc, const unsigned char FAR *buf,
+                                       z_size_t len));
+
+/* Returns the Adler-32 of buf updated from adler, for any len. */
+uLong ZLIB_INTERNAL adler32_ssse3 OF((uLong adler, const Bytef *buf,
+                                      z_size_t len));
+
+#endif /* ZSIMD_X86 */
+
+#endif /* ZSIMD_H */
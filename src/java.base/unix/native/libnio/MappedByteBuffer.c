@@ -30,6 +30,7 @@
 #include "java_nio_MappedByteBuffer.h"
 #include <assert.h>
 #include <sys/mman.h>
+#include <errno.h>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -115,6 +116,59 @@ Java_java_nio_MappedByteBuffer_load0(JNIEnv *env, jobject obj, jlong address,
 }
 
 
+/*
+ * The advice of advise0. The values must match the ADVICE_* constants in
+ * java.nio.MappedByteBuffer.
+ */
+#define ADVICE_NORMAL       0
+#define ADVICE_RANDOM       1
+#define ADVICE_SEQUENTIAL   2
+#define ADVICE_WILLNEED     3
+#define ADVICE_HUGEPAGE     4
+
+/*
+ * Tells the kernel how a range of the mapping will be used. WILLNEED starts
+ * reading the range in asynchronously, unlike load() which also touches
+ * every page. Advice that the platform does not support is ignored.
+ */
+JNIEXPORT void JNICALL
+Java_java_nio_MappedByteBuffer_advise0(JNIEnv *env, jobject obj, jlong address,
+                                       jlong len, jint advice)
+{
+    char *a = (char *)jlong_to_ptr(address);
+    int result = 0;
+
+    switch (advice) {
+    case ADVICE_NORMAL:
+        result = madvise((caddr_t)a, (size_t)len, MADV_NORMAL);
+        break;
+    case ADVICE_RANDOM:
+        result = madvise((caddr_t)a, (size_t)len, MADV_RANDOM);
+        break;
+    case ADVICE_SEQUENTIAL:
+        result = madvise((caddr_t)a, (size_t)len, MADV_SEQUENTIAL);
+        break;
+    case ADVICE_WILLNEED:
+        result = madvise((caddr_t)a, (size_t)len, MADV_WILLNEED);
+        break;
+    case ADVICE_HUGEPAGE:
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        /* Only some file systems back file mappings with huge pages */
+        result = madvise((caddr_t)a, (size_t)len, MADV_HUGEPAGE);
+        if (result == -1 && errno == EINVAL) {
+            result = 0;
+        }
+#endif
+        break;
+    default:
+        break;
+    }
+    if (result == -1) {
+        JNU_ThrowIOExceptionWithLastError(env, "madvise failed");
+    }
+}
+
+
 JNIEXPORT void JNICALL
 Java_java_nio_MappedByteBuffer_force0(JNIEnv *env, jobject obj, jobject fdo,
                                       jlong address, jlong len)
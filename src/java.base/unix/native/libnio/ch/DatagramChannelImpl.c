@@ -39,6 +39,16 @@
 #include <netinet/in.h>
 #endif
 
+#if defined(__linux__)
+#include <netinet/udp.h>
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
 #include "net_util.h"
 #include "net_util_md.h"
 #include "nio.h"
@@ -52,6 +62,9 @@ static jfieldID dci_senderPortID; /* sender port in sun.nio.ch.DatagramChannelIm
 static jclass isa_class;        /* java.net.InetSocketAddress */
 static jmethodID isa_ctorID;    /*   .InetSocketAddress(InetAddress, int) */
 
+/* The most datagrams received or sent by one receiveBatch0 or sendBatch0 */
+#define MAX_DATAGRAM_BATCH 64
+
 JNIEXPORT void JNICALL
 Java_sun_nio_ch_DatagramChannelImpl_initIDs(JNIEnv *env, jclass clazz)
 {
@@ -231,3 +244,218 @@ Java_sun_nio_ch_DatagramChannelImpl_send0(JNIEnv *env, jobject this,
     }
     return n;
 }
+
+#if defined(__linux__)
+
+/*
+ * Creates the InetSocketAddress for the sender of a datagram, or returns
+ * prev if the datagram came from the same address as the one before it.
+ */
+static jobject
+senderAddress(JNIEnv *env, SOCKETADDRESS *sa, socklen_t sa_len,
+              SOCKETADDRESS *prev_sa, socklen_t prev_len, jobject prev)
+{
+    jobject ia, isa;
+    int port = 0;
+
+    if (prev != NULL && sa_len == prev_len && memcmp(sa, prev_sa, sa_len) == 0) {
+        return prev;
+    }
+    ia = NET_SockaddrToInetAddress(env, sa, &port);
+    CHECK_NULL_RETURN(ia, NULL);
+    isa = (*env)->NewObject(env, isa_class, isa_ctorID, ia, port);
+    (*env)->DeleteLocalRef(env, ia);
+    return isa;
+}
+
+#endif
+
+/*
+ * Receives up to count datagrams with a single recvmmsg call. Datagram i
+ * is read into the buffer at addresses[i] of lengths[i] bytes, lengths[i]
+ * is replaced by the number of bytes received and, if senders is not null,
+ * senders[i] is set to the sender's InetSocketAddress. Returns the number
+ * of datagrams received. The call blocks only until the first datagram
+ * arrives if the socket is in blocking mode.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_DatagramChannelImpl_receiveBatch0(JNIEnv *env, jobject this,
+                                                  jobject fdo, jlongArray addresses,
+                                                  jintArray lengths, jint count,
+                                                  jobjectArray senders,
+                                                  jboolean connected)
+{
+#if defined(__linux__)
+    jint fd = fdval(env, fdo);
+    struct mmsghdr msgs[MAX_DATAGRAM_BATCH];
+    struct iovec iovs[MAX_DATAGRAM_BATCH];
+    SOCKETADDRESS sas[MAX_DATAGRAM_BATCH];
+    jlong addrs[MAX_DATAGRAM_BATCH];
+    jint lens[MAX_DATAGRAM_BATCH];
+    jobject prev = NULL;
+    jboolean retry;
+    int i, n;
+
+    if (count > MAX_DATAGRAM_BATCH) {
+        count = MAX_DATAGRAM_BATCH;
+    }
+    (*env)->GetLongArrayRegion(env, addresses, 0, count, addrs);
+    (*env)->GetIntArrayRegion(env, lengths, 0, count, lens);
+    if ((*env)->ExceptionCheck(env)) {
+        return IOS_THROWN;
+    }
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (i = 0; i < count; i++) {
+        iovs[i].iov_base = jlong_to_ptr(addrs[i]);
+        iovs[i].iov_len = lens[i] > MAX_PACKET_LEN ? MAX_PACKET_LEN : lens[i];
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &sas[i].sa;
+        msgs[i].msg_hdr.msg_namelen = sizeof(SOCKETADDRESS);
+    }
+
+    do {
+        retry = JNI_FALSE;
+        n = recvmmsg(fd, msgs, count, MSG_WAITFORONE, NULL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return IOS_UNAVAILABLE;
+            }
+            if (errno == EINTR) {
+                return IOS_INTERRUPTED;
+            }
+            if (errno == ECONNREFUSED) {
+                if (connected == JNI_FALSE) {
+                    retry = JNI_TRUE;
+                } else {
+                    JNU_ThrowByName(env, JNU_JAVANETPKG
+                                    "PortUnreachableException", 0);
+                    return IOS_THROWN;
+                }
+            } else {
+                return handleSocketError(env, errno);
+            }
+        }
+    } while (retry == JNI_TRUE);
+
+    for (i = 0; i < n; i++) {
+        lens[i] = (jint)msgs[i].msg_len;
+        if (senders != NULL) {
+            jobject isa = (i == 0) ? senderAddress(env, &sas[i], msgs[i].msg_hdr.msg_namelen,
+                                                   NULL, 0, NULL)
+                                   : senderAddress(env, &sas[i], msgs[i].msg_hdr.msg_namelen,
+                                                   &sas[i - 1], msgs[i - 1].msg_hdr.msg_namelen,
+                                                   prev);
+            CHECK_NULL_RETURN(isa, IOS_THROWN);
+            (*env)->SetObjectArrayElement(env, senders, i, isa);
+            if (isa != prev && prev != NULL) {
+                (*env)->DeleteLocalRef(env, prev);
+            }
+            prev = isa;
+        }
+    }
+    (*env)->SetIntArrayRegion(env, lengths, 0, n, lens);
+    return n;
+#else
+    return IOS_UNSUPPORTED_CASE;
+#endif
+}
+
+/*
+ * Sends up to count datagrams with a single sendmmsg call. Datagram i is
+ * the lengths[i] bytes at addresses[i], sent to destAddresses[i] and
+ * destPorts[i], or to the connected peer if destAddresses is null. If
+ * segmentSize is positive each buffer is handed to the kernel as one
+ * message that it splits into datagrams of segmentSize bytes (UDP GSO).
+ * Returns the number of buffers sent.
+ */
+JNIEXPORT jint JNICALL
+Java_sun_nio_ch_DatagramChannelImpl_sendBatch0(JNIEnv *env, jobject this,
+                                               jboolean preferIPv6, jobject fdo,
+                                               jlongArray addresses, jintArray lengths,
+                                               jint count, jobjectArray destAddresses,
+                                               jintArray destPorts, jint segmentSize)
+{
+#if defined(__linux__)
+    jint fd = fdval(env, fdo);
+    struct mmsghdr msgs[MAX_DATAGRAM_BATCH];
+    struct iovec iovs[MAX_DATAGRAM_BATCH];
+    SOCKETADDRESS sas[MAX_DATAGRAM_BATCH];
+    jlong addrs[MAX_DATAGRAM_BATCH];
+    jint lens[MAX_DATAGRAM_BATCH];
+    jint ports[MAX_DATAGRAM_BATCH];
+    union {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr align;
+    } control;
+    int i, n;
+
+    if (count > MAX_DATAGRAM_BATCH) {
+        count = MAX_DATAGRAM_BATCH;
+    }
+    (*env)->GetLongArrayRegion(env, addresses, 0, count, addrs);
+    (*env)->GetIntArrayRegion(env, lengths, 0, count, lens);
+    if (destAddresses != NULL) {
+        (*env)->GetIntArrayRegion(env, destPorts, 0, count, ports);
+    }
+    if ((*env)->ExceptionCheck(env)) {
+        return IOS_THROWN;
+    }
+
+    if (segmentSize > 0) {
+        /* The same control message is shared by all messages */
+        struct cmsghdr *cm = (struct cmsghdr *)control.buf;
+        memset(&control, 0, sizeof(control));
+        cm->cmsg_level = SOL_UDP;
+        cm->cmsg_type = UDP_SEGMENT;
+        cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        *((uint16_t *)CMSG_DATA(cm)) = (uint16_t)segmentSize;
+    }
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (i = 0; i < count; i++) {
+        iovs[i].iov_base = jlong_to_ptr(addrs[i]);
+        iovs[i].iov_len = lens[i];
+        if (segmentSize <= 0 && iovs[i].iov_len > MAX_PACKET_LEN) {
+            iovs[i].iov_len = MAX_PACKET_LEN;
+        }
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (destAddresses != NULL) {
+            int sa_len = 0;
+            jobject ia = (*env)->GetObjectArrayElement(env, destAddresses, i);
+            CHECK_NULL_RETURN(ia, IOS_THROWN);
+            if (NET_InetAddressToSockaddr(env, ia, ports[i], &sas[i],
+                                          &sa_len, preferIPv6) != 0) {
+                return IOS_THROWN;
+            }
+            (*env)->DeleteLocalRef(env, ia);
+            msgs[i].msg_hdr.msg_name = &sas[i].sa;
+            msgs[i].msg_hdr.msg_namelen = sa_len;
+        }
+        if (segmentSize > 0) {
+            msgs[i].msg_hdr.msg_control = control.buf;
+            msgs[i].msg_hdr.msg_controllen = sizeof(control.buf);
+        }
+    }
+
+    n = sendmmsg(fd, msgs, count, 0);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return IOS_UNAVAILABLE;
+        }
+        if (errno == EINTR) {
+            return IOS_INTERRUPTED;
+        }
+        if (errno == ECONNREFUSED) {
+            JNU_ThrowByName(env, JNU_JAVANETPKG "PortUnreachableException", 0);
+            return IOS_THROWN;
+        }
+        return handleSocketError(env, errno);
+    }
+    return n;
+#else
+    return IOS_UNSUPPORTED_CASE;
+#endif
+}
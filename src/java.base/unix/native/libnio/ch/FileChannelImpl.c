@@ -29,7 +29,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-#if defined(__linux__) || defined(__solaris__)
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#elif defined(__solaris__)
 #include <sys/sendfile.h>
 #elif defined(_AIX)
 #include <sys/socket.h>
@@ -111,6 +114,107 @@ Java_sun_nio_ch_FileChannelImpl_map0(JNIEnv *env, jobject this,
 }
 
 
+/*
+ * The options of map1, a bitmask. The values must match the MAP_OPT_*
+ * constants in sun.nio.ch.FileChannelImpl.
+ */
+#define MAP_OPT_PREFAULT    0x01
+#define MAP_OPT_HUGEPAGE    0x02
+#define MAP_OPT_RANDOM      0x04
+#define MAP_OPT_SEQUENTIAL  0x08
+#define MAP_OPT_LOCK        0x10
+
+/*
+ * Applies the hints among the map options to a new mapping. Hints that the
+ * platform or the file system does not support are ignored.
+ */
+static void
+adviseMapping(void *mapAddress, jlong len, jint options)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (options & MAP_OPT_HUGEPAGE) {
+        madvise(mapAddress, (size_t)len, MADV_HUGEPAGE);
+    }
+#endif
+    if (options & MAP_OPT_RANDOM) {
+        madvise(mapAddress, (size_t)len, MADV_RANDOM);
+    } else if (options & MAP_OPT_SEQUENTIAL) {
+        madvise(mapAddress, (size_t)len, MADV_SEQUENTIAL);
+    }
+#if !defined(__linux__)
+    /* Without MAP_POPULATE, start reading the file in ahead of use */
+    if (options & MAP_OPT_PREFAULT) {
+        madvise(mapAddress, (size_t)len, MADV_WILLNEED);
+    }
+#endif
+}
+
+/*
+ * Same as map0, and applies the MAP_OPT_* options to the mapping.
+ */
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_FileChannelImpl_map1(JNIEnv *env, jobject this,
+                                     jint prot, jlong off, jlong len,
+                                     jint options)
+{
+    void *mapAddress = 0;
+    jobject fdo = (*env)->GetObjectField(env, this, chan_fd);
+    jint fd = fdval(env, fdo);
+    int protections = 0;
+    int flags = 0;
+
+    if (prot == sun_nio_ch_FileChannelImpl_MAP_RO) {
+        protections = PROT_READ;
+        flags = MAP_SHARED;
+    } else if (prot == sun_nio_ch_FileChannelImpl_MAP_RW) {
+        protections = PROT_WRITE | PROT_READ;
+        flags = MAP_SHARED;
+    } else if (prot == sun_nio_ch_FileChannelImpl_MAP_PV) {
+        protections =  PROT_WRITE | PROT_READ;
+        flags = MAP_PRIVATE;
+    }
+
+#if defined(__linux__)
+    /* Read the file in and set up the page tables before returning, so
+     * that first accesses do not fault */
+    if (options & MAP_OPT_PREFAULT) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+
+    mapAddress = mmap64(
+        0,                    /* Let OS decide location */
+        len,                  /* Number of bytes to map */
+        protections,          /* File permissions */
+        flags,                /* Changes are shared */
+        fd,                   /* File descriptor of mapped file */
+        off);                 /* Offset into file */
+
+    if (mapAddress == MAP_FAILED) {
+        if (errno == ENOMEM) {
+            JNU_ThrowOutOfMemoryError(env, "Map failed");
+            return IOS_THROWN;
+        }
+        return handle(env, -1, "Map failed");
+    }
+
+    adviseMapping(mapAddress, len, options);
+
+    if ((options & MAP_OPT_LOCK) && mlock(mapAddress, (size_t)len) != 0) {
+        int errsv = errno;
+        munmap(mapAddress, (size_t)len);
+        errno = errsv;
+        if (errno == ENOMEM || errno == EAGAIN) {
+            JNU_ThrowOutOfMemoryError(env, "Map failed: cannot lock mapping");
+            return IOS_THROWN;
+        }
+        return handle(env, -1, "Map failed: mlock");
+    }
+
+    return ((jlong) (unsigned long) mapAddress);
+}
+
+
 JNIEXPORT jint JNICALL
 Java_sun_nio_ch_FileChannelImpl_unmap0(JNIEnv *env, jobject this,
                                        jlong address, jlong len)
@@ -132,7 +236,30 @@ Java_sun_nio_ch_FileChannelImpl_transferTo0(JNIEnv *env, jobject this,
 
 #if defined(__linux__)
     off64_t offset = (off64_t)position;
-    jlong n = sendfile64(dstFD, srcFD, &offset, (size_t)count);
+    jlong n;
+#if defined(__NR_copy_file_range)
+    struct stat64 sb;
+    if (fstat64(dstFD, &sb) == 0 && S_ISREG(sb.st_mode)) {
+        /*
+         * Between regular files copy_file_range lets the file system share
+         * blocks (reflink) or copy them without going through the page
+         * cache of both files. It fails if the kernel or the file systems
+         * do not support it, in which case sendfile is used.
+         */
+        n = syscall(__NR_copy_file_range, srcFD, &offset, dstFD, NULL, (size_t)count, 0);
+        if (n > 0)
+            return n;
+        if (n < 0 && errno == EINTR)
+            return IOS_INTERRUPTED;
+        /*
+         * copy_file_range also returns 0 for files in pseudo file systems
+         * such as procfs, which report a size of 0, so a count of 0 is not
+         * taken as the end of the file. sendfile reads those files.
+         */
+        offset = (off64_t)position;
+    }
+#endif
+    n = sendfile64(dstFD, srcFD, &offset, (size_t)count);
     if (n < 0) {
         if (errno == EAGAIN)
             return IOS_UNAVAILABLE;
@@ -245,3 +372,95 @@ Java_sun_nio_ch_FileChannelImpl_transferTo0(JNIEnv *env, jobject this,
 #endif
 }
 
+#if defined(__linux__)
+/* Pipe capacity asked for when splicing, the kernel default is 64 KB */
+#define SPLICE_PIPE_SIZE (1024 * 1024)
+
+static void
+close_pipe(int pipefd[2])
+{
+    close(pipefd[0]);
+    close(pipefd[1]);
+}
+#endif
+
+/*
+ * Transfers up to count bytes from srcFDO, typically a socket or a pipe, to
+ * position in the file dstFDO. On Linux the bytes are spliced through a
+ * pipe, so they are never copied to user space.
+ */
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_FileChannelImpl_transferFrom0(JNIEnv *env, jobject this,
+                                              jobject srcFDO,
+                                              jlong position, jlong count,
+                                              jobject dstFDO)
+{
+#if defined(__linux__)
+    jint srcFD = fdval(env, srcFDO);
+    jint dstFD = fdval(env, dstFDO);
+    loff_t offset = (loff_t)position;
+    jlong transferred = 0;
+    size_t chunk = 64 * 1024;
+    int pipefd[2];
+
+    if (pipe2(pipefd, O_CLOEXEC) != 0)
+        return IOS_UNSUPPORTED_CASE;
+#ifdef F_SETPIPE_SZ
+    {
+        int size = fcntl(pipefd[1], F_SETPIPE_SZ, SPLICE_PIPE_SIZE);
+        if (size > 0)
+            chunk = (size_t)size;
+    }
+#endif
+
+    while (transferred < count) {
+        size_t len = (count - transferred < (jlong)chunk) ?
+            (size_t)(count - transferred) : chunk;
+        ssize_t n = splice(srcFD, NULL, pipefd[1], NULL, len,
+                           SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (n == 0)
+            break;
+        if (n < 0) {
+            int err = errno;
+            close_pipe(pipefd);
+            if (transferred > 0)
+                return transferred;
+            if (err == EAGAIN)
+                return IOS_UNAVAILABLE;
+            if (err == EINTR)
+                return IOS_INTERRUPTED;
+            if (err == EINVAL)
+                return IOS_UNSUPPORTED_CASE;
+            errno = err;
+            JNU_ThrowIOExceptionWithLastError(env, "Transfer failed");
+            return IOS_THROWN;
+        }
+        /* Drain the pipe completely, the bytes in it are already consumed */
+        while (n > 0) {
+            ssize_t m = splice(pipefd[0], NULL, dstFD, &offset, (size_t)n,
+                               SPLICE_F_MOVE);
+            if (m < 0 && errno == EINTR)
+                continue;
+            if (m == 0) {
+                /* nothing more can be written, report what was */
+                close_pipe(pipefd);
+                return transferred;
+            }
+            if (m < 0) {
+                int err = errno;
+                close_pipe(pipefd);
+                errno = err;
+                JNU_ThrowIOExceptionWithLastError(env,
+                    "Transfer failed, bytes read from the source could not be written");
+                return IOS_THROWN;
+            }
+            n -= m;
+            transferred += m;
+        }
+    }
+    close_pipe(pipefd);
+    return transferred;
+#else
+    return IOS_UNSUPPORTED_CASE;
+#endif
+}
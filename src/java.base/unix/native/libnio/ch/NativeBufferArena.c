@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * A native arena for the temporary direct buffers that sun.nio.ch.Util
+ * uses as bounce buffers for I/O with heap buffers.
+ *
+ * Buffers are rounded up to a power of two between 4K and 1M and mapped
+ * directly with mmap, so that they do not go through malloc. A freed buffer
+ * is kept for reuse: first in a small magazine of the CPU the freeing
+ * thread runs on, then in a shared depot. Threads that do I/O on the same
+ * CPU therefore reuse each other's buffers without sharing a lock with
+ * the rest of the process. The memory mapped by the arena is bounded;
+ * requests beyond the bound, or larger than 1M, return 0 and the caller
+ * falls back to Unsafe.allocateMemory.
+ */
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "jni.h"
+#include "jni_util.h"
+#include "jvm.h"
+#include "jlong.h"
+
+#ifdef __linux__
+  #include <sched.h>
+#endif
+
+#ifndef MAP_ANONYMOUS
+  #define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define MIN_SHIFT       12      /* smallest buffer, 4K */
+#define MAX_SHIFT       20      /* largest buffer, 1M */
+#define NUM_CLASSES     (MAX_SHIFT - MIN_SHIFT + 1)
+#define MAGAZINE_SIZE   8       /* buffers of a size class per magazine */
+#define NUM_MAGAZINES   64
+
+/* Free buffers of the depot are linked through their first word */
+typedef struct freeBuffer {
+    struct freeBuffer *next;
+} freeBuffer;
+
+typedef struct {
+    pthread_mutex_t lock;
+    int count[NUM_CLASSES];
+    void *buffers[NUM_CLASSES][MAGAZINE_SIZE];
+    /* Buffers handed out and their bytes, net of those freed here */
+    jlong allocated;
+    jlong allocatedBytes;
+} magazine;
+
+static magazine magazines[NUM_MAGAZINES];
+
+static struct {
+    pthread_mutex_t lock;
+    freeBuffer *buffers[NUM_CLASSES];
+    jlong mappedBytes;
+} depot;
+
+static jlong maxMappedBytes;
+
+static int
+sizeClass(jint size)
+{
+    int shift = MIN_SHIFT;
+    while (shift <= MAX_SHIFT && ((jint)1 << shift) < size) {
+        shift++;
+    }
+    return shift - MIN_SHIFT;
+}
+
+static magazine *
+currentMagazine(void)
+{
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return &magazines[cpu % NUM_MAGAZINES];
+    }
+#endif
+    return &magazines[((size_t)pthread_self() >> 4) % NUM_MAGAZINES];
+}
+
+static void *
+mapBuffer(int cls)
+{
+    size_t size = (size_t)1 << (cls + MIN_SHIFT);
+    void *addr;
+
+    pthread_mutex_lock(&depot.lock);
+    if (depot.mappedBytes + (jlong)size > maxMappedBytes) {
+        pthread_mutex_unlock(&depot.lock);
+        return NULL;
+    }
+    depot.mappedBytes += size;
+    pthread_mutex_unlock(&depot.lock);
+
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        pthread_mutex_lock(&depot.lock);
+        depot.mappedBytes -= size;
+        pthread_mutex_unlock(&depot.lock);
+        return NULL;
+    }
+    return addr;
+}
+
+static void
+unmapBuffer(void *addr, int cls)
+{
+    size_t size = (size_t)1 << (cls + MIN_SHIFT);
+
+    munmap(addr, size);
+    pthread_mutex_lock(&depot.lock);
+    depot.mappedBytes -= size;
+    pthread_mutex_unlock(&depot.lock);
+}
+
+JNIEXPORT void JNICALL
+Java_sun_nio_ch_NativeBufferArena_init0(JNIEnv *env, jclass cl, jlong maxBytes)
+{
+    int i;
+    pthread_mutex_init(&depot.lock, NULL);
+    for (i = 0; i < NUM_MAGAZINES; i++) {
+        pthread_mutex_init(&magazines[i].lock, NULL);
+    }
+    maxMappedBytes = maxBytes;
+}
+
+/*
+ * Returns the address of a buffer of at least size bytes, or 0 if the
+ * arena cannot provide one.
+ */
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_NativeBufferArena_allocate0(JNIEnv *env, jclass cl, jint size)
+{
+    magazine *m;
+    void *addr = NULL;
+    int cls;
+
+    if (size <= 0 || size > (1 << MAX_SHIFT)) {
+        return 0;
+    }
+    cls = sizeClass(size);
+    m = currentMagazine();
+
+    pthread_mutex_lock(&m->lock);
+    if (m->count[cls] > 0) {
+        addr = m->buffers[cls][--m->count[cls]];
+    }
+    pthread_mutex_unlock(&m->lock);
+
+    if (addr == NULL) {
+        pthread_mutex_lock(&depot.lock);
+        if (depot.buffers[cls] != NULL) {
+            freeBuffer *fb = depot.buffers[cls];
+            depot.buffers[cls] = fb->next;
+            addr = fb;
+        }
+        pthread_mutex_unlock(&depot.lock);
+    }
+    if (addr == NULL) {
+        addr = mapBuffer(cls);
+        if (addr == NULL) {
+            return 0;
+        }
+    }
+
+    pthread_mutex_lock(&m->lock);
+    m->allocated++;
+    m->allocatedBytes += (jlong)1 << (cls + MIN_SHIFT);
+    pthread_mutex_unlock(&m->lock);
+    return ptr_to_jlong(addr);
+}
+
+/*
+ * Returns a buffer obtained from allocate0 with the same size.
+ */
+JNIEXPORT void JNICALL
+Java_sun_nio_ch_NativeBufferArena_free0(JNIEnv *env, jclass cl,
+                                        jlong address, jint size)
+{
+    void *addr = jlong_to_ptr(address);
+    int cls = sizeClass(size);
+    magazine *m = currentMagazine();
+    jboolean cached = JNI_FALSE;
+
+    pthread_mutex_lock(&m->lock);
+    m->allocated--;
+    m->allocatedBytes -= (jlong)1 << (cls + MIN_SHIFT);
+    if (m->count[cls] < MAGAZINE_SIZE) {
+        m->buffers[cls][m->count[cls]++] = addr;
+        cached = JNI_TRUE;
+    }
+    pthread_mutex_unlock(&m->lock);
+
+    if (!cached) {
+        freeBuffer *fb = (freeBuffer *)addr;
+        pthread_mutex_lock(&depot.lock);
+        fb->next = depot.buffers[cls];
+        depot.buffers[cls] = fb;
+        pthread_mutex_unlock(&depot.lock);
+    }
+}
+
+/*
+ * Unmaps all free buffers, those cached in the magazines as well as those
+ * held by the depot. Buffers in use are not affected.
+ */
+JNIEXPORT void JNICALL
+Java_sun_nio_ch_NativeBufferArena_trim0(JNIEnv *env, jclass cl)
+{
+    int i, cls;
+    for (i = 0; i < NUM_MAGAZINES; i++) {
+        magazine *m = &magazines[i];
+        void *buffers[NUM_CLASSES][MAGAZINE_SIZE];
+        int count[NUM_CLASSES];
+
+        pthread_mutex_lock(&m->lock);
+        memcpy(buffers, m->buffers, sizeof(buffers));
+        memcpy(count, m->count, sizeof(count));
+        memset(m->count, 0, sizeof(m->count));
+        pthread_mutex_unlock(&m->lock);
+
+        for (cls = 0; cls < NUM_CLASSES; cls++) {
+            int j;
+            for (j = 0; j < count[cls]; j++) {
+                unmapBuffer(buffers[cls][j], cls);
+            }
+        }
+    }
+
+    for (cls = 0; cls < NUM_CLASSES; cls++) {
+        freeBuffer *fb;
+
+        pthread_mutex_lock(&depot.lock);
+        fb = depot.buffers[cls];
+        depot.buffers[cls] = NULL;
+        pthread_mutex_unlock(&depot.lock);
+
+        while (fb != NULL) {
+            freeBuffer *next = fb->next;
+            unmapBuffer(fb, cls);
+            fb = next;
+        }
+    }
+}
+
+/*
+ * The statistics reported through the BufferPoolMXBean of the arena:
+ * the number of buffers in use, their total size and the memory mapped.
+ */
+static jlong
+sumMagazines(jboolean bytes)
+{
+    jlong sum = 0;
+    int i;
+    for (i = 0; i < NUM_MAGAZINES; i++) {
+        magazine *m = &magazines[i];
+        pthread_mutex_lock(&m->lock);
+        sum += bytes ? m->allocatedBytes : m->allocated;
+        pthread_mutex_unlock(&m->lock);
+    }
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_NativeBufferArena_count0(JNIEnv *env, jclass cl)
+{
+    return sumMagazines(JNI_FALSE);
+}
+
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_NativeBufferArena_totalCapacity0(JNIEnv *env, jclass cl)
+{
+    return sumMagazines(JNI_TRUE);
+}
+
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_NativeBufferArena_memoryUsed0(JNIEnv *env, jclass cl)
+{
+    jlong used;
+    pthread_mutex_lock(&depot.lock);
+    used = depot.mappedBytes;
+    pthread_mutex_unlock(&depot.lock);
+    return used;
+}
@@ -49,6 +49,21 @@
 #endif
 #endif
 
+/* copy_file_range has no wrapper and no system call number in older headers */
+#if defined(__linux__) && !defined(__NR_copy_file_range)
+#if defined(__x86_64__)
+#define __NR_copy_file_range 326
+#elif defined(__i386__)
+#define __NR_copy_file_range 377
+#elif defined(__aarch64__)
+#define __NR_copy_file_range 285
+#elif defined(__powerpc__)
+#define __NR_copy_file_range 379
+#elif defined(__s390__)
+#define __NR_copy_file_range 375
+#endif
+#endif
+
 /* NIO utility procedures */
 
 
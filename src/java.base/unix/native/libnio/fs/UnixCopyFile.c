@@ -27,16 +27,19 @@
 #include "jni_util.h"
 #include "jlong.h"
 
+#include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/stat.h>
 
-#include "sun_nio_fs_UnixCopyFile.h"
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+#include "nio_util.h"
 
-#define RESTARTABLE(_cmd, _result) do { \
-  do { \
-    _result = _cmd; \
-  } while((_result == -1) && (errno == EINTR)); \
-} while(0)
+#include "sun_nio_fs_UnixCopyFile.h"
 
 static void throwUnixException(JNIEnv* env, int errnum) {
     jobject x = JNU_NewObjectByName(env, "sun/nio/fs/UnixException",
@@ -46,27 +49,105 @@ static void throwUnixException(JNIEnv* env, int errnum) {
     }
 }
 
+#if defined(__linux__)
+/* Bytes copied in the kernel between two checks for cancellation */
+#define KERNEL_COPY_CHUNK (64 * 1024 * 1024)
+
+/**
+ * Transfer bytes from src to dst in the kernel. The file systems can share
+ * the blocks (reflink) or copy them without a round trip through user
+ * space. Returns 0 when all bytes have been transferred, 1 if the caller
+ * must fall back to copying the remaining bytes through user space, or -1
+ * with an exception pending.
+ */
+static int
+transfer_in_kernel(JNIEnv* env, jint dst, jint src, volatile jint* cancel)
+{
+    jboolean use_copy_file_range = JNI_TRUE;
+    struct stat64 sb;
+
+    /*
+     * Files in pseudo file systems such as procfs report a size of 0 and
+     * cannot be copied in the kernel.
+     */
+    if (fstat64((int)src, &sb) != 0 || !S_ISREG(sb.st_mode) || sb.st_size == 0)
+        return 1;
+
+    for (;;) {
+        ssize_t n = -1;
+        if (cancel != NULL && *cancel != 0) {
+            throwUnixException(env, ECANCELED);
+            return -1;
+        }
+#if defined(__NR_copy_file_range)
+        if (use_copy_file_range) {
+            RESTARTABLE(syscall(__NR_copy_file_range, (int)src, NULL,
+                                (int)dst, NULL, KERNEL_COPY_CHUNK, 0), n);
+            if (n == -1 && (errno == ENOSYS || errno == EXDEV ||
+                            errno == EINVAL || errno == EOPNOTSUPP ||
+                            errno == EBADF)) {
+                /* unsupported by the kernel or between these file systems */
+                use_copy_file_range = JNI_FALSE;
+            }
+        }
+#else
+        use_copy_file_range = JNI_FALSE;
+#endif
+        if (!use_copy_file_range) {
+            /* sendfile accepts a regular file as destination since 2.6.33 */
+            RESTARTABLE(sendfile64((int)dst, (int)src, NULL, KERNEL_COPY_CHUNK), n);
+            if (n == -1 && (errno == EINVAL || errno == ENOSYS))
+                return 1;
+        }
+        if (n == 0)
+            return 0;
+        if (n < 0) {
+            throwUnixException(env, errno);
+            return -1;
+        }
+    }
+}
+#endif
+
+/* Largest buffer used to copy through user space */
+#define MAX_TRANSFER_BUFFER (1024 * 1024)
+
 /**
  * Transfer all bytes from src to dst via user-space buffers
  */
-JNIEXPORT void JNICALL
-Java_sun_nio_fs_UnixCopyFile_transfer
-    (JNIEnv* env, jclass this, jint dst, jint src, jlong cancelAddress)
+static void
+transfer_in_user_space(JNIEnv* env, jint dst, jint src, volatile jint* cancel)
 {
-    char buf[8192];
-    volatile jint* cancel = (jint*)jlong_to_ptr(cancelAddress);
+    char stackBuf[8192];
+    char* buf = stackBuf;
+    size_t bufLen = sizeof(stackBuf);
+    struct stat sb;
+
+    /*
+     * Use a buffer that fits the file up to MAX_TRANSFER_BUFFER, so that
+     * large files need fewer system calls.
+     */
+    if (fstat((int)src, &sb) == 0 && sb.st_size > (off_t)sizeof(stackBuf)) {
+        size_t len = (sb.st_size < MAX_TRANSFER_BUFFER) ?
+            (size_t)sb.st_size : MAX_TRANSFER_BUFFER;
+        char* heapBuf = (char*)malloc(len);
+        if (heapBuf != NULL) {
+            buf = heapBuf;
+            bufLen = len;
+        }
+    }
 
     for (;;) {
         ssize_t n, pos, len;
-        RESTARTABLE(read((int)src, &buf, sizeof(buf)), n);
+        RESTARTABLE(read((int)src, buf, bufLen), n);
         if (n <= 0) {
             if (n < 0)
                 throwUnixException(env, errno);
-            return;
+            break;
         }
         if (cancel != NULL && *cancel != 0) {
             throwUnixException(env, ECANCELED);
-            return;
+            break;
         }
         pos = 0;
         len = n;
@@ -76,10 +157,31 @@ Java_sun_nio_fs_UnixCopyFile_transfer
             RESTARTABLE(write((int)dst, bufp, len), n);
             if (n == -1) {
                 throwUnixException(env, errno);
-                return;
+                break;
             }
             pos += n;
             len -= n;
         } while (len > 0);
+        if (n == -1)
+            break;
     }
+
+    if (buf != stackBuf)
+        free(buf);
+}
+
+/**
+ * Transfer all bytes from src to dst, in the kernel where possible
+ */
+JNIEXPORT void JNICALL
+Java_sun_nio_fs_UnixCopyFile_transfer
+    (JNIEnv* env, jclass this, jint dst, jint src, jlong cancelAddress)
+{
+    volatile jint* cancel = (jint*)jlong_to_ptr(cancelAddress);
+
+#if defined(__linux__)
+    if (transfer_in_kernel(env, dst, src, cancel) <= 0)
+        return;
+#endif
+    transfer_in_user_space(env, dst, src, cancel);
 }
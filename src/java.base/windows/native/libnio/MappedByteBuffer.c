@@ -50,6 +50,13 @@ Java_java_nio_MappedByteBuffer_load0(JNIEnv *env, jobject obj, jlong address,
     // no madvise available
 }
 
+JNIEXPORT void JNICALL
+Java_java_nio_MappedByteBuffer_advise0(JNIEnv *env, jobject obj, jlong address,
+                                       jlong len, jint advice)
+{
+    // no madvise available
+}
+
 JNIEXPORT void JNICALL
 Java_java_nio_MappedByteBuffer_force0(JNIEnv *env, jobject obj, jobject fdo,
                                       jlong address, jlong len)
@@ -125,6 +125,45 @@ Java_sun_nio_ch_FileChannelImpl_map0(JNIEnv *env, jobject this,
     return ptr_to_jlong(mapAddress);
 }
 
+/*
+ * The option of map1 that is not a hint. The value must match the
+ * MAP_OPT_LOCK constant in sun.nio.ch.FileChannelImpl.
+ */
+#define MAP_OPT_LOCK        0x10
+
+/*
+ * Same as map0, and locks the mapping in memory if MAP_OPT_LOCK is given.
+ * The other options are hints, none of them are supported.
+ */
+JNIEXPORT jlong JNICALL
+Java_sun_nio_ch_FileChannelImpl_map1(JNIEnv *env, jobject this,
+                               jint prot, jlong off, jlong len, jint options)
+{
+    jlong address = Java_sun_nio_ch_FileChannelImpl_map0(env, this, prot, off, len);
+    void *mapAddress;
+    DWORD lockError;
+
+    if (address == IOS_THROWN || (options & MAP_OPT_LOCK) == 0) {
+        return address;
+    }
+
+    mapAddress = jlong_to_ptr(address);
+    if (VirtualLock(mapAddress, (SIZE_T)len) == 0) {
+        lockError = GetLastError();
+        UnmapViewOfFile(mapAddress);
+        if (lockError == ERROR_WORKING_SET_QUOTA ||
+            lockError == ERROR_NOT_ENOUGH_MEMORY) {
+            JNU_ThrowOutOfMemoryError(env, "Map failed: cannot lock mapping");
+        } else {
+            SetLastError(lockError);
+            JNU_ThrowIOExceptionWithLastError(env, "Map failed: VirtualLock");
+        }
+        return IOS_THROWN;
+    }
+
+    return address;
+}
+
 JNIEXPORT jint JNICALL
 Java_sun_nio_ch_FileChannelImpl_unmap0(JNIEnv *env, jobject this,
                                  jlong address, jlong len)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2003, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2003, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -24,14 +24,21 @@
  */
 
 #include "GraphicsPrimitiveMgr.h"
+#include "sse_AlphaLoops.h"
 
 /*
- * This is a dummy function that satisfies the MapAccelFunction
- * contract by simply returning a pointer to the indicated
- * C function.  This function is only executed in the absence
- * of an implementation specific function that maps the C
- * functions to accelerated versions of the same operation.
+ * This is the default function that satisfies the MapAccelFunction
+ * contract.  On x86_64 it returns the SSE version of the indicated
+ * C function where there is one (see sse_AlphaLoops.h), otherwise
+ * it simply returns a pointer to the C function.  This function is
+ * only executed in the absence of an implementation specific function
+ * that maps the C functions to accelerated versions of the same
+ * operation.
  */
 AnyFunc *MapAccelFunction(AnyFunc *c_func) {
+#ifdef J2D_SSE_LOOPS
+    return MapSSEFunction(c_func);
+#else
     return c_func;
+#endif
 }
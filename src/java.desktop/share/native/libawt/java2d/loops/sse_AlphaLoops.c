@@ -0,0 +1,603 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "sse_AlphaLoops.h"
+
+#ifdef J2D_SSE_LOOPS
+
+#include <string.h>
+#include <cpuid.h>
+#include <smmintrin.h>
+#include "AlphaMath.h"
+
+/*
+ * The loops work on groups of 8 pixels whose components are spread over
+ * four vectors of 16 bit lanes, one vector per component.  Shorter groups
+ * at the end of a row are copied to a buffer, processed and copied back.
+ *
+ * The macro loops use the tables in AlphaMath.c, which are replaced here
+ * with exact closed forms:
+ *
+ *     MUL8(a, b) == (t + (t >> 8)) >> 8, where t = a * b + 128
+ *     DIV8(a, b) == (min(a, b) * div8inc[b] + (1 << 23)) >> 24
+ *
+ * where div8inc holds the per row increments used to build div8table.
+ * MUL8(0xff, b) == b and DIV8(a, 0xff) == a, so the branches the macro
+ * loops take for opaque values need not be taken here.
+ */
+
+#define SSE_FUNC    __attribute__((target("sse4.1")))
+#define SSE_INLINE  static inline __attribute__((always_inline, \
+                                                 target("sse4.1")))
+
+#define GROUP_SIZE  8
+
+/* Surface types handled by the shared inner loops */
+#define TYPE_INT_ARGB       0
+#define TYPE_INT_ARGB_PRE   1
+#define TYPE_INT_RGB        2
+
+#define IsPremultiplied(type)   ((type) == TYPE_INT_ARGB_PRE)
+#define IsOpaque(type)          ((type) == TYPE_INT_RGB)
+
+static juint div8inc[256];
+
+typedef struct {
+    __m128i a, r, g, b;
+} Comps8;
+
+jboolean SSE_LoopsSupported()
+{
+    static int supported = -1;
+
+    if (supported < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        unsigned int i;
+
+        supported = __get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+                    (ecx & bit_SSE4_1) != 0;
+
+        /* Same increments as div8table, see initAlphaTables() */
+        div8inc[0] = 0;
+        for (i = 1; i < 256; i++) {
+            div8inc[i] = ((0xffu << 24) + i / 2) / i;
+        }
+    }
+    return supported ? JNI_TRUE : JNI_FALSE;
+}
+
+SSE_INLINE void SplitComps8(__m128i lo, __m128i hi, Comps8 *c)
+{
+    __m128i mask = _mm_set1_epi32(0xff);
+
+    c->a = _mm_packs_epi32(_mm_srli_epi32(lo, 24), _mm_srli_epi32(hi, 24));
+    c->r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask),
+                           _mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+    c->g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask),
+                           _mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+    c->b = _mm_packs_epi32(_mm_and_si128(lo, mask),
+                           _mm_and_si128(hi, mask));
+}
+
+/* The components must not exceed 0xff */
+SSE_INLINE void ComposeComps8(const Comps8 *c, __m128i *lo, __m128i *hi)
+{
+    __m128i ar = _mm_or_si128(_mm_slli_epi16(c->a, 8), c->r);
+    __m128i gb = _mm_or_si128(_mm_slli_epi16(c->g, 8), c->b);
+
+    *lo = _mm_unpacklo_epi16(gb, ar);
+    *hi = _mm_unpackhi_epi16(gb, ar);
+}
+
+SSE_INLINE __m128i Mul8(__m128i a, __m128i b)
+{
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+SSE_INLINE __m128i Div8(__m128i v, __m128i a, __m128i incLo, __m128i incHi)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i round = _mm_set1_epi32(1 << 23);
+    __m128i lo, hi;
+
+    v = _mm_min_epu16(v, a);
+    lo = _mm_mullo_epi32(_mm_unpacklo_epi16(v, zero), incLo);
+    hi = _mm_mullo_epi32(_mm_unpackhi_epi16(v, zero), incHi);
+    lo = _mm_srli_epi32(_mm_add_epi32(lo, round), 24);
+    hi = _mm_srli_epi32(_mm_add_epi32(hi, round), 24);
+    return _mm_packus_epi32(lo, hi);
+}
+
+/*
+ * Divides the color components by the alpha where it is neither 0 nor
+ * 0xff.  Where the alpha is 0 the components may come out as 0, which
+ * the SrcOver loops produce anyway (there the components never exceed
+ * the alpha), and which the conversion discards.
+ */
+SSE_INLINE void DivideComps8(Comps8 *c)
+{
+    jushort alpha[GROUP_SIZE];
+    __m128i ends = _mm_or_si128(_mm_cmpeq_epi16(c->a, _mm_set1_epi16(0xff)),
+                                _mm_cmpeq_epi16(c->a, _mm_setzero_si128()));
+    __m128i incLo, incHi;
+
+    if (_mm_movemask_epi8(ends) == 0xffff) {
+        return;
+    }
+    _mm_storeu_si128((__m128i *) alpha, c->a);
+    incLo = _mm_setr_epi32(div8inc[alpha[0]], div8inc[alpha[1]],
+                           div8inc[alpha[2]], div8inc[alpha[3]]);
+    incHi = _mm_setr_epi32(div8inc[alpha[4]], div8inc[alpha[5]],
+                           div8inc[alpha[6]], div8inc[alpha[7]]);
+    c->r = Div8(c->r, c->a, incLo, incHi);
+    c->g = Div8(c->g, c->a, incLo, incHi);
+    c->b = Div8(c->b, c->a, incLo, incHi);
+}
+
+/*
+ * Stores the composed pixels, except where the keep lanes are set.
+ */
+SSE_INLINE void StorePixels8(juint *pPix, __m128i lo, __m128i hi,
+                             __m128i oldLo, __m128i oldHi, __m128i keep)
+{
+    if (_mm_movemask_epi8(keep) != 0) {
+        lo = _mm_blendv_epi8(lo, oldLo, _mm_unpacklo_epi16(keep, keep));
+        hi = _mm_blendv_epi8(hi, oldHi, _mm_unpackhi_epi16(keep, keep));
+    }
+    _mm_storeu_si128((__m128i *) pPix, lo);
+    _mm_storeu_si128((__m128i *) (pPix + 4), hi);
+}
+
+/*
+ * Blends the (premultiplied) result of the source with the destination
+ * pixels, as DEFINE_SRCOVER_MASKFILL and DEFINE_SRCOVER_MASKBLIT do for
+ * the 4ByteArgb strategy.  On input res holds the source scaled by its
+ * coverage, with res.a playing the part of resA in the macros.
+ */
+SSE_INLINE void SrcOverBlend8(juint *pDst, Comps8 *res, __m128i keep,
+                              int type)
+{
+    __m128i c255 = _mm_set1_epi16(0xff);
+    __m128i oldLo = _mm_loadu_si128((const __m128i *) pDst);
+    __m128i oldHi = _mm_loadu_si128((const __m128i *) (pDst + 4));
+    __m128i dstF, dstA, lo, hi;
+    Comps8 dst;
+
+    SplitComps8(oldLo, oldHi, &dst);
+    if (IsOpaque(type)) {
+        dst.a = c255;
+    }
+
+    /* dstF is 0 where resA is 0xff, which leaves res unchanged */
+    dstF = _mm_sub_epi16(c255, res->a);
+    dstA = Mul8(dstF, dst.a);
+    if (!IsPremultiplied(type)) {
+        dstF = dstA;
+    }
+    res->a = _mm_add_epi16(res->a, dstA);
+    res->r = _mm_add_epi16(res->r, Mul8(dstF, dst.r));
+    res->g = _mm_add_epi16(res->g, Mul8(dstF, dst.g));
+    res->b = _mm_add_epi16(res->b, Mul8(dstF, dst.b));
+
+    if (!IsOpaque(type) && !IsPremultiplied(type)) {
+        DivideComps8(res);
+    }
+    if (IsOpaque(type)) {
+        res->a = _mm_setzero_si128();
+    }
+    ComposeComps8(res, &lo, &hi);
+    StorePixels8(pDst, lo, hi, oldLo, oldHi, keep);
+}
+
+/* Loads the coverage of up to 8 pixels into 16 bit lanes */
+SSE_INLINE __m128i LoadPathA8(const jubyte *pMask, jint n)
+{
+    jubyte buf[GROUP_SIZE];
+
+    if (n < GROUP_SIZE) {
+        memset(buf, 0, sizeof(buf));
+        memcpy(buf, pMask, n);
+        pMask = buf;
+    }
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *) pMask));
+}
+
+SSE_INLINE void SrcOverMaskFill(void *rasBase,
+                                jubyte *pMask, jint maskOff, jint maskScan,
+                                jint width, jint height, jint fgColor,
+                                SurfaceDataRasInfo *pRasInfo, int type)
+{
+    jint rasScan = pRasInfo->scanStride;
+    juint *pRas = (juint *) rasBase;
+    jint srcA = ((juint) fgColor) >> 24;
+    jint srcR = (fgColor >> 16) & 0xff;
+    jint srcG = (fgColor >>  8) & 0xff;
+    jint srcB = (fgColor      ) & 0xff;
+    juint solid;
+    Comps8 src;
+
+    if (srcA != 0xff) {
+        if (srcA == 0) {
+            return;
+        }
+        srcR = MUL8(srcA, srcR);
+        srcG = MUL8(srcA, srcG);
+        srcB = MUL8(srcA, srcB);
+    }
+    src.a = _mm_set1_epi16((short) srcA);
+    src.r = _mm_set1_epi16((short) srcR);
+    src.g = _mm_set1_epi16((short) srcG);
+    src.b = _mm_set1_epi16((short) srcB);
+
+    /* The pixel stored where an opaque color fully covers the pixel */
+    solid = (srcR << 16) | (srcG << 8) | srcB;
+    if (!IsOpaque(type)) {
+        solid |= 0xffu << 24;
+    }
+
+    if (pMask) {
+        pMask += maskOff;
+    }
+    do {
+        juint *pPix = pRas;
+        jubyte *pPathA = pMask;
+        jint w = width;
+
+        while (w > 0) {
+            jint n = (w < GROUP_SIZE) ? w : GROUP_SIZE;
+            juint buf[GROUP_SIZE];
+            juint *pDst = pPix;
+            __m128i pathA, keep;
+            Comps8 res;
+
+            if (pPathA) {
+                int covered;
+
+                pathA = LoadPathA8(pPathA, n);
+                keep = _mm_cmpeq_epi16(pathA, _mm_setzero_si128());
+                if (_mm_movemask_epi8(keep) == 0xffff) {
+                    goto next;
+                }
+                covered = _mm_movemask_epi8(
+                    _mm_cmpeq_epi16(pathA, _mm_set1_epi16(0xff)));
+                if (covered == 0xffff && srcA == 0xff) {
+                    __m128i s = _mm_set1_epi32((jint) solid);
+                    _mm_storeu_si128((__m128i *) pPix, s);
+                    _mm_storeu_si128((__m128i *) (pPix + 4), s);
+                    goto next;
+                }
+                res.a = Mul8(pathA, src.a);
+                res.r = Mul8(pathA, src.r);
+                res.g = Mul8(pathA, src.g);
+                res.b = Mul8(pathA, src.b);
+            } else {
+                keep = _mm_setzero_si128();
+                res = src;
+            }
+            if (n < GROUP_SIZE) {
+                memcpy(buf, pPix, n * sizeof(juint));
+                pDst = buf;
+            }
+            SrcOverBlend8(pDst, &res, keep, type);
+            if (n < GROUP_SIZE) {
+                memcpy(pPix, buf, n * sizeof(juint));
+            }
+        next:
+            pPix += n;
+            if (pPathA) {
+                pPathA += n;
+            }
+            w -= n;
+        }
+        pRas = PtrAddBytes(pRas, rasScan);
+        if (pMask) {
+            pMask = PtrAddBytes(pMask, maskScan);
+        }
+    } while (--height > 0);
+}
+
+SSE_INLINE void IntArgbToSrcOverMaskBlit(void *dstBase, void *srcBase,
+                                         jubyte *pMask, jint maskOff,
+                                         jint maskScan,
+                                         jint width, jint height,
+                                         SurfaceDataRasInfo *pDstInfo,
+                                         SurfaceDataRasInfo *pSrcInfo,
+                                         CompositeInfo *pCompInfo, int type)
+{
+    jint extraA = (jint) (pCompInfo->details.extraAlpha * 255.0 + 0.5);
+    jint srcScan = pSrcInfo->scanStride;
+    jint dstScan = pDstInfo->scanStride;
+    juint *pSrc = (juint *) srcBase;
+    juint *pDst = (juint *) dstBase;
+    __m128i vExtraA = _mm_set1_epi16((short) extraA);
+
+    if (pMask) {
+        pMask += maskOff;
+    }
+    do {
+        juint *pS = pSrc;
+        juint *pD = pDst;
+        jubyte *pPathA = pMask;
+        jint w = width;
+
+        while (w > 0) {
+            jint n = (w < GROUP_SIZE) ? w : GROUP_SIZE;
+            juint srcBuf[GROUP_SIZE], dstBuf[GROUP_SIZE];
+            const juint *pSrcPix = pS;
+            juint *pDstPix = pD;
+            __m128i pathA, keep;
+            Comps8 src, res;
+
+            if (pPathA) {
+                pathA = LoadPathA8(pPathA, n);
+                if (_mm_testz_si128(pathA, pathA)) {
+                    goto next;
+                }
+                pathA = Mul8(pathA, vExtraA);
+            } else {
+                pathA = vExtraA;
+            }
+            if (n < GROUP_SIZE) {
+                memset(srcBuf, 0, sizeof(srcBuf));
+                memcpy(srcBuf, pS, n * sizeof(juint));
+                memcpy(dstBuf, pD, n * sizeof(juint));
+                pSrcPix = srcBuf;
+                pDstPix = dstBuf;
+            }
+            SplitComps8(_mm_loadu_si128((const __m128i *) pSrcPix),
+                        _mm_loadu_si128((const __m128i *) (pSrcPix + 4)),
+                        &src);
+
+            /* srcF == resA for a non premultiplied source */
+            res.a = Mul8(pathA, src.a);
+            res.r = Mul8(res.a, src.r);
+            res.g = Mul8(res.a, src.g);
+            res.b = Mul8(res.a, src.b);
+            keep = _mm_cmpeq_epi16(res.a, _mm_setzero_si128());
+            if (_mm_movemask_epi8(keep) != 0xffff) {
+                SrcOverBlend8(pDstPix, &res, keep, type);
+                if (n < GROUP_SIZE) {
+                    memcpy(pD, dstBuf, n * sizeof(juint));
+                }
+            }
+        next:
+            pS += n;
+            pD += n;
+            if (pPathA) {
+                pPathA += n;
+            }
+            w -= n;
+        }
+        pSrc = PtrAddBytes(pSrc, srcScan);
+        pDst = PtrAddBytes(pDst, dstScan);
+        if (pMask) {
+            pMask = PtrAddBytes(pMask, maskScan);
+        }
+    } while (--height > 0);
+}
+
+SSE_FUNC
+void IntArgbSrcOverMaskFill_SSE(void *rasBase,
+                                jubyte *pMask, jint maskOff, jint maskScan,
+                                jint width, jint height, jint fgColor,
+                                SurfaceDataRasInfo *pRasInfo,
+                                NativePrimitive *pPrim,
+                                CompositeInfo *pCompInfo)
+{
+    SrcOverMaskFill(rasBase, pMask, maskOff, maskScan, width, height,
+                    fgColor, pRasInfo, TYPE_INT_ARGB);
+}
+
+SSE_FUNC
+void IntArgbPreSrcOverMaskFill_SSE(void *rasBase,
+                                   jubyte *pMask, jint maskOff,
+                                   jint maskScan,
+                                   jint width, jint height, jint fgColor,
+                                   SurfaceDataRasInfo *pRasInfo,
+                                   NativePrimitive *pPrim,
+                                   CompositeInfo *pCompInfo)
+{
+    SrcOverMaskFill(rasBase, pMask, maskOff, maskScan, width, height,
+                    fgColor, pRasInfo, TYPE_INT_ARGB_PRE);
+}
+
+SSE_FUNC
+void IntRgbSrcOverMaskFill_SSE(void *rasBase,
+                               jubyte *pMask, jint maskOff, jint maskScan,
+                               jint width, jint height, jint fgColor,
+                               SurfaceDataRasInfo *pRasInfo,
+                               NativePrimitive *pPrim,
+                               CompositeInfo *pCompInfo)
+{
+    SrcOverMaskFill(rasBase, pMask, maskOff, maskScan, width, height,
+                    fgColor, pRasInfo, TYPE_INT_RGB);
+}
+
+SSE_FUNC
+void IntArgbToIntArgbSrcOverMaskBlit_SSE(void *dstBase, void *srcBase,
+                                         jubyte *pMask, jint maskOff,
+                                         jint maskScan,
+                                         jint width, jint height,
+                                         SurfaceDataRasInfo *pDstInfo,
+                                         SurfaceDataRasInfo *pSrcInfo,
+                                         NativePrimitive *pPrim,
+                                         CompositeInfo *pCompInfo)
+{
+    IntArgbToSrcOverMaskBlit(dstBase, srcBase, pMask, maskOff, maskScan,
+                             width, height, pDstInfo, pSrcInfo, pCompInfo,
+                             TYPE_INT_ARGB);
+}
+
+SSE_FUNC
+void IntArgbToIntArgbPreSrcOverMaskBlit_SSE(void *dstBase, void *srcBase,
+                                            jubyte *pMask, jint maskOff,
+                                            jint maskScan,
+                                            jint width, jint height,
+                                            SurfaceDataRasInfo *pDstInfo,
+                                            SurfaceDataRasInfo *pSrcInfo,
+                                            NativePrimitive *pPrim,
+                                            CompositeInfo *pCompInfo)
+{
+    IntArgbToSrcOverMaskBlit(dstBase, srcBase, pMask, maskOff, maskScan,
+                             width, height, pDstInfo, pSrcInfo, pCompInfo,
+                             TYPE_INT_ARGB_PRE);
+}
+
+SSE_FUNC
+void IntArgbToIntRgbSrcOverMaskBlit_SSE(void *dstBase, void *srcBase,
+                                        jubyte *pMask, jint maskOff,
+                                        jint maskScan,
+                                        jint width, jint height,
+                                        SurfaceDataRasInfo *pDstInfo,
+                                        SurfaceDataRasInfo *pSrcInfo,
+                                        NativePrimitive *pPrim,
+                                        CompositeInfo *pCompInfo)
+{
+    IntArgbToSrcOverMaskBlit(dstBase, srcBase, pMask, maskOff, maskScan,
+                             width, height, pDstInfo, pSrcInfo, pCompInfo,
+                             TYPE_INT_RGB);
+}
+
+/*
+ * The conversions run over each row in groups of 8 pixels, the few
+ * pixels left at the end of a row are converted through a buffer.
+ */
+#define CONVERT_ROWS(CONVERT_GROUP) \
+    do { \
+        jint srcScan = pSrcInfo->scanStride; \
+        jint dstScan = pDstInfo->scanStride; \
+        juint *pSrc = (juint *) srcBase; \
+        juint *pDst = (juint *) dstBase; \
+        do { \
+            juint x = 0; \
+            for (; x + GROUP_SIZE <= width; x += GROUP_SIZE) { \
+                CONVERT_GROUP(pSrc + x, pDst + x); \
+            } \
+            if (x < width) { \
+                juint srcBuf[GROUP_SIZE], dstBuf[GROUP_SIZE]; \
+                memset(srcBuf, 0, sizeof(srcBuf)); \
+                memcpy(srcBuf, pSrc + x, (width - x) * sizeof(juint)); \
+                CONVERT_GROUP(srcBuf, dstBuf); \
+                memcpy(pDst + x, dstBuf, (width - x) * sizeof(juint)); \
+            } \
+            pSrc = PtrAddBytes(pSrc, srcScan); \
+            pDst = PtrAddBytes(pDst, dstScan); \
+        } while (--height > 0); \
+    } while (0)
+
+SSE_INLINE int IsOpaque8(__m128i lo, __m128i hi)
+{
+    __m128i alpha = _mm_set1_epi32(0xff000000);
+
+    return _mm_testc_si128(_mm_and_si128(lo, hi), alpha);
+}
+
+SSE_INLINE void IntArgbToIntArgbPre8(const juint *pSrc, juint *pDst)
+{
+    __m128i lo = _mm_loadu_si128((const __m128i *) pSrc);
+    __m128i hi = _mm_loadu_si128((const __m128i *) (pSrc + 4));
+
+    if (!IsOpaque8(lo, hi)) {
+        Comps8 c;
+
+        SplitComps8(lo, hi, &c);
+        c.r = Mul8(c.a, c.r);
+        c.g = Mul8(c.a, c.g);
+        c.b = Mul8(c.a, c.b);
+        ComposeComps8(&c, &lo, &hi);
+    }
+    _mm_storeu_si128((__m128i *) pDst, lo);
+    _mm_storeu_si128((__m128i *) (pDst + 4), hi);
+}
+
+SSE_INLINE void IntArgbPreToIntArgb8(const juint *pSrc, juint *pDst)
+{
+    __m128i lo = _mm_loadu_si128((const __m128i *) pSrc);
+    __m128i hi = _mm_loadu_si128((const __m128i *) (pSrc + 4));
+
+    if (!IsOpaque8(lo, hi)) {
+        __m128i oldLo = lo, oldHi = hi;
+        __m128i keep;
+        Comps8 c;
+
+        SplitComps8(lo, hi, &c);
+        DivideComps8(&c);
+        ComposeComps8(&c, &lo, &hi);
+
+        /* Transparent pixels are copied unchanged */
+        keep = _mm_cmpeq_epi16(c.a, _mm_setzero_si128());
+        StorePixels8(pDst, lo, hi, oldLo, oldHi, keep);
+        return;
+    }
+    _mm_storeu_si128((__m128i *) pDst, lo);
+    _mm_storeu_si128((__m128i *) (pDst + 4), hi);
+}
+
+SSE_INLINE void IntRgbToIntArgb8(const juint *pSrc, juint *pDst)
+{
+    __m128i alpha = _mm_set1_epi32(0xff000000);
+    __m128i lo = _mm_loadu_si128((const __m128i *) pSrc);
+    __m128i hi = _mm_loadu_si128((const __m128i *) (pSrc + 4));
+
+    _mm_storeu_si128((__m128i *) pDst, _mm_or_si128(lo, alpha));
+    _mm_storeu_si128((__m128i *) (pDst + 4), _mm_or_si128(hi, alpha));
+}
+
+SSE_FUNC
+void IntArgbToIntArgbPreConvert_SSE(void *srcBase, void *dstBase,
+                                    juint width, juint height,
+                                    SurfaceDataRasInfo *pSrcInfo,
+                                    SurfaceDataRasInfo *pDstInfo,
+                                    NativePrimitive *pPrim,
+                                    CompositeInfo *pCompInfo)
+{
+    CONVERT_ROWS(IntArgbToIntArgbPre8);
+}
+
+SSE_FUNC
+void IntArgbPreToIntArgbConvert_SSE(void *srcBase, void *dstBase,
+                                    juint width, juint height,
+                                    SurfaceDataRasInfo *pSrcInfo,
+                                    SurfaceDataRasInfo *pDstInfo,
+                                    NativePrimitive *pPrim,
+                                    CompositeInfo *pCompInfo)
+{
+    CONVERT_ROWS(IntArgbPreToIntArgb8);
+}
+
+SSE_FUNC
+void IntRgbToIntArgbConvert_SSE(void *srcBase, void *dstBase,
+                                juint width, juint height,
+                                SurfaceDataRasInfo *pSrcInfo,
+                                SurfaceDataRasInfo *pDstInfo,
+                                NativePrimitive *pPrim,
+                                CompositeInfo *pCompInfo)
+{
+    CONVERT_ROWS(IntRgbToIntArgb8);
+}
+
+#endif /* J2D_SSE_LOOPS */
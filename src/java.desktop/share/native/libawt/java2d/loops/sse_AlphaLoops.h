@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef sse_AlphaLoops_h_Included
+#define sse_AlphaLoops_h_Included
+
+#include "GraphicsPrimitiveMgr.h"
+
+/*
+ * SSE4.1 versions of the most heavily used loops on IntArgb, IntArgbPre
+ * and IntRgb surfaces: SrcOver MaskFill (antialiased and translucent
+ * fills), SrcOver MaskBlit from IntArgb (translucent images) and the
+ * conversions between the three types.
+ *
+ * The loops produce exactly the same pixels as the C loops they replace,
+ * which are defined with the macros in AlphaMacros.h and LoopMacros.h.
+ * MapAccelFunction (see MapAccelFunc.c) substitutes them for the C loops
+ * when the CPU supports SSE4.1.
+ *
+ * The environment variable J2D_USE_SSE_LOOPS controls the substitution:
+ *     f, F     use the C loops
+ *     t, T     use the SSE loops if possible (the default)
+ *     c, C     compare every SSE loop with its C loop on random pixels
+ *              at startup, print the results and timings to stderr and
+ *              use only the SSE loops that produced the same pixels
+ * The upper case letters also print which loops are used.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define J2D_SSE_LOOPS
+#endif
+
+#ifdef J2D_SSE_LOOPS
+
+MaskFillFunc IntArgbSrcOverMaskFill_SSE;
+MaskFillFunc IntArgbPreSrcOverMaskFill_SSE;
+MaskFillFunc IntRgbSrcOverMaskFill_SSE;
+
+MaskBlitFunc IntArgbToIntArgbSrcOverMaskBlit_SSE;
+MaskBlitFunc IntArgbToIntArgbPreSrcOverMaskBlit_SSE;
+MaskBlitFunc IntArgbToIntRgbSrcOverMaskBlit_SSE;
+
+BlitFunc IntArgbToIntArgbPreConvert_SSE;
+BlitFunc IntArgbPreToIntArgbConvert_SSE;
+BlitFunc IntRgbToIntArgbConvert_SSE;
+
+/*
+ * Returns JNI_TRUE if the CPU can run the SSE loops.
+ */
+jboolean SSE_LoopsSupported();
+
+/*
+ * Returns the SSE version of the indicated C loop, or the C loop itself
+ * if there is none or the SSE loops are not used.
+ */
+AnyFunc *MapSSEFunction(AnyFunc *func_c);
+
+#endif /* J2D_SSE_LOOPS */
+
+#endif /* sse_AlphaLoops_h_Included */
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "sse_AlphaLoops.h"
+
+#ifdef J2D_SSE_LOOPS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LoopMacros.h"
+
+DECLARE_SRCOVER_MASKFILL(IntArgb);
+DECLARE_SRCOVER_MASKFILL(IntArgbPre);
+DECLARE_SRCOVER_MASKFILL(IntRgb);
+DECLARE_SRCOVER_MASKBLIT(IntArgb, IntArgb);
+DECLARE_SRCOVER_MASKBLIT(IntArgb, IntArgbPre);
+DECLARE_SRCOVER_MASKBLIT(IntArgb, IntRgb);
+DECLARE_CONVERT_BLIT(IntArgb, IntArgbPre);
+DECLARE_CONVERT_BLIT(IntArgbPre, IntArgb);
+DECLARE_CONVERT_BLIT(IntRgb, IntArgb);
+
+#define KIND_MASKFILL   0
+#define KIND_MASKBLIT   1
+#define KIND_BLIT       2
+
+typedef struct {
+    AnyFunc     *func_c;
+    AnyFunc     *func_sse;
+    jint        kind;
+    const char  *name;
+    jboolean    enabled;
+} AnyFunc_SSE;
+
+#define ADD_FUNC(NAME, KIND) \
+    { (AnyFunc *) & NAME, (AnyFunc *) & NAME ## _SSE, KIND, #NAME, JNI_TRUE }
+
+static AnyFunc_SSE sse_func_array[] = {
+    ADD_FUNC(IntArgbSrcOverMaskFill, KIND_MASKFILL),
+    ADD_FUNC(IntArgbPreSrcOverMaskFill, KIND_MASKFILL),
+    ADD_FUNC(IntRgbSrcOverMaskFill, KIND_MASKFILL),
+    ADD_FUNC(IntArgbToIntArgbSrcOverMaskBlit, KIND_MASKBLIT),
+    ADD_FUNC(IntArgbToIntArgbPreSrcOverMaskBlit, KIND_MASKBLIT),
+    ADD_FUNC(IntArgbToIntRgbSrcOverMaskBlit, KIND_MASKBLIT),
+    ADD_FUNC(IntArgbToIntArgbPreConvert, KIND_BLIT),
+    ADD_FUNC(IntArgbPreToIntArgbConvert, KIND_BLIT),
+    ADD_FUNC(IntRgbToIntArgbConvert, KIND_BLIT),
+};
+
+#define NUM_SSE_FUNCS ((jint) (sizeof(sse_func_array) / sizeof(AnyFunc_SSE)))
+
+/*
+ * The self check started with J2D_USE_SSE_LOOPS=C runs every loop pair
+ * on small random rectangles, with random pixels, coverage, colors and
+ * extra alpha and with some padding around each row, and compares the
+ * whole buffers.  It then times both loops on a large rectangle.
+ */
+
+#define CHECK_CASES     500
+#define CHECK_MAX_W     40
+#define CHECK_MAX_H     6
+#define CHECK_PAD       3
+#define CHECK_SCAN      (CHECK_MAX_W + 2 * CHECK_PAD)
+#define CHECK_SIZE      (CHECK_SCAN * (CHECK_MAX_H + 2))
+
+#define BENCH_W         512
+#define BENCH_H         512
+#define BENCH_REPS      20
+
+typedef struct {
+    juint       *pSrc;          /* first source pixel */
+    juint       *pDst;          /* first destination pixel */
+    jubyte      *pMask;         /* NULL or mask without the offset */
+    jint        maskOff;
+    jint        maskScan;
+    jint        width;
+    jint        height;
+    jint        fgColor;
+    SurfaceDataRasInfo srcInfo;
+    SurfaceDataRasInfo dstInfo;
+    CompositeInfo compInfo;
+} LoopArgs;
+
+static juint CheckRandom(juint *pSeed)
+{
+    juint x = *pSeed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return (*pSeed = x);
+}
+
+/* Mostly the values that take special paths, then anything */
+static juint CheckRandomByte(juint *pSeed)
+{
+    juint r = CheckRandom(pSeed);
+
+    switch (r & 3) {
+    case 0:
+        return 0;
+    case 1:
+        return 0xff;
+    default:
+        return (r >> 8) & 0xff;
+    }
+}
+
+static juint CheckRandomPixel(juint *pSeed)
+{
+    return (CheckRandomByte(pSeed) << 24) | (CheckRandom(pSeed) & 0xffffff);
+}
+
+static void InitRasInfo(SurfaceDataRasInfo *pInfo, jint scan)
+{
+    memset(pInfo, 0, sizeof(*pInfo));
+    pInfo->pixelStride = sizeof(juint);
+    pInfo->scanStride = scan;
+}
+
+static void RunLoop(AnyFunc_SSE *pEntry, AnyFunc *func, LoopArgs *pArgs)
+{
+    switch (pEntry->kind) {
+    case KIND_MASKFILL:
+        ((MaskFillFunc *) func)(pArgs->pDst, pArgs->pMask,
+                                pArgs->maskOff, pArgs->maskScan,
+                                pArgs->width, pArgs->height,
+                                pArgs->fgColor, &pArgs->dstInfo,
+                                NULL, &pArgs->compInfo);
+        break;
+    case KIND_MASKBLIT:
+        ((MaskBlitFunc *) func)(pArgs->pDst, pArgs->pSrc, pArgs->pMask,
+                                pArgs->maskOff, pArgs->maskScan,
+                                pArgs->width, pArgs->height,
+                                &pArgs->dstInfo, &pArgs->srcInfo,
+                                NULL, &pArgs->compInfo);
+        break;
+    default:
+        ((BlitFunc *) func)(pArgs->pSrc, pArgs->pDst,
+                            pArgs->width, pArgs->height,
+                            &pArgs->srcInfo, &pArgs->dstInfo,
+                            NULL, &pArgs->compInfo);
+        break;
+    }
+}
+
+/*
+ * Returns JNI_TRUE if the SSE loop produced the same pixels as the C loop
+ * in every case.
+ */
+static jboolean CheckLoop(AnyFunc_SSE *pEntry)
+{
+    juint src[CHECK_SIZE], dst[CHECK_SIZE], dstC[CHECK_SIZE];
+    juint dstSSE[CHECK_SIZE];
+    jubyte mask[CHECK_SIZE];
+    juint seed = 0x2545f491;
+    jint i, n;
+
+    for (n = 0; n < CHECK_CASES; n++) {
+        jint first = CHECK_SCAN + CHECK_PAD;
+        jint extra = CheckRandom(&seed) % 4;
+        LoopArgs args;
+
+        for (i = 0; i < CHECK_SIZE; i++) {
+            src[i] = CheckRandomPixel(&seed);
+            dst[i] = CheckRandomPixel(&seed);
+            mask[i] = (jubyte) CheckRandomByte(&seed);
+        }
+        args.width = 1 + CheckRandom(&seed) % CHECK_MAX_W;
+        args.height = 1 + CheckRandom(&seed) % CHECK_MAX_H;
+        args.fgColor = (jint) CheckRandomPixel(&seed);
+        args.pSrc = src + first;
+        args.pMask = (CheckRandom(&seed) % 4 == 0) ? NULL : mask;
+        args.maskOff = first;
+        args.maskScan = CHECK_SCAN;
+        InitRasInfo(&args.srcInfo, CHECK_SCAN * sizeof(juint));
+        InitRasInfo(&args.dstInfo, CHECK_SCAN * sizeof(juint));
+        memset(&args.compInfo, 0, sizeof(args.compInfo));
+        args.compInfo.details.extraAlpha =
+            (extra == 0) ? 1.0f : (CheckRandom(&seed) % 1001) / 1000.0f;
+
+        memcpy(dstC, dst, sizeof(dst));
+        memcpy(dstSSE, dst, sizeof(dst));
+        args.pDst = dstC + first;
+        RunLoop(pEntry, pEntry->func_c, &args);
+        args.pDst = dstSSE + first;
+        RunLoop(pEntry, pEntry->func_sse, &args);
+
+        for (i = 0; i < CHECK_SIZE; i++) {
+            if (dstC[i] != dstSSE[i]) {
+                fprintf(stderr,
+                        "SSE loop %s differs: %dx%d pixel %d: "
+                        "0x%08x instead of 0x%08x\n",
+                        pEntry->name, args.width, args.height, i - first,
+                        dstSSE[i], dstC[i]);
+                return JNI_FALSE;
+            }
+        }
+    }
+    return JNI_TRUE;
+}
+
+static double TimeLoop(AnyFunc_SSE *pEntry, AnyFunc *func, LoopArgs *pArgs)
+{
+    clock_t start = clock();
+    jint i;
+
+    for (i = 0; i < BENCH_REPS; i++) {
+        RunLoop(pEntry, func, pArgs);
+    }
+    return (clock() - start) * 1000.0 / CLOCKS_PER_SEC / BENCH_REPS;
+}
+
+/*
+ * Times both loops on antialiased coverage over translucent pixels.
+ */
+static void BenchLoop(AnyFunc_SSE *pEntry)
+{
+    juint *src = malloc(BENCH_W * BENCH_H * sizeof(juint));
+    juint *dst = malloc(BENCH_W * BENCH_H * sizeof(juint));
+    jubyte *mask = malloc(BENCH_W * BENCH_H);
+    juint seed = 0x6c078965;
+    double timeC, timeSSE;
+    LoopArgs args;
+    jint i;
+
+    if (src == NULL || dst == NULL || mask == NULL) {
+        free(src);
+        free(dst);
+        free(mask);
+        return;
+    }
+    for (i = 0; i < BENCH_W * BENCH_H; i++) {
+        src[i] = CheckRandom(&seed);
+        dst[i] = CheckRandom(&seed);
+        mask[i] = (jubyte) CheckRandomByte(&seed);
+    }
+    args.pSrc = src;
+    args.pDst = dst;
+    args.pMask = mask;
+    args.maskOff = 0;
+    args.maskScan = BENCH_W;
+    args.width = BENCH_W;
+    args.height = BENCH_H;
+    args.fgColor = 0x80336699;
+    InitRasInfo(&args.srcInfo, BENCH_W * sizeof(juint));
+    InitRasInfo(&args.dstInfo, BENCH_W * sizeof(juint));
+    memset(&args.compInfo, 0, sizeof(args.compInfo));
+    args.compInfo.details.extraAlpha = 0.75f;
+
+    timeC = TimeLoop(pEntry, pEntry->func_c, &args);
+    timeSSE = TimeLoop(pEntry, pEntry->func_sse, &args);
+    fprintf(stderr, "SSE loop %s: %dx%d in %.3f ms, C loop in %.3f ms\n",
+            pEntry->name, BENCH_W, BENCH_H, timeSSE, timeC);
+
+    free(src);
+    free(dst);
+    free(mask);
+}
+
+static int initialized;
+static int usesse = JNI_TRUE;
+
+/*
+ * This function returns a pointer to the SSE version of the indicated
+ * C function if it exists and if the CPU and the environment allow
+ * using it.
+ */
+AnyFunc *MapSSEFunction(AnyFunc *func_c)
+{
+    jint i;
+
+    if (!initialized) {
+        char *sse_env = getenv("J2D_USE_SSE_LOOPS");
+        jboolean check = JNI_FALSE;
+        jboolean verbose = JNI_FALSE;
+
+        if (sse_env != NULL) {
+            switch (*sse_env) {
+            case 'C':
+            case 'c':
+                check = JNI_TRUE;
+                verbose = JNI_TRUE;
+                break;
+
+            case 'T':
+                verbose = JNI_TRUE;
+                /* fall through */
+            case 't':
+                usesse = JNI_TRUE;
+                break;
+
+            case 'F':
+                verbose = JNI_TRUE;
+                /* fall through */
+            case 'f':
+                usesse = JNI_FALSE;
+                break;
+
+            default:
+                fprintf(stderr, "SSE loops %s by default\n",
+                        usesse ? "enabled" : "disabled");
+                break;
+            }
+        }
+        if (usesse && !SSE_LoopsSupported()) {
+            usesse = JNI_FALSE;
+        }
+        if (usesse && check) {
+            for (i = 0; i < NUM_SSE_FUNCS; i++) {
+                sse_func_array[i].enabled = CheckLoop(&sse_func_array[i]);
+                if (sse_func_array[i].enabled) {
+                    BenchLoop(&sse_func_array[i]);
+                }
+            }
+        }
+        if (verbose) {
+            if (!usesse) {
+                fprintf(stderr, "SSE loops disabled\n");
+            }
+            for (i = 0; usesse && i < NUM_SSE_FUNCS; i++) {
+                fprintf(stderr, "SSE loop %s %s\n", sse_func_array[i].name,
+                        sse_func_array[i].enabled ? "enabled" : "disabled");
+            }
+        }
+        initialized = 1;
+    }
+    if (!usesse) {
+        return func_c;
+    }
+
+    for (i = 0; i < NUM_SSE_FUNCS; i++) {
+        if (sse_func_array[i].func_c == func_c) {
+            return sse_func_array[i].enabled ?
+                sse_func_array[i].func_sse : func_c;
+        }
+    }
+    return func_c;
+}
+
+#endif /* J2D_SSE_LOOPS */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2015, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -25,10 +25,12 @@
 
 #include <jni_util.h>
 #include <stdlib.h>
+#include <string.h>
 #include "hb.h"
 #include "hb-jdk.h"
 #include "hb-ot.h"
 #include "scriptMapping.h"
+#include "lrucache.h"
 
 static jclass gvdClass = 0;
 static const char* gvdClassName = "sun/font/GlyphLayout$GVData";
@@ -38,6 +40,7 @@ static jfieldID gvdGlyphsFID = 0;
 static jfieldID gvdPositionsFID = 0;
 static jfieldID gvdIndicesFID = 0;
 static jmethodID gvdGrowMID = 0;
+static jobject shapeCacheLock = NULL;
 static int jniInited = 0;
 
 static void getFloat(JNIEnv* env, jobject pt, jfloat *x, jfloat *y) {
@@ -51,6 +54,9 @@ static void putFloat(JNIEnv* env, jobject pt, jfloat x, jfloat y) {
 }
 
 static int init_JNI_IDs(JNIEnv *env) {
+    jclass objectClass;
+    jobject lock;
+
     if (jniInited) {
         return jniInited;
     }
@@ -62,6 +68,9 @@ static int init_JNI_IDs(JNIEnv *env) {
     CHECK_NULL_RETURN(gvdPositionsFID = (*env)->GetFieldID(env, gvdClass, "_positions", "[F"), 0);
     CHECK_NULL_RETURN(gvdIndicesFID = (*env)->GetFieldID(env, gvdClass, "_indices", "[I"), 0);
     CHECK_NULL_RETURN(gvdGrowMID = (*env)->GetMethodID(env, gvdClass, "grow", "()V"), 0);
+    CHECK_NULL_RETURN(objectClass = (*env)->FindClass(env, "java/lang/Object"), 0);
+    CHECK_NULL_RETURN(lock = (*env)->AllocObject(env, objectClass), 0);
+    CHECK_NULL_RETURN(shapeCacheLock = (*env)->NewGlobalRef(env, lock), 0);
     jniInited = 1;
     return jniInited;
 }
@@ -225,6 +234,178 @@ JDKFontInfo*
 #define TYPO_LIGA 0x00000002
 #define TYPO_RTL  0x80000000
 
+/*
+ * Shaping results are cached for runs that are laid out again with the
+ * same face, strike, script, flags and text, e.g. labels repainted over
+ * and over. HarfBuzz looks at up to 5 characters on each side of the run,
+ * so these are part of the key as well. The cache is guarded by the
+ * monitor of shapeCacheLock.
+ */
+#define SHAPE_CACHE_SIZE (2 * 1024 * 1024)
+#define SHAPE_CACHE_MAX_RUN 1024
+#define SHAPE_CONTEXT_CHARS 10 /* UTF-16 units of 5 characters */
+
+typedef struct {
+    hb_face_t* face;
+    jobject fontStrike;
+    float ptSize;
+    float matrix[4];
+    jint script;
+    jint flags;
+    int before;          /* context characters before the run */
+    int runLength;
+    int after;           /* context characters after the run */
+    const jchar* text;   /* starting with the context before the run */
+} ShapeKey;
+
+typedef struct {
+    LRUEntry entry;      /* owner is the face */
+    jweak fontStrike;
+    float ptSize;
+    float matrix[4];
+    jint script;
+    jint flags;
+    int before;
+    int runLength;
+    int after;
+    int glyphCount;
+    hb_glyph_info_t* glyphInfo;     /* clusters relative to the run */
+    hb_glyph_position_t* glyphPos;
+    jchar* text;
+} ShapeCacheEntry;
+
+static void freeShapeCacheEntry(JNIEnv* env, LRUEntry* entry) {
+    (*env)->DeleteWeakGlobalRef(env, ((ShapeCacheEntry*)entry)->fontStrike);
+    free(entry);
+}
+
+static LRUCache shapeCache =
+    LRU_CACHE_INITIALIZER(SHAPE_CACHE_SIZE, freeShapeCacheEntry);
+
+static unsigned int hashShapeKey(const ShapeKey* key) {
+    unsigned int hash;
+    int textLength = key->before + key->runLength + key->after;
+
+    hash = LRUCache_Hash(0, &key->face, sizeof(key->face));
+    hash = LRUCache_Hash(hash, &key->ptSize, sizeof(key->ptSize));
+    hash = LRUCache_Hash(hash, key->matrix, sizeof(key->matrix));
+    hash = LRUCache_Hash(hash, &key->script, sizeof(key->script));
+    hash = LRUCache_Hash(hash, &key->flags, sizeof(key->flags));
+    hash = LRUCache_Hash(hash, &key->before, sizeof(key->before));
+    hash = LRUCache_Hash(hash, &key->after, sizeof(key->after));
+    return LRUCache_Hash(hash, key->text, textLength * sizeof(jchar));
+}
+
+static int matchShapeCacheEntry(JNIEnv* env, const LRUEntry* entry,
+                                const void* k) {
+    const ShapeCacheEntry* e = (const ShapeCacheEntry*) entry;
+    const ShapeKey* key = (const ShapeKey*) k;
+    int textLength = key->before + key->runLength + key->after;
+
+    return e->entry.owner == key->face &&
+           e->ptSize == key->ptSize &&
+           memcmp(e->matrix, key->matrix, sizeof(e->matrix)) == 0 &&
+           e->script == key->script &&
+           e->flags == key->flags &&
+           e->before == key->before &&
+           e->runLength == key->runLength &&
+           e->after == key->after &&
+           memcmp(e->text, key->text, textLength * sizeof(jchar)) == 0 &&
+           (*env)->IsSameObject(env, e->fontStrike, key->fontStrike);
+}
+
+/*
+ * Returns a copy of the cached glyphs and positions for the key, in one
+ * block that starts with the glyph infos, or NULL.
+ */
+static hb_glyph_info_t* getCachedShape(JNIEnv* env, const ShapeKey* key,
+                                       unsigned int hash, int* glyphCount) {
+    ShapeCacheEntry* e;
+    hb_glyph_info_t* glyphInfo = NULL;
+
+    if ((*env)->MonitorEnter(env, shapeCacheLock) != JNI_OK) {
+        return NULL;
+    }
+    e = (ShapeCacheEntry*)
+        LRUCache_Find(env, &shapeCache, hash, matchShapeCacheEntry, key);
+    if (e != NULL) {
+        size_t size = e->glyphCount *
+            (sizeof(hb_glyph_info_t) + sizeof(hb_glyph_position_t));
+        glyphInfo = (hb_glyph_info_t*) malloc(size > 0 ? size : 1);
+        if (glyphInfo != NULL) {
+            memcpy(glyphInfo, e->glyphInfo, size);
+            *glyphCount = e->glyphCount;
+        }
+    }
+    (*env)->MonitorExit(env, shapeCacheLock);
+    return glyphInfo;
+}
+
+static void putCachedShape(JNIEnv* env, const ShapeKey* key,
+                           unsigned int hash, int offset, int glyphCount,
+                           hb_glyph_info_t* glyphInfo,
+                           hb_glyph_position_t* glyphPos) {
+    int i, textLength = key->before + key->runLength + key->after;
+    size_t glyphSize = glyphCount *
+        (sizeof(hb_glyph_info_t) + sizeof(hb_glyph_position_t));
+    ShapeCacheEntry* e = (ShapeCacheEntry*) malloc(sizeof(ShapeCacheEntry) +
+        glyphSize + textLength * sizeof(jchar));
+
+    if (e == NULL) {
+        return;
+    }
+    e->fontStrike = (*env)->NewWeakGlobalRef(env, key->fontStrike);
+    if (e->fontStrike == NULL) {
+        free(e);
+        return;
+    }
+    e->entry.owner = key->face;
+    e->entry.hash = hash;
+    e->entry.size = sizeof(ShapeCacheEntry) +
+        glyphSize + textLength * sizeof(jchar);
+    e->ptSize = key->ptSize;
+    memcpy(e->matrix, key->matrix, sizeof(e->matrix));
+    e->script = key->script;
+    e->flags = key->flags;
+    e->before = key->before;
+    e->runLength = key->runLength;
+    e->after = key->after;
+    e->glyphCount = glyphCount;
+    e->glyphInfo = (hb_glyph_info_t*) (e + 1);
+    e->glyphPos = (hb_glyph_position_t*) (e->glyphInfo + glyphCount);
+    e->text = (jchar*) (e->glyphPos + glyphCount);
+    memcpy(e->glyphInfo, glyphInfo, glyphCount * sizeof(hb_glyph_info_t));
+    memcpy(e->glyphPos, glyphPos, glyphCount * sizeof(hb_glyph_position_t));
+    memcpy(e->text, key->text, textLength * sizeof(jchar));
+    for (i = 0; i < glyphCount; i++) {
+        e->glyphInfo[i].cluster -= offset;
+    }
+
+    if ((*env)->MonitorEnter(env, shapeCacheLock) != JNI_OK) {
+        freeShapeCacheEntry(env, &e->entry);
+        return;
+    }
+    /* another thread may have shaped the same run in the meantime */
+    if (LRUCache_Find(env, &shapeCache, hash,
+                      matchShapeCacheEntry, key) == NULL) {
+        LRUCache_Put(env, &shapeCache, &e->entry);
+        e = NULL;
+    }
+    (*env)->MonitorExit(env, shapeCacheLock);
+    if (e != NULL) {
+        freeShapeCacheEntry(env, &e->entry);
+    }
+}
+
+/* Called when the face is disposed */
+void purgeCachedShapes(JNIEnv* env, hb_face_t* face) {
+    if (!jniInited || (*env)->MonitorEnter(env, shapeCacheLock) != JNI_OK) {
+        return;
+    }
+    LRUCache_Purge(env, &shapeCache, face);
+    (*env)->MonitorExit(env, shapeCacheLock);
+}
+
 JNIEXPORT jboolean JNICALL Java_sun_font_SunLayoutEngine_shape
     (JNIEnv *env, jclass cls,
      jobject font2D,
@@ -257,6 +438,9 @@ JNIEXPORT jboolean JNICALL Java_sun_font_SunLayoutEngine_shape
      char* liga = (flags & TYPO_LIGA) ? "liga" : "-liga";
      jboolean ret;
      unsigned int buflen;
+     ShapeKey key;
+     unsigned int hash = 0;
+     jboolean useCache;
 
      JDKFontInfo *jdkFontInfo =
          createJDKFontInfo(env, font2D, fontStrike, ptSize, matrix);
@@ -268,6 +452,43 @@ JNIEXPORT jboolean JNICALL Java_sun_font_SunLayoutEngine_shape
      jdkFontInfo->fontStrike = fontStrike;
 
      hbface = (hb_face_t*) jlong_to_ptr(pFace);
+
+     chars = (*env)->GetCharArrayElements(env, text, NULL);
+     if ((*env)->ExceptionCheck(env)) {
+         free((void*)jdkFontInfo);
+         return JNI_FALSE;
+     }
+     len = (*env)->GetArrayLength(env, text);
+
+     useCache = offset >= 0 && offset <= limit && limit <= len &&
+                limit - offset <= SHAPE_CACHE_MAX_RUN && init_JNI_IDs(env);
+     if (useCache) {
+         key.face = hbface;
+         key.fontStrike = fontStrike;
+         key.ptSize = ptSize;
+         memcpy(key.matrix, jdkFontInfo->matrix, sizeof(key.matrix));
+         key.script = script;
+         key.flags = flags;
+         key.before = offset < SHAPE_CONTEXT_CHARS ? offset : SHAPE_CONTEXT_CHARS;
+         key.runLength = limit - offset;
+         key.after = len - limit < SHAPE_CONTEXT_CHARS ?
+                     len - limit : SHAPE_CONTEXT_CHARS;
+         key.text = chars + offset - key.before;
+         hash = hashShapeKey(&key);
+
+         glyphInfo = getCachedShape(env, &key, hash, &glyphCount);
+         if (glyphInfo != NULL) {
+             glyphPos = (hb_glyph_position_t*) (glyphInfo + glyphCount);
+             ret = storeGVData(env, gvdata, slot, baseIndex, 0, startPt,
+                               limit - offset, glyphCount, glyphInfo, glyphPos,
+                               jdkFontInfo->devScale);
+             free(glyphInfo);
+             free((void*)jdkFontInfo);
+             (*env)->ReleaseCharArrayElements(env, text, chars, JNI_ABORT);
+             return ret;
+         }
+     }
+
      hbfont = hb_jdk_font_create(hbface, jdkFontInfo, NULL);
 
      buffer = hb_buffer_create();
@@ -281,15 +502,6 @@ JNIEXPORT jboolean JNICALL Java_sun_font_SunLayoutEngine_shape
      hb_buffer_set_cluster_level(buffer,
                                  HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
 
-     chars = (*env)->GetCharArrayElements(env, text, NULL);
-     if ((*env)->ExceptionCheck(env)) {
-         hb_buffer_destroy(buffer);
-         hb_font_destroy(hbfont);
-         free((void*)jdkFontInfo);
-         return JNI_FALSE;
-     }
-     len = (*env)->GetArrayLength(env, text);
-
      hb_buffer_add_utf16(buffer, chars, len, offset, limit-offset);
 
      features = calloc(2, sizeof(hb_feature_t));
@@ -303,6 +515,13 @@ JNIEXPORT jboolean JNICALL Java_sun_font_SunLayoutEngine_shape
      glyphInfo = hb_buffer_get_glyph_infos(buffer, 0);
      glyphPos = hb_buffer_get_glyph_positions(buffer, &buflen);
 
+     /* results shaped without the features, or while the font callbacks
+        failed, are not reused */
+     if (useCache && features != NULL && !(*env)->ExceptionCheck(env)) {
+         putCachedShape(env, &key, hash, offset, glyphCount,
+                        glyphInfo, glyphPos);
+     }
+
      ret = storeGVData(env, gvdata, slot, baseIndex, offset, startPt,
                        limit - offset, glyphCount, glyphInfo, glyphPos,
                        jdkFontInfo->devScale);
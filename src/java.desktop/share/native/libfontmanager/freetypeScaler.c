@@ -45,6 +45,7 @@
 #include FT_MODULE_H
 
 #include "fontscaler.h"
+#include "lrucache.h"
 
 #define  ftFixed1  (FT_Fixed) (1 << 16)
 #define  FloatToFTFixed(f) (FT_Fixed)((f) * (float)(ftFixed1))
@@ -99,11 +100,178 @@ void z_error(char *s) {}
 
 static jmethodID invalidateScalerMID;
 
+/**************** Glyph image cache *****************/
+
+/* Rendered glyph images are cached natively, so that strikes with the same
+   size, transform and rendering settings share them, even across threads
+   and after the Java strike has been collected. Every call returns its own
+   copy, which the caller frees as before. */
+
+#define GLYPH_CACHE_SIZE (8 * 1024 * 1024)
+
+typedef struct {
+    FT_Fixed   xx, xy, yx, yy;   /* context transform */
+    int        ptsz;
+    jint       aaType;
+    jint       fmType;
+    jint       glyphCode;
+    jboolean   useSbits;
+    jboolean   doBold;
+    jboolean   doItalize;
+} GlyphCacheKey;
+
+typedef struct {
+    LRUEntry      entry;         /* owner is the FTScalerInfo */
+    GlyphCacheKey key;
+    int           imageSize;
+    GlyphInfo     info;          /* followed by the image */
+} GlyphCacheEntry;
+
+static void freeGlyphCacheEntry(JNIEnv *env, LRUEntry *entry) {
+    free(entry);
+}
+
+static LRUCache glyphCache =
+    LRU_CACHE_INITIALIZER(GLYPH_CACHE_SIZE, freeGlyphCacheEntry);
+static jobject glyphCacheLock = NULL;
+
+/* The scaler and the glyph key of a lookup */
+typedef struct {
+    FTScalerInfo  *scalerInfo;
+    GlyphCacheKey key;
+} GlyphLookup;
+
+static int matchGlyphCacheEntry(JNIEnv *env, const LRUEntry *entry,
+                                const void *key) {
+    const GlyphCacheEntry *e = (const GlyphCacheEntry *) entry;
+    const GlyphLookup *lookup = (const GlyphLookup *) key;
+
+    return e->entry.owner == lookup->scalerInfo &&
+           memcmp(&e->key, &lookup->key, sizeof(GlyphCacheKey)) == 0;
+}
+
+static unsigned int initGlyphLookup(GlyphLookup *lookup,
+                                    FTScalerInfo *scalerInfo,
+                                    FTScalerContext *context,
+                                    jint glyphCode) {
+    memset(lookup, 0, sizeof(GlyphLookup));
+    lookup->scalerInfo = scalerInfo;
+    lookup->key.xx = context->transform.xx;
+    lookup->key.xy = context->transform.xy;
+    lookup->key.yx = context->transform.yx;
+    lookup->key.yy = context->transform.yy;
+    lookup->key.ptsz = context->ptsz;
+    lookup->key.aaType = context->aaType;
+    lookup->key.fmType = context->fmType;
+    lookup->key.glyphCode = glyphCode;
+    lookup->key.useSbits = context->useSbits;
+    lookup->key.doBold = context->doBold;
+    lookup->key.doItalize = context->doItalize;
+
+    return LRUCache_Hash(0, lookup, sizeof(GlyphLookup));
+}
+
+/* Returns a copy of the cached image of the glyph, or only its advance if
+   renderImage is false, or NULL if the glyph is not cached. */
+static GlyphInfo* getCachedGlyphImage(JNIEnv *env,
+                                      FTScalerInfo *scalerInfo,
+                                      FTScalerContext *context,
+                                      jint glyphCode,
+                                      jboolean renderImage) {
+    GlyphLookup lookup;
+    GlyphCacheEntry *e;
+    GlyphInfo *glyphInfo = NULL;
+    unsigned int hash = initGlyphLookup(&lookup, scalerInfo, context, glyphCode);
+
+    if (glyphCacheLock == NULL ||
+        (*env)->MonitorEnter(env, glyphCacheLock) != JNI_OK) {
+        return NULL;
+    }
+    e = (GlyphCacheEntry *) LRUCache_Find(env, &glyphCache, hash,
+                                          matchGlyphCacheEntry, &lookup);
+    if (e != NULL) {
+        if (renderImage) {
+            glyphInfo = (GlyphInfo*) malloc(sizeof(GlyphInfo) + e->imageSize);
+            if (glyphInfo != NULL) {
+                memcpy(glyphInfo, &e->info, sizeof(GlyphInfo) + e->imageSize);
+                if (e->imageSize != 0) {
+                    glyphInfo->image = (unsigned char*) glyphInfo + sizeof(GlyphInfo);
+                }
+            }
+        } else {
+            glyphInfo = (GlyphInfo*) calloc(1, sizeof(GlyphInfo));
+            if (glyphInfo != NULL) {
+                glyphInfo->advanceX = e->info.advanceX;
+                glyphInfo->advanceY = e->info.advanceY;
+            }
+        }
+    }
+    (*env)->MonitorExit(env, glyphCacheLock);
+
+    return glyphInfo;
+}
+
+static void putCachedGlyphImage(JNIEnv *env,
+                                FTScalerInfo *scalerInfo,
+                                FTScalerContext *context,
+                                jint glyphCode,
+                                GlyphInfo *glyphInfo,
+                                int imageSize) {
+    GlyphLookup lookup;
+    GlyphCacheEntry *e;
+    unsigned int hash = initGlyphLookup(&lookup, scalerInfo, context, glyphCode);
+
+    if (glyphCacheLock == NULL) {
+        return;
+    }
+    e = (GlyphCacheEntry *) malloc(sizeof(GlyphCacheEntry) + imageSize);
+    if (e == NULL) {
+        return;
+    }
+    e->entry.owner = scalerInfo;
+    e->entry.hash = hash;
+    e->entry.size = sizeof(GlyphCacheEntry) + imageSize;
+    memcpy(&e->key, &lookup.key, sizeof(GlyphCacheKey));
+    e->imageSize = imageSize;
+    memcpy(&e->info, glyphInfo, sizeof(GlyphInfo) + imageSize);
+    e->info.image = NULL; /* set in the copies */
+
+    if ((*env)->MonitorEnter(env, glyphCacheLock) != JNI_OK) {
+        free(e);
+        return;
+    }
+    /* another thread may have rendered it in the meantime */
+    if (LRUCache_Find(env, &glyphCache, hash,
+                      matchGlyphCacheEntry, &lookup) == NULL) {
+        LRUCache_Put(env, &glyphCache, &e->entry);
+        e = NULL;
+    }
+    (*env)->MonitorExit(env, glyphCacheLock);
+    free(e);
+}
+
+static void purgeCachedGlyphImages(JNIEnv *env, FTScalerInfo *scalerInfo) {
+    if (glyphCacheLock == NULL ||
+        (*env)->MonitorEnter(env, glyphCacheLock) != JNI_OK) {
+        return;
+    }
+    LRUCache_Purge(env, &glyphCache, scalerInfo);
+    (*env)->MonitorExit(env, glyphCacheLock);
+}
+
 JNIEXPORT void JNICALL
 Java_sun_font_FreetypeFontScaler_initIDs(
         JNIEnv *env, jobject scaler, jclass FFSClass) {
+    jclass objectClass;
+    jobject lock;
+
     invalidateScalerMID =
         (*env)->GetMethodID(env, FFSClass, "invalidateScaler", "()V");
+    CHECK_NULL(invalidateScalerMID);
+
+    CHECK_NULL(objectClass = (*env)->FindClass(env, "java/lang/Object"));
+    CHECK_NULL(lock = (*env)->AllocObject(env, objectClass));
+    glyphCacheLock = (*env)->NewGlobalRef(env, lock);
 }
 
 static void freeNativeResources(JNIEnv *env, FTScalerInfo* scalerInfo) {
@@ -111,6 +279,8 @@ static void freeNativeResources(JNIEnv *env, FTScalerInfo* scalerInfo) {
     if (scalerInfo == NULL)
         return;
 
+    purgeCachedGlyphImages(env, scalerInfo);
+
     // FT_Done_Face always closes the stream, but only frees the memory
     // of the data structure if it was internally allocated by FT.
     // We hold on to a pointer to the stream structure if we provide it
@@ -853,6 +1023,12 @@ static jlong
         return ptr_to_jlong(getNullGlyphImage());
     }
 
+    glyphInfo = getCachedGlyphImage(env, scalerInfo, context,
+                                    glyphCode, renderImage);
+    if (glyphInfo != NULL) {
+        return ptr_to_jlong(glyphInfo);
+    }
+
     error = setupFTContext(env, font2D, scalerInfo, context);
     if (error) {
         invalidateJavaScaler(env, scaler, scalerInfo);
@@ -1032,10 +1208,15 @@ static jlong
             glyphInfo->rowBytes *=3;
         } else {
             free(glyphInfo);
-            glyphInfo = getNullGlyphImage();
+            return ptr_to_jlong(getNullGlyphImage());
         }
     }
 
+    if (renderImage) {
+        putCachedGlyphImage(env, scalerInfo, context,
+                            glyphCode, glyphInfo, imageSize);
+    }
+
     return ptr_to_jlong(glyphInfo);
 }
 
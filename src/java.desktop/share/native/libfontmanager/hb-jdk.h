@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2015, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -70,6 +70,10 @@ hb_jdk_font_create(hb_face_t* hbFace,
 void
 hb_jdk_font_set_funcs(hb_font_t *font);
 
+/* Drops the shaping results cached for the face (HBShaper.c). */
+void
+purgeCachedShapes(JNIEnv* env, hb_face_t* face);
+
 
 # ifdef __cplusplus
 }
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "lrucache.h"
+
+/* FNV-1a */
+unsigned int LRUCache_Hash(unsigned int hash, const void *data, size_t size) {
+    const unsigned char *p = (const unsigned char *) data;
+
+    if (hash == 0) {
+        hash = 2166136261u;
+    }
+    while (size-- > 0) {
+        hash = (hash ^ *p++) * 16777619u;
+    }
+    return hash;
+}
+
+static void unlinkEntry(LRUEntry *entry) {
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+}
+
+static void linkFirst(LRUCache *cache, LRUEntry *entry) {
+    if (cache->head.next == NULL) {
+        cache->head.next = cache->head.prev = &cache->head;
+    }
+    entry->prev = &cache->head;
+    entry->next = cache->head.next;
+    entry->next->prev = entry;
+    cache->head.next = entry;
+}
+
+static void removeEntry(JNIEnv *env, LRUCache *cache, LRUEntry *entry) {
+    LRUEntry **p = &cache->buckets[entry->hash % LRU_BUCKETS];
+
+    while (*p != entry) {
+        p = &(*p)->hashNext;
+    }
+    *p = entry->hashNext;
+    unlinkEntry(entry);
+    cache->size -= entry->size;
+    cache->freeEntry(env, entry);
+}
+
+LRUEntry *LRUCache_Find(JNIEnv *env, LRUCache *cache, unsigned int hash,
+                        LRUMatchFunc *match, const void *key) {
+    LRUEntry *entry = cache->buckets[hash % LRU_BUCKETS];
+
+    for (; entry != NULL; entry = entry->hashNext) {
+        if (entry->hash == hash && match(env, entry, key)) {
+            unlinkEntry(entry);
+            linkFirst(cache, entry);
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void LRUCache_Put(JNIEnv *env, LRUCache *cache, LRUEntry *entry) {
+    LRUEntry **bucket = &cache->buckets[entry->hash % LRU_BUCKETS];
+
+    if (entry->size > cache->maxSize) {
+        cache->freeEntry(env, entry);
+        return;
+    }
+    while (cache->size + entry->size > cache->maxSize) {
+        removeEntry(env, cache, cache->head.prev);
+    }
+    entry->hashNext = *bucket;
+    *bucket = entry;
+    linkFirst(cache, entry);
+    cache->size += entry->size;
+}
+
+void LRUCache_Purge(JNIEnv *env, LRUCache *cache, const void *owner) {
+    LRUEntry *entry, *next;
+
+    if (cache->head.next == NULL) {
+        return;
+    }
+    for (entry = cache->head.next; entry != &cache->head; entry = next) {
+        next = entry->next;
+        if (entry->owner == owner) {
+            removeEntry(env, cache, entry);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <stddef.h>
+#include "jni.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/* A hash table of native entries limited to a total size in bytes, that
+ * evicts the least recently used entries to make room for new ones.
+ * It is used to share rasterized glyphs and shaping results between
+ * strikes and threads.
+ *
+ * Entries are structs whose first member is an LRUEntry.  Every entry
+ * belongs to an owner (e.g. a scaler or face), and all the entries of an
+ * owner are removed when the owner goes away.  The cache does no locking:
+ * callers hold a JNI monitor around every call.
+ */
+
+#define LRU_BUCKETS 1024
+
+typedef struct LRUEntry {
+    struct LRUEntry *hashNext;
+    struct LRUEntry *prev;      /* usage list, most recently used first */
+    struct LRUEntry *next;
+    const void *owner;
+    unsigned int hash;
+    size_t size;                /* bytes counted against the limit */
+} LRUEntry;
+
+/* Returns non zero if the entry has the given key */
+typedef int LRUMatchFunc(JNIEnv *env, const LRUEntry *entry, const void *key);
+
+/* Releases an entry removed from the cache */
+typedef void LRUFreeFunc(JNIEnv *env, LRUEntry *entry);
+
+typedef struct {
+    LRUEntry *buckets[LRU_BUCKETS];
+    LRUEntry head;              /* sentinel of the usage list */
+    size_t size;
+    size_t maxSize;
+    LRUFreeFunc *freeEntry;
+} LRUCache;
+
+#define LRU_CACHE_INITIALIZER(maxSize, freeEntry) \
+    { { NULL }, { NULL, NULL, NULL, NULL, 0, 0 }, 0, (maxSize), (freeEntry) }
+
+unsigned int LRUCache_Hash(unsigned int hash, const void *data, size_t size);
+
+/* Returns the entry with the hash and key, made the most recently used
+ * one, or NULL.
+ */
+LRUEntry *LRUCache_Find(JNIEnv *env, LRUCache *cache, unsigned int hash,
+                        LRUMatchFunc *match, const void *key);
+
+/* Adds an entry, whose owner, hash and size are set, evicting older entries
+ * as needed.  Entries bigger than the cache are freed right away.
+ */
+void LRUCache_Put(JNIEnv *env, LRUCache *cache, LRUEntry *entry);
+
+/* Frees all the entries of the owner */
+void LRUCache_Purge(JNIEnv *env, LRUCache *cache, const void *owner);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif
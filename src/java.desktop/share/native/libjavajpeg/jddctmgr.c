@@ -23,6 +23,7 @@
 #include "jinclude.h"
 #include "jpeglib.h"
 #include "jdct.h"               /* Private declarations for DCT subsystem */
+#include "jsimd.h"
 
 
 /*
@@ -122,6 +123,10 @@ start_pass (j_decompress_ptr cinfo)
 #ifdef DCT_ISLOW_SUPPORTED
       case JDCT_ISLOW:
         method_ptr = jpeg_idct_islow;
+#ifdef JSIMD_X86
+        if (jsimd_can_idct_islow())
+          method_ptr = jsimd_idct_islow;
+#endif
         method = JDCT_ISLOW;
         break;
 #endif
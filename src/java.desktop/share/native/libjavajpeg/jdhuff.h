@@ -73,14 +73,21 @@ EXTERN(void) jpeg_make_d_derived_tbl
  * necessary.
  */
 
+#if defined(_LP64) || defined(_WIN64)
+typedef size_t bit_buf_type;    /* type of bit-extraction buffer */
+#define BIT_BUF_SIZE  64        /* size of buffer in bits */
+#else
 typedef INT32 bit_buf_type;     /* type of bit-extraction buffer */
 #define BIT_BUF_SIZE  32        /* size of buffer in bits */
+#endif
 
 /* If long is > 32 bits on your machine, and shifting/masking longs is
  * reasonably fast, making bit_buf_type be long and setting BIT_BUF_SIZE
  * appropriately should be a win.  Unfortunately we can't define the size
  * with something like  #define BIT_BUF_SIZE (sizeof(bit_buf_type)*8)
  * because not all machines measure sizeof in 8-bit bytes.
+ * On 64-bit targets a size_t buffer lets jpeg_fill_bit_buffer load up to
+ * seven bytes per call instead of three.
  */
 
 typedef struct {                /* Bitreading state saved across MCUs */
@@ -25,6 +25,7 @@
 #define JPEG_INTERNALS
 #include "jinclude.h"
 #include "jpeglib.h"
+#include "jsimd.h"
 
 
 /* Pointer to routine to upsample a single component */
@@ -451,15 +452,23 @@ jinit_upsampler (j_decompress_ptr cinfo)
     } else if (h_in_group * 2 == h_out_group &&
                v_in_group == v_out_group) {
       /* Special cases for 2h1v upsampling */
-      if (do_fancy && compptr->downsampled_width > 2)
+      if (do_fancy && compptr->downsampled_width > 2) {
         upsample->methods[ci] = h2v1_fancy_upsample;
-      else
+#ifdef JSIMD_X86
+        if (jsimd_can_fancy_upsample())
+          upsample->methods[ci] = jsimd_h2v1_fancy_upsample;
+#endif
+      } else
         upsample->methods[ci] = h2v1_upsample;
     } else if (h_in_group * 2 == h_out_group &&
                v_in_group * 2 == v_out_group) {
       /* Special cases for 2h2v upsampling */
       if (do_fancy && compptr->downsampled_width > 2) {
         upsample->methods[ci] = h2v2_fancy_upsample;
+#ifdef JSIMD_X86
+        if (jsimd_can_fancy_upsample())
+          upsample->methods[ci] = jsimd_h2v2_fancy_upsample;
+#endif
         upsample->pub.need_context_rows = TRUE;
       } else
         upsample->methods[ci] = h2v2_upsample;
@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * jsimd.c
+ *
+ * This file contains the x86-64 vector versions of the inverse DCT, the
+ * YCbCr->RGB conversion and the fancy upsampling of the decompressor.
+ * See jsimd.h.
+ *
+ * The arithmetic follows the portable routines step by step, with the
+ * same constants, rounding and 32-bit intermediate results, so that the
+ * output is bit-exact; only the order of the work differs.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jdct.h"               /* Private declarations for DCT subsystem */
+#include "jsimd.h"
+
+#ifdef JSIMD_X86
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <tmmintrin.h>
+
+#define JSIMD_UNKNOWN  (-1)
+
+static int has_ssse3 = JSIMD_UNKNOWN;
+static int has_sse41 = JSIMD_UNKNOWN;
+
+/* Races only store the same values twice. */
+LOCAL(void)
+jsimd_detect (void)
+{
+  unsigned int eax, ebx, ecx, edx;
+  int ssse3 = 0, sse41 = 0;
+
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    ssse3 = (ecx & bit_SSSE3) != 0;
+    sse41 = ssse3 && (ecx & bit_SSE4_1) != 0;
+  }
+  has_ssse3 = ssse3;
+  has_sse41 = sse41;
+}
+
+GLOBAL(boolean)
+jsimd_can_idct_islow (void)
+{
+  /* The multiplier table is loaded as 32-bit ints */
+  if (SIZEOF(ISLOW_MULT_TYPE) != 4)
+    return FALSE;
+  if (has_sse41 == JSIMD_UNKNOWN)
+    jsimd_detect();
+  return has_sse41 ? TRUE : FALSE;
+}
+
+GLOBAL(boolean)
+jsimd_can_ycc_rgb (void)
+{
+  if (RGB_RED != 0 || RGB_GREEN != 1 || RGB_BLUE != 2 || RGB_PIXELSIZE != 3)
+    return FALSE;
+  if (has_ssse3 == JSIMD_UNKNOWN)
+    jsimd_detect();
+  return has_ssse3 ? TRUE : FALSE;
+}
+
+GLOBAL(boolean)
+jsimd_can_fancy_upsample (void)
+{
+  return TRUE;                  /* SSE2 is part of x86-64 */
+}
+
+
+/**************** Inverse DCT **************/
+
+/* The constants and scaling of jidctint.c. */
+
+#define CONST_BITS  13
+#define PASS1_BITS  2
+
+#define FIX_0_298631336  2446
+#define FIX_0_390180644  3196
+#define FIX_0_541196100  4433
+#define FIX_0_765366865  6270
+#define FIX_0_899976223  7373
+#define FIX_1_175875602  9633
+#define FIX_1_501321110  12299
+#define FIX_1_847759065  15137
+#define FIX_1_961570560  16069
+#define FIX_2_053119869  16819
+#define FIX_2_562915447  20995
+#define FIX_3_072711026  25172
+
+#define MUL32(v,c)  _mm_mullo_epi32(v, _mm_set1_epi32(c))
+
+#define TRANSPOSE_4X4(r0,r1,r2,r3)  \
+  { __m128i t0 = _mm_unpacklo_epi32(r0, r1);  \
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);  \
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);  \
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);  \
+    r0 = _mm_unpacklo_epi64(t0, t1);  \
+    r1 = _mm_unpackhi_epi64(t0, t1);  \
+    r2 = _mm_unpacklo_epi64(t2, t3);  \
+    r3 = _mm_unpackhi_epi64(t2, t3); }
+
+/*
+ * One 1-D pass of jpeg_idct_islow on four independent lanes, descaled by
+ * the given number of bits.  The zero-AC shortcuts of the portable code
+ * give the same results as the full calculation, so they are not needed.
+ */
+
+__attribute__((target("sse4.1")))
+static inline void
+idct_islow_pass (__m128i v[DCTSIZE], int descale)
+{
+  __m128i tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+  __m128i z1, z2, z3, z4, z5, round;
+
+  /* Even part */
+  z2 = v[2];
+  z3 = v[6];
+  z1 = MUL32(_mm_add_epi32(z2, z3), FIX_0_541196100);
+  tmp2 = _mm_add_epi32(z1, MUL32(z3, - FIX_1_847759065));
+  tmp3 = _mm_add_epi32(z1, MUL32(z2, FIX_0_765366865));
+
+  tmp0 = _mm_slli_epi32(_mm_add_epi32(v[0], v[4]), CONST_BITS);
+  tmp1 = _mm_slli_epi32(_mm_sub_epi32(v[0], v[4]), CONST_BITS);
+
+  tmp10 = _mm_add_epi32(tmp0, tmp3);
+  tmp13 = _mm_sub_epi32(tmp0, tmp3);
+  tmp11 = _mm_add_epi32(tmp1, tmp2);
+  tmp12 = _mm_sub_epi32(tmp1, tmp2);
+
+  /* Odd part */
+  tmp0 = v[7];
+  tmp1 = v[5];
+  tmp2 = v[3];
+  tmp3 = v[1];
+
+  z1 = _mm_add_epi32(tmp0, tmp3);
+  z2 = _mm_add_epi32(tmp1, tmp2);
+  z3 = _mm_add_epi32(tmp0, tmp2);
+  z4 = _mm_add_epi32(tmp1, tmp3);
+  z5 = MUL32(_mm_add_epi32(z3, z4), FIX_1_175875602);
+
+  tmp0 = MUL32(tmp0, FIX_0_298631336);
+  tmp1 = MUL32(tmp1, FIX_2_053119869);
+  tmp2 = MUL32(tmp2, FIX_3_072711026);
+  tmp3 = MUL32(tmp3, FIX_1_501321110);
+  z1 = MUL32(z1, - FIX_0_899976223);
+  z2 = MUL32(z2, - FIX_2_562915447);
+  z3 = _mm_add_epi32(MUL32(z3, - FIX_1_961570560), z5);
+  z4 = _mm_add_epi32(MUL32(z4, - FIX_0_390180644), z5);
+
+  tmp0 = _mm_add_epi32(tmp0, _mm_add_epi32(z1, z3));
+  tmp1 = _mm_add_epi32(tmp1, _mm_add_epi32(z2, z4));
+  tmp2 = _mm_add_epi32(tmp2, _mm_add_epi32(z2, z3));
+  tmp3 = _mm_add_epi32(tmp3, _mm_add_epi32(z1, z4));
+
+  /* Final output stage, with DESCALE */
+  round = _mm_set1_epi32(1 << (descale - 1));
+  tmp10 = _mm_add_epi32(tmp10, round);
+  tmp11 = _mm_add_epi32(tmp11, round);
+  tmp12 = _mm_add_epi32(tmp12, round);
+  tmp13 = _mm_add_epi32(tmp13, round);
+
+  v[0] = _mm_srai_epi32(_mm_add_epi32(tmp10, tmp3), descale);
+  v[7] = _mm_srai_epi32(_mm_sub_epi32(tmp10, tmp3), descale);
+  v[1] = _mm_srai_epi32(_mm_add_epi32(tmp11, tmp2), descale);
+  v[6] = _mm_srai_epi32(_mm_sub_epi32(tmp11, tmp2), descale);
+  v[2] = _mm_srai_epi32(_mm_add_epi32(tmp12, tmp1), descale);
+  v[5] = _mm_srai_epi32(_mm_sub_epi32(tmp12, tmp1), descale);
+  v[3] = _mm_srai_epi32(_mm_add_epi32(tmp13, tmp0), descale);
+  v[4] = _mm_srai_epi32(_mm_sub_epi32(tmp13, tmp0), descale);
+}
+
+/*
+ * Range-limit as range_limit[x & RANGE_MASK] does with the table set up by
+ * prepare_range_limit_table(): the low 10 bits are taken as a signed value,
+ * offset by CENTERJSAMPLE and clamped to 0..MAXJSAMPLE.  The clamping is
+ * left to the saturating packs.
+ */
+
+#define RANGE_LIMIT(v)  \
+  _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(v, 22), 22),  \
+                _mm_set1_epi32(CENTERJSAMPLE))
+
+/*
+ * Transposes the four rows held in column halves lo and hi back, then
+ * stores them as samples.
+ */
+
+__attribute__((target("sse4.1")))
+static inline void
+idct_store_rows (__m128i lo[4], __m128i hi[4],
+                 JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  int i;
+
+  TRANSPOSE_4X4(lo[0], lo[1], lo[2], lo[3]);
+  TRANSPOSE_4X4(hi[0], hi[1], hi[2], hi[3]);
+  for (i = 0; i < 4; i++) {
+    __m128i row = _mm_packs_epi32(RANGE_LIMIT(lo[i]), RANGE_LIMIT(hi[i]));
+    _mm_storel_epi64((__m128i *) (output_buf[i] + output_col),
+                     _mm_packus_epi16(row, row));
+  }
+}
+
+__attribute__((target("sse4.1")))
+GLOBAL(void)
+jsimd_idct_islow (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+                  JCOEFPTR coef_block,
+                  JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  ISLOW_MULT_TYPE * quantptr = (ISLOW_MULT_TYPE *) compptr->dct_table;
+  __m128i left[DCTSIZE], right[DCTSIZE];  /* columns 0..3 and 4..7 */
+  __m128i v[DCTSIZE];
+  int i;
+
+  /* Pass 1: dequantize and process columns, four at a time. */
+
+  for (i = 0; i < DCTSIZE; i++) {
+    __m128i coef = _mm_loadu_si128((const __m128i *) (coef_block + i*DCTSIZE));
+    left[i] = _mm_mullo_epi32(_mm_cvtepi16_epi32(coef),
+      _mm_loadu_si128((const __m128i *) (quantptr + i*DCTSIZE)));
+    right[i] = _mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(coef, 8)),
+      _mm_loadu_si128((const __m128i *) (quantptr + i*DCTSIZE + 4)));
+  }
+  idct_islow_pass(left, CONST_BITS-PASS1_BITS);
+  idct_islow_pass(right, CONST_BITS-PASS1_BITS);
+
+  /* Pass 2: process rows 0..3 and then 4..7 of the work array. */
+
+  for (i = 0; i < DCTSIZE; i += 4) {
+    v[0] = left[i];  v[1] = left[i+1];  v[2] = left[i+2];  v[3] = left[i+3];
+    v[4] = right[i]; v[5] = right[i+1]; v[6] = right[i+2]; v[7] = right[i+3];
+    TRANSPOSE_4X4(v[0], v[1], v[2], v[3]);
+    TRANSPOSE_4X4(v[4], v[5], v[6], v[7]);
+    idct_islow_pass(v, CONST_BITS+PASS1_BITS+3);
+    idct_store_rows(v, v + 4, output_buf + i, output_col);
+  }
+}
+
+
+/**************** YCbCr->RGB conversion **************/
+
+/*
+ * The constants of build_ycc_rgb_table() in jdcolor.c, split so that the
+ * products fit 16-bit multipliers:
+ *   R = y + cr + ((26345*cr + ONE_HALF) >> 16)           (FIX(1.40200))
+ *   B = y + 2*cb + ((-14942*cb + ONE_HALF) >> 16)        (FIX(1.77200))
+ *   G = y - cr + ((-22554*cb + 18734*cr + ONE_HALF) >> 16)
+ * where cb and cr are centered on zero.  Adding a multiple of 1 << 16
+ * before the shift changes nothing but the integer part, so these are
+ * exactly the table values.
+ */
+
+#define YCC_R_CR   26345        /* FIX(1.40200) - 65536 */
+#define YCC_B_CB   (-14942)     /* FIX(1.77200) - 2*65536 */
+#define YCC_G_CB   (-22554)     /* -FIX(0.34414) */
+#define YCC_G_CR   18734        /* 65536 - FIX(0.71414) */
+
+/* pshufb masks interleaving 16 R, G and B samples into 48 bytes */
+static const signed char rgb_shuffle[3][3][16] = {
+  { { 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5 },
+    { -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1 },
+    { -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1 } },
+  { { -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1 },
+    { 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10 },
+    { -1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1 } },
+  { { -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1 },
+    { -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1 },
+    { 10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15 } }
+};
+
+/* Returns the rounded high halves of the 32-bit sums of products a and b. */
+
+__attribute__((target("ssse3")))
+static inline __m128i
+ycc_descale (__m128i a, __m128i b)
+{
+  __m128i half = _mm_set1_epi32(1 << 15);
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(a, half), 16),
+                         _mm_srai_epi32(_mm_add_epi32(b, half), 16));
+}
+
+/* Converts eight pixels given as 16-bit y and centered cb, cr. */
+
+__attribute__((target("ssse3")))
+static inline void
+ycc_rgb_8 (__m128i y, __m128i cb, __m128i cr,
+           __m128i * r, __m128i * g, __m128i * b)
+{
+  __m128i cbcr_lo = _mm_unpacklo_epi16(cb, cr);
+  __m128i cbcr_hi = _mm_unpackhi_epi16(cb, cr);
+  __m128i rmul = _mm_set1_epi32(YCC_R_CR << 16);      /* (0, R_CR) */
+  __m128i bmul = _mm_set1_epi32(YCC_B_CB & 0xFFFF);   /* (B_CB, 0) */
+  __m128i gmul = _mm_set1_epi32((YCC_G_CR << 16) | (YCC_G_CB & 0xFFFF));
+
+  *r = _mm_add_epi16(_mm_add_epi16(y, cr),
+                     ycc_descale(_mm_madd_epi16(cbcr_lo, rmul),
+                                 _mm_madd_epi16(cbcr_hi, rmul)));
+  *b = _mm_add_epi16(_mm_add_epi16(y, _mm_add_epi16(cb, cb)),
+                     ycc_descale(_mm_madd_epi16(cbcr_lo, bmul),
+                                 _mm_madd_epi16(cbcr_hi, bmul)));
+  *g = _mm_add_epi16(_mm_sub_epi16(y, cr),
+                     ycc_descale(_mm_madd_epi16(cbcr_lo, gmul),
+                                 _mm_madd_epi16(cbcr_hi, gmul)));
+}
+
+__attribute__((target("ssse3")))
+GLOBAL(void)
+jsimd_ycc_rgb_convert (j_decompress_ptr cinfo,
+                       JSAMPIMAGE input_buf, JDIMENSION input_row,
+                       JSAMPARRAY output_buf, int num_rows)
+{
+  JDIMENSION num_cols = cinfo->output_width;
+  JSAMPLE * range_limit = cinfo->sample_range_limit;
+  __m128i zero = _mm_setzero_si128();
+  __m128i center = _mm_set1_epi16(CENTERJSAMPLE);
+  __m128i shuf[3][3];
+  JSAMPROW outptr, inptr0, inptr1, inptr2;
+  JDIMENSION col;
+  int i, j;
+
+  for (i = 0; i < 3; i++)
+    for (j = 0; j < 3; j++)
+      shuf[i][j] = _mm_loadu_si128((const __m128i *) rgb_shuffle[i][j]);
+
+  while (--num_rows >= 0) {
+    inptr0 = input_buf[0][input_row];
+    inptr1 = input_buf[1][input_row];
+    inptr2 = input_buf[2][input_row];
+    input_row++;
+    outptr = *output_buf++;
+    for (col = 0; col + 16 <= num_cols; col += 16) {
+      __m128i y = _mm_loadu_si128((const __m128i *) (inptr0 + col));
+      __m128i cb = _mm_loadu_si128((const __m128i *) (inptr1 + col));
+      __m128i cr = _mm_loadu_si128((const __m128i *) (inptr2 + col));
+      __m128i rl, gl, bl, rh, gh, bh, r, g, b;
+
+      ycc_rgb_8(_mm_unpacklo_epi8(y, zero),
+                _mm_sub_epi16(_mm_unpacklo_epi8(cb, zero), center),
+                _mm_sub_epi16(_mm_unpacklo_epi8(cr, zero), center),
+                &rl, &gl, &bl);
+      ycc_rgb_8(_mm_unpackhi_epi8(y, zero),
+                _mm_sub_epi16(_mm_unpackhi_epi8(cb, zero), center),
+                _mm_sub_epi16(_mm_unpackhi_epi8(cr, zero), center),
+                &rh, &gh, &bh);
+      /* Range-limiting is the unsigned saturation of the packs. */
+      r = _mm_packus_epi16(rl, rh);
+      g = _mm_packus_epi16(gl, gh);
+      b = _mm_packus_epi16(bl, bh);
+
+      for (i = 0; i < 3; i++) {
+        __m128i out = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r, shuf[i][0]),
+                                                _mm_shuffle_epi8(g, shuf[i][1])),
+                                   _mm_shuffle_epi8(b, shuf[i][2]));
+        _mm_storeu_si128((__m128i *) (outptr + 16*i), out);
+      }
+      outptr += 16 * RGB_PIXELSIZE;
+    }
+    /* Remaining pixels, with the same arithmetic */
+    for (; col < num_cols; col++) {
+      int y  = GETJSAMPLE(inptr0[col]);
+      int cb = GETJSAMPLE(inptr1[col]) - CENTERJSAMPLE;
+      int cr = GETJSAMPLE(inptr2[col]) - CENTERJSAMPLE;
+      outptr[RGB_RED] =   range_limit[y + cr +
+                              ((YCC_R_CR * cr + (1 << 15)) >> 16)];
+      outptr[RGB_GREEN] = range_limit[y - cr +
+                              ((YCC_G_CB * cb + YCC_G_CR * cr + (1 << 15)) >> 16)];
+      outptr[RGB_BLUE] =  range_limit[y + 2 * cb +
+                              ((YCC_B_CB * cb + (1 << 15)) >> 16)];
+      outptr += RGB_PIXELSIZE;
+    }
+  }
+}
+
+
+/**************** Fancy upsampling **************/
+
+/*
+ * These work on eight input samples at a time, reading the neighbours on
+ * both sides, so the first and last columns and the tail of each row are
+ * done as in jdsample.c.
+ */
+
+#define LOAD8(p)  _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (p)),  \
+                                    _mm_setzero_si128())
+
+/* Stores the interleaved even and odd outputs as 16 samples. */
+#define STORE16(p,even,odd)  \
+  _mm_storeu_si128((__m128i *) (p),  \
+                   _mm_packus_epi16(_mm_unpacklo_epi16(even, odd),  \
+                                    _mm_unpackhi_epi16(even, odd)))
+
+GLOBAL(void)
+jsimd_h2v1_fancy_upsample (j_decompress_ptr cinfo,
+                           jpeg_component_info * compptr,
+                           JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr)
+{
+  JSAMPARRAY output_data = *output_data_ptr;
+  JDIMENSION width = compptr->downsampled_width;
+  __m128i one = _mm_set1_epi16(1), two = _mm_set1_epi16(2);
+  JSAMPROW inptr, outptr;
+  JDIMENSION col;
+  int inrow, invalue;
+
+  for (inrow = 0; inrow < cinfo->max_v_samp_factor; inrow++) {
+    inptr = input_data[inrow];
+    outptr = output_data[inrow];
+    /* Special case for first column */
+    invalue = GETJSAMPLE(inptr[0]);
+    outptr[0] = (JSAMPLE) invalue;
+    outptr[1] = (JSAMPLE) ((invalue * 3 + GETJSAMPLE(inptr[1]) + 2) >> 2);
+
+    /* General case: 3/4 * nearer pixel + 1/4 * further pixel */
+    for (col = 1; col + 9 <= width; col += 8) {
+      __m128i cur = LOAD8(inptr + col);
+      __m128i cur3 = _mm_add_epi16(cur, _mm_add_epi16(cur, cur));
+      __m128i even = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(cur3, one),
+                                                  LOAD8(inptr + col - 1)), 2);
+      __m128i odd = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(cur3, two),
+                                                 LOAD8(inptr + col + 1)), 2);
+      STORE16(outptr + 2 * col, even, odd);
+    }
+    for (; col < width - 1; col++) {
+      invalue = GETJSAMPLE(inptr[col]) * 3;
+      outptr[2 * col] = (JSAMPLE) ((invalue + GETJSAMPLE(inptr[col-1]) + 1) >> 2);
+      outptr[2 * col + 1] = (JSAMPLE) ((invalue + GETJSAMPLE(inptr[col+1]) + 2) >> 2);
+    }
+
+    /* Special case for last column */
+    invalue = GETJSAMPLE(inptr[col]);
+    outptr[2 * col] = (JSAMPLE) ((invalue * 3 + GETJSAMPLE(inptr[col-1]) + 1) >> 2);
+    outptr[2 * col + 1] = (JSAMPLE) invalue;
+  }
+}
+
+/* Column sums 3 * nearer row + further row of eight samples at p */
+#define COLSUM8(p0,p1,off)  \
+  _mm_add_epi16(_mm_mullo_epi16(LOAD8((p0) + (off)), three),  \
+                LOAD8((p1) + (off)))
+
+GLOBAL(void)
+jsimd_h2v2_fancy_upsample (j_decompress_ptr cinfo,
+                           jpeg_component_info * compptr,
+                           JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr)
+{
+  JSAMPARRAY output_data = *output_data_ptr;
+  JDIMENSION width = compptr->downsampled_width;
+  __m128i three = _mm_set1_epi16(3);
+  __m128i seven = _mm_set1_epi16(7), eight = _mm_set1_epi16(8);
+  JSAMPROW inptr0, inptr1, outptr;
+  int thiscolsum, lastcolsum, nextcolsum;
+  JDIMENSION col;
+  int inrow, outrow, v;
+
+  inrow = outrow = 0;
+  while (outrow < cinfo->max_v_samp_factor) {
+    for (v = 0; v < 2; v++) {
+      /* inptr0 points to nearest input row, inptr1 points to next nearest */
+      inptr0 = input_data[inrow];
+      if (v == 0)               /* next nearest is row above */
+        inptr1 = input_data[inrow-1];
+      else                      /* next nearest is row below */
+        inptr1 = input_data[inrow+1];
+      outptr = output_data[outrow++];
+
+      /* Special case for first column */
+      thiscolsum = GETJSAMPLE(inptr0[0]) * 3 + GETJSAMPLE(inptr1[0]);
+      nextcolsum = GETJSAMPLE(inptr0[1]) * 3 + GETJSAMPLE(inptr1[1]);
+      outptr[0] = (JSAMPLE) ((thiscolsum * 4 + 8) >> 4);
+      outptr[1] = (JSAMPLE) ((thiscolsum * 3 + nextcolsum + 7) >> 4);
+
+      /* General case: 9/16, 3/16, 3/16, 1/16 of the four nearest pixels */
+      for (col = 1; col + 9 <= width; col += 8) {
+        __m128i this3 = _mm_mullo_epi16(COLSUM8(inptr0, inptr1, col), three);
+        __m128i even = _mm_srli_epi16(
+          _mm_add_epi16(_mm_add_epi16(this3, eight),
+                        COLSUM8(inptr0, inptr1, col - 1)), 4);
+        __m128i odd = _mm_srli_epi16(
+          _mm_add_epi16(_mm_add_epi16(this3, seven),
+                        COLSUM8(inptr0, inptr1, col + 1)), 4);
+        STORE16(outptr + 2 * col, even, odd);
+      }
+      lastcolsum = GETJSAMPLE(inptr0[col-1]) * 3 + GETJSAMPLE(inptr1[col-1]);
+      thiscolsum = GETJSAMPLE(inptr0[col]) * 3 + GETJSAMPLE(inptr1[col]);
+      for (; col < width - 1; col++) {
+        nextcolsum = GETJSAMPLE(inptr0[col+1]) * 3 + GETJSAMPLE(inptr1[col+1]);
+        outptr[2 * col] = (JSAMPLE) ((thiscolsum * 3 + lastcolsum + 8) >> 4);
+        outptr[2 * col + 1] = (JSAMPLE) ((thiscolsum * 3 + nextcolsum + 7) >> 4);
+        lastcolsum = thiscolsum; thiscolsum = nextcolsum;
+      }
+
+      /* Special case for last column */
+      outptr[2 * col] = (JSAMPLE) ((thiscolsum * 3 + lastcolsum + 8) >> 4);
+      outptr[2 * col + 1] = (JSAMPLE) ((thiscolsum * 4 + 7) >> 4);
+    }
+    inrow++;
+  }
+}
+
+#endif /* JSIMD_X86 */
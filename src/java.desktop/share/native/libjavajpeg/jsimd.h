@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * jsimd.h
+ *
+ * This file declares the x86-64 vector versions of the decompressor's
+ * inverse DCT, YCbCr->RGB conversion and fancy upsampling.  They are
+ * compiled with target attributes, so the rest of the library keeps its
+ * baseline instruction set; the module initialization routines install
+ * them only if the matching jsimd_can_xxx() check succeeds.  Each one
+ * produces exactly the same samples as the portable routine it replaces.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(NO_JSIMD) && \
+    BITS_IN_JSAMPLE == 8 && defined(HAVE_UNSIGNED_CHAR)
+#define JSIMD_X86
+#endif
+
+#ifdef JSIMD_X86
+
+/* Short forms of external names for systems with brain-damaged linkers. */
+
+#ifdef NEED_SHORT_EXTERNAL_NAMES
+#define jsimd_can_idct_islow          jSCIDislow
+#define jsimd_can_ycc_rgb             jSCYccRgb
+#define jsimd_can_fancy_upsample      jSCFancyUp
+#define jsimd_idct_islow              jSIDislow
+#define jsimd_ycc_rgb_convert         jSYccRgb
+#define jsimd_h2v1_fancy_upsample     jSH2V1Fancy
+#define jsimd_h2v2_fancy_upsample     jSH2V2Fancy
+#endif /* NEED_SHORT_EXTERNAL_NAMES */
+
+EXTERN(boolean) jsimd_can_idct_islow JPP((void));
+EXTERN(boolean) jsimd_can_ycc_rgb JPP((void));
+EXTERN(boolean) jsimd_can_fancy_upsample JPP((void));
+
+/* Accurate integer inverse DCT, as jpeg_idct_islow (SSE4.1) */
+EXTERN(void) jsimd_idct_islow
+    JPP((j_decompress_ptr cinfo, jpeg_component_info * compptr,
+         JCOEFPTR coef_block, JSAMPARRAY output_buf, JDIMENSION output_col));
+
+/* YCbCr->RGB conversion with RGB_PIXELSIZE == 3 (SSSE3) */
+EXTERN(void) jsimd_ycc_rgb_convert
+    JPP((j_decompress_ptr cinfo, JSAMPIMAGE input_buf, JDIMENSION input_row,
+         JSAMPARRAY output_buf, int num_rows));
+
+/* Triangle-filter 2:1 upsampling, as h2v1/h2v2_fancy_upsample (SSE2) */
+EXTERN(void) jsimd_h2v1_fancy_upsample
+    JPP((j_decompress_ptr cinfo, jpeg_component_info * compptr,
+         JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr));
+EXTERN(void) jsimd_h2v2_fancy_upsample
+    JPP((j_decompress_ptr cinfo, jpeg_component_info * compptr,
+         JSAMPARRAY input_data, JSAMPARRAY * output_data_ptr));
+
+#endif /* JSIMD_X86 */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2007, 2015, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2007, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -104,6 +104,31 @@ typedef union {
     jint j;
 } TagSignature_t, *TagSignature_p;
 
+/* Transforms are shared between the Java transforms created for the same
+ * profiles, intent and formats: ColorConvertOp creates a new Java transform
+ * for every filter() call, and building the LCMS pipeline usually costs much
+ * more than running it.  The native ID of a Java transform points to one of
+ * these records, which is deleted when neither the cache nor a Java
+ * transform refers to it.
+ */
+typedef struct lcmsTransform_s {
+    cmsHTRANSFORM xf;
+    lcmsProfile_p profiles[DF_ICC_BUF_SIZE];
+    jint nProfiles;
+    jint renderType;
+    jint inFormatter;
+    jint outFormatter;
+    jint refs;      /* Java transforms using it, plus one while cached */
+} lcmsTransform_t, *lcmsTransform_p;
+
+/* Number of recently used transforms kept in the cache */
+#define XFORM_CACHE_SIZE 16
+
+/* Cached transforms, most recently used first; guarded by xformCacheLock */
+static lcmsTransform_p xformCache[XFORM_CACHE_SIZE];
+static jint xformCacheCount = 0;
+static jobject xformCacheLock = NULL;
+
 static jfieldID Trans_renderType_fID;
 static jfieldID Trans_ID_fID;
 static jfieldID IL_isIntPacked_fID;
@@ -141,10 +166,124 @@ JNIEXPORT jint JNICALL DEF_JNI_OnLoad(JavaVM *jvm, void *reserved) {
     return JNI_VERSION_1_6;
 }
 
+static jboolean lockXformCache(JNIEnv *env)
+{
+    return xformCacheLock != NULL &&
+           (*env)->MonitorEnter(env, xformCacheLock) == JNI_OK;
+}
+
+static void unlockXformCache(JNIEnv *env)
+{
+    (*env)->MonitorExit(env, xformCacheLock);
+}
+
+/* Drops one reference to the transform. Called with the cache locked
+ * if the transform has ever been cached.
+ */
+static void releaseTransform(lcmsTransform_p t)
+{
+    if (--t->refs == 0) {
+        cmsDeleteTransform(t->xf);
+        free(t);
+    }
+}
+
+/* Removes the i-th entry from the cache. Called with the cache locked. */
+static void evictTransform(jint i)
+{
+    lcmsTransform_p t = xformCache[i];
+
+    xformCacheCount--;
+    memmove(&xformCache[i], &xformCache[i + 1],
+            (xformCacheCount - i) * sizeof(lcmsTransform_p));
+    releaseTransform(t);
+}
+
+/* Removes the transforms built from the profile, which is about to be
+ * modified or freed, so that a later profile at the same address can not
+ * match them.
+ */
+static void evictProfileTransforms(JNIEnv *env, lcmsProfile_p p)
+{
+    jint i, j;
+
+    if (!lockXformCache(env)) {
+        return;
+    }
+    for (i = xformCacheCount - 1; i >= 0; i--) {
+        lcmsTransform_p t = xformCache[i];
+
+        for (j = 0; j < t->nProfiles; j++) {
+            if (t->profiles[j] == p) {
+                evictTransform(i);
+                break;
+            }
+        }
+    }
+    unlockXformCache(env);
+}
+
+/* Returns a cached transform for the key with a new reference, or NULL. */
+static lcmsTransform_p findTransform(JNIEnv *env, jlong *ids, jint size,
+                                     jint renderType, jint inFormatter,
+                                     jint outFormatter)
+{
+    lcmsTransform_p found = NULL;
+    jint i, j;
+
+    if (!lockXformCache(env)) {
+        return NULL;
+    }
+    for (i = 0; i < xformCacheCount && found == NULL; i++) {
+        lcmsTransform_p t = xformCache[i];
+
+        if (t->nProfiles != size || t->renderType != renderType ||
+            t->inFormatter != inFormatter || t->outFormatter != outFormatter)
+        {
+            continue;
+        }
+        for (j = 0; j < size; j++) {
+            if (t->profiles[j] != (lcmsProfile_p)jlong_to_ptr(ids[j])) {
+                break;
+            }
+        }
+        if (j == size) {
+            found = t;
+            found->refs++;
+            /* move to the front */
+            memmove(&xformCache[1], &xformCache[0], i * sizeof(lcmsTransform_p));
+            xformCache[0] = found;
+        }
+    }
+    unlockXformCache(env);
+
+    return found;
+}
+
+/* Puts a new transform in front of the cache, evicting the least recently
+ * used one if the cache is full.
+ */
+static void cacheTransform(JNIEnv *env, lcmsTransform_p t)
+{
+    if (t->nProfiles > DF_ICC_BUF_SIZE || !lockXformCache(env)) {
+        return;
+    }
+    if (xformCacheCount == XFORM_CACHE_SIZE) {
+        evictTransform(XFORM_CACHE_SIZE - 1);
+    }
+    memmove(&xformCache[1], &xformCache[0],
+            xformCacheCount * sizeof(lcmsTransform_p));
+    xformCache[0] = t;
+    xformCacheCount++;
+    t->refs++;
+    unlockXformCache(env);
+}
+
 void LCMS_freeProfile(JNIEnv *env, jlong ptr) {
     lcmsProfile_p p = (lcmsProfile_p)jlong_to_ptr(ptr);
 
     if (p != NULL) {
+        evictProfileTransforms(env, p);
         if (p->pf != NULL) {
             cmsCloseProfile(p->pf);
         }
@@ -154,9 +293,15 @@ void LCMS_freeProfile(JNIEnv *env, jlong ptr) {
 
 void LCMS_freeTransform(JNIEnv *env, jlong ID)
 {
-    cmsHTRANSFORM sTrans = jlong_to_ptr(ID);
+    lcmsTransform_p t = (lcmsTransform_p)jlong_to_ptr(ID);
     /* Passed ID is always valid native ref so there is no check for zero */
-    cmsDeleteTransform(sTrans);
+    if (lockXformCache(env)) {
+        releaseTransform(t);
+        unlockXformCache(env);
+    } else {
+        /* never cached, so this was the only reference */
+        releaseTransform(t);
+    }
 }
 
 /*
@@ -172,6 +317,7 @@ JNIEXPORT jlong JNICALL Java_sun_java2d_cmm_lcms_LCMS_createNativeTransform
     cmsHPROFILE _iccArray[DF_ICC_BUF_SIZE];
     cmsHPROFILE *iccArray = &_iccArray[0];
     cmsHTRANSFORM sTrans = NULL;
+    lcmsTransform_p t = NULL;
     int i, j, size;
     jlong* ids;
 
@@ -192,6 +338,13 @@ JNIEXPORT jlong JNICALL Java_sun_java2d_cmm_lcms_LCMS_createNativeTransform
     }
 #endif
 
+    t = findTransform(env, ids, size, renderType, inFormatter, outFormatter);
+    if (t != NULL) {
+        (*env)->ReleaseLongArrayElements(env, profileIDs, ids, 0);
+        Disposer_AddRecord(env, disposerRef, LCMS_freeTransform, ptr_to_jlong(t));
+        return ptr_to_jlong(t);
+    }
+
     if (DF_ICC_BUF_SIZE < size*2) {
         iccArray = (cmsHPROFILE*) malloc(
             size*2*sizeof(cmsHPROFILE));
@@ -226,6 +379,24 @@ JNIEXPORT jlong JNICALL Java_sun_java2d_cmm_lcms_LCMS_createNativeTransform
     sTrans = cmsCreateMultiprofileTransform(iccArray, j,
         inFormatter, outFormatter, renderType, 0);
 
+    if (sTrans != NULL) {
+        t = (lcmsTransform_p)malloc(sizeof(lcmsTransform_t));
+        if (t == NULL) {
+            cmsDeleteTransform(sTrans);
+            sTrans = NULL;
+        } else {
+            t->xf = sTrans;
+            t->nProfiles = size;
+            t->renderType = renderType;
+            t->inFormatter = inFormatter;
+            t->outFormatter = outFormatter;
+            t->refs = 1;
+            for (i = 0; i < size && i < DF_ICC_BUF_SIZE; i++) {
+                t->profiles[i] = (lcmsProfile_p)jlong_to_ptr(ids[i]);
+            }
+        }
+    }
+
     (*env)->ReleaseLongArrayElements(env, profileIDs, ids, 0);
 
     if (sTrans == NULL) {
@@ -236,13 +407,14 @@ JNIEXPORT jlong JNICALL Java_sun_java2d_cmm_lcms_LCMS_createNativeTransform
                             "Cannot get color transform");
         }
     } else {
-        Disposer_AddRecord(env, disposerRef, LCMS_freeTransform, ptr_to_jlong(sTrans));
+        cacheTransform(env, t);
+        Disposer_AddRecord(env, disposerRef, LCMS_freeTransform, ptr_to_jlong(t));
     }
 
     if (iccArray != &_iccArray[0]) {
         free(iccArray);
     }
-    return ptr_to_jlong(sTrans);
+    return ptr_to_jlong(t);
 }
 
 
@@ -498,6 +670,9 @@ JNIEXPORT void JNICALL Java_sun_java2d_cmm_lcms_LCMS_setTagDataNative
         return;
     }
 
+    /* transforms built from the old profile data must not be reused */
+    evictProfileTransforms(env, sProf);
+
     if (tagSig == SigHead) {
         status  = _setHeaderInfo(sProf->pf, dataArray, tagSize);
     } else {
@@ -592,6 +767,9 @@ JNIEXPORT void JNICALL Java_sun_java2d_cmm_lcms_LCMS_colorConvert
     dstAtOnce = (*env)->GetBooleanField(env, dst, IL_imageAtOnce_fID);
 
     sTrans = jlong_to_ptr((*env)->GetLongField (env, trans, Trans_ID_fID));
+    if (sTrans != NULL) {
+        sTrans = ((lcmsTransform_p)sTrans)->xf;
+    }
 
     if (sTrans == NULL) {
         J2dRlsTraceLn(J2D_TRACE_ERROR, "LCMS_colorConvert: transform == NULL");
@@ -731,6 +909,20 @@ JNIEXPORT void JNICALL Java_sun_java2d_cmm_lcms_LCMS_initLCMS
     if (IL_nextRowOffset_fID == NULL) {
         return;
     }
+
+    if (xformCacheLock == NULL) {
+        jclass objClass = (*env)->FindClass(env, "java/lang/Object");
+        jobject lock;
+
+        if (objClass == NULL) {
+            return;
+        }
+        lock = (*env)->AllocObject(env, objClass);
+        if (lock == NULL) {
+            return;
+        }
+        xformCacheLock = (*env)->NewGlobalRef(env, lock);
+    }
 }
 
 static cmsBool _getHeaderInfo(cmsHPROFILE pf, jbyte* pBuffer, jint bufferSize)
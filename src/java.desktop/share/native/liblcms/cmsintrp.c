@@ -55,6 +55,11 @@
 
 #include "lcms2_internal.h"
 
+#ifdef CMS_USE_SSE41
+#include <cpuid.h>
+#include <smmintrin.h>
+#endif
+
 // This module incorporates several interpolation routines, for 1 to 8 channels on input and
 // up to 65535 channels on output. The user may change those by using the interpolation plug-in
 
@@ -1048,6 +1053,199 @@ void Eval4Inputs(CMSREGISTER const cmsUInt16Number Input[],
 #undef DENS
 
 
+#ifdef CMS_USE_SSE41
+
+// SSE4.1 tetrahedral interpolation. The output channels of a node are contiguous in the table,
+// so each corner is loaded as one vector with a channel per 32-bit lane, and the 6 tetrahedra
+// differ only in the order in which the corners are visited: by decreasing rx, ry, rz. When two
+// fractions are equal, both orders add up to the same value (modulo 2^32, as the scalar code),
+// so the way ties are broken by each scalar routine does not matter.
+
+cmsBool _cmsHasSSE41(void)
+{
+    static int HasSSE41 = -1;
+
+    if (HasSSE41 < 0) {
+        unsigned int eax, ebx, ecx, edx;
+
+        HasSSE41 = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_1) != 0;
+    }
+
+    return HasSSE41;
+}
+
+// Loads 3 or 4 channels, zero extended to 32 bits
+static __attribute__((target("sse4.1"))) inline
+__m128i LoadNodeSSE41(const cmsUInt16Number* Node, cmsUInt32Number nOutputs)
+{
+    cmsUInt32Number lo;
+    cmsUInt64Number all;
+
+    if (nOutputs == 4) {
+        memmove(&all, Node, sizeof(all));
+        return _mm_cvtepu16_epi32(_mm_cvtsi64_si128((long long) all));
+    }
+
+    memmove(&lo, Node, sizeof(lo));
+    return _mm_cvtepu16_epi32(_mm_insert_epi16(_mm_cvtsi32_si128((int) lo), Node[2], 2));
+}
+
+// Stores the low 16 bits of 3 or 4 lanes
+static __attribute__((target("sse4.1"))) inline
+void StoreNodeSSE41(cmsUInt16Number Output[], __m128i v, cmsUInt32Number nOutputs)
+{
+    __m128i w = _mm_packus_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFFFF)), _mm_setzero_si128());
+    cmsUInt64Number all = (cmsUInt64Number) _mm_cvtsi128_si64(w);
+
+    memmove(Output, &all, nOutputs * sizeof(cmsUInt16Number));
+}
+
+// Returns c1 * rx + c2 * ry + c3 * rz for every channel, and the Lut[0] node in *c0
+static __attribute__((target("sse4.1"))) inline CMS_NO_SANITIZE
+__m128i TetrahedralRestSSE41(const cmsUInt16Number* Lut,
+                             cmsUInt32Number X1, cmsUInt32Number Y1, cmsUInt32Number Z1,
+                             cmsS15Fixed16Number rx, cmsS15Fixed16Number ry, cmsS15Fixed16Number rz,
+                             cmsUInt32Number nOutputs, __m128i* c0)
+{
+    cmsUInt32Number O1, O2, O3;
+    cmsS15Fixed16Number ra, rb, rc;
+    __m128i v0, v1, v2, v3, Rest;
+
+    if (rx >= ry) {
+        if (ry >= rz)      { O1 = X1; O2 = Y1; ra = rx; rb = ry; rc = rz; }
+        else if (rz >= rx) { O1 = Z1; O2 = X1; ra = rz; rb = rx; rc = ry; }
+        else               { O1 = X1; O2 = Z1; ra = rx; rb = rz; rc = ry; }
+    }
+    else {
+        if (rx >= rz)      { O1 = Y1; O2 = X1; ra = ry; rb = rx; rc = rz; }
+        else if (ry >= rz) { O1 = Y1; O2 = Z1; ra = ry; rb = rz; rc = rx; }
+        else               { O1 = Z1; O2 = Y1; ra = rz; rb = ry; rc = rx; }
+    }
+    O2 += O1;
+    O3 = X1 + Y1 + Z1;
+
+    v0 = LoadNodeSSE41(Lut, nOutputs);
+    v1 = LoadNodeSSE41(Lut + O1, nOutputs);
+    v2 = LoadNodeSSE41(Lut + O2, nOutputs);
+    v3 = LoadNodeSSE41(Lut + O3, nOutputs);
+
+    Rest = _mm_mullo_epi32(_mm_sub_epi32(v1, v0), _mm_set1_epi32(ra));
+    Rest = _mm_add_epi32(Rest, _mm_mullo_epi32(_mm_sub_epi32(v2, v1), _mm_set1_epi32(rb)));
+    Rest = _mm_add_epi32(Rest, _mm_mullo_epi32(_mm_sub_epi32(v3, v2), _mm_set1_epi32(rc)));
+
+    *c0 = v0;
+    return Rest;
+}
+
+__attribute__((target("sse4.1"))) CMS_NO_SANITIZE
+void _cmsTetrahedralInterp16SSE41(const cmsUInt16Number* Lut,
+                                  cmsUInt32Number X1, cmsUInt32Number Y1, cmsUInt32Number Z1,
+                                  cmsS15Fixed16Number rx, cmsS15Fixed16Number ry, cmsS15Fixed16Number rz,
+                                  cmsUInt32Number nOutputs, cmsUInt16Number Output[])
+{
+    __m128i c0, Rest;
+
+    Rest = TetrahedralRestSSE41(Lut, X1, Y1, Z1, rx, ry, rz, nOutputs, &c0);
+
+    // x = (t + (t >> 16)) >> 16, t = Rest + 0x8001
+    Rest = _mm_add_epi32(Rest, _mm_set1_epi32(0x8001));
+    Rest = _mm_srai_epi32(_mm_add_epi32(Rest, _mm_srai_epi32(Rest, 16)), 16);
+
+    StoreNodeSSE41(Output, _mm_add_epi32(c0, Rest), nOutputs);
+}
+
+static __attribute__((target("sse4.1")))
+void TetrahedralInterp16SSE41(CMSREGISTER const cmsUInt16Number Input[],
+                              CMSREGISTER cmsUInt16Number Output[],
+                              CMSREGISTER const cmsInterpParams* p)
+{
+    cmsS15Fixed16Number fx, fy, fz;
+
+    fx = _cmsToFixedDomain((int) Input[0] * p -> Domain[0]);
+    fy = _cmsToFixedDomain((int) Input[1] * p -> Domain[1]);
+    fz = _cmsToFixedDomain((int) Input[2] * p -> Domain[2]);
+
+    _cmsTetrahedralInterp16SSE41((const cmsUInt16Number*) p -> Table +
+                                     p -> opta[2] * FIXED_TO_INT(fx) +
+                                     p -> opta[1] * FIXED_TO_INT(fy) +
+                                     p -> opta[0] * FIXED_TO_INT(fz),
+                                 Input[0] == 0xFFFFU ? 0 : p -> opta[2],
+                                 Input[1] == 0xFFFFU ? 0 : p -> opta[1],
+                                 Input[2] == 0xFFFFU ? 0 : p -> opta[0],
+                                 FIXED_REST_TO_INT(fx), FIXED_REST_TO_INT(fy), FIXED_REST_TO_INT(fz),
+                                 p -> nOutputs, Output);
+}
+
+// c0 + ROUND_FIXED_TO_INT(_cmsToFixedDomain(Rest)), as Eval4Inputs. The division is done in double
+// precision, which is exact for 32-bit dividends, and truncated towards zero as in C.
+static __attribute__((target("sse4.1"))) inline CMS_NO_SANITIZE
+__m128i Tetrahedral4InputsSSE41(const cmsUInt16Number* Lut,
+                                cmsUInt32Number X1, cmsUInt32Number Y1, cmsUInt32Number Z1,
+                                cmsS15Fixed16Number rx, cmsS15Fixed16Number ry, cmsS15Fixed16Number rz,
+                                cmsUInt32Number nOutputs)
+{
+    const __m128d Div = _mm_set1_pd(65535.0);
+    __m128i c0, Rest, t;
+    __m128d lo, hi;
+
+    Rest = TetrahedralRestSSE41(Lut, X1, Y1, Z1, rx, ry, rz, nOutputs, &c0);
+
+    t  = _mm_add_epi32(Rest, _mm_set1_epi32(0x7fff));
+    lo = _mm_div_pd(_mm_cvtepi32_pd(t), Div);
+    hi = _mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(t, t)), Div);
+    t  = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+
+    Rest = _mm_add_epi32(Rest, t);
+    Rest = _mm_srai_epi32(_mm_add_epi32(Rest, _mm_set1_epi32(0x8000)), 16);
+
+    return _mm_and_si128(_mm_add_epi32(c0, Rest), _mm_set1_epi32(0xFFFF));
+}
+
+static __attribute__((target("sse4.1"))) CMS_NO_SANITIZE
+void Eval4InputsSSE41(CMSREGISTER const cmsUInt16Number Input[],
+                      CMSREGISTER cmsUInt16Number Output[],
+                      CMSREGISTER const cmsInterpParams* p16)
+{
+    const cmsUInt16Number* LutTable = (cmsUInt16Number*) p16 -> Table;
+    cmsS15Fixed16Number fk, fx, fy, fz;
+    cmsS15Fixed16Number rk, rx, ry, rz;
+    cmsUInt32Number K0, K1, XYZ0, X1, Y1, Z1;
+    __m128i Tmp1, Tmp2, dif;
+
+    fk  = _cmsToFixedDomain((int) Input[0] * p16 -> Domain[0]);
+    fx  = _cmsToFixedDomain((int) Input[1] * p16 -> Domain[1]);
+    fy  = _cmsToFixedDomain((int) Input[2] * p16 -> Domain[2]);
+    fz  = _cmsToFixedDomain((int) Input[3] * p16 -> Domain[3]);
+
+    rk  = FIXED_REST_TO_INT(fk);
+    rx  = FIXED_REST_TO_INT(fx);
+    ry  = FIXED_REST_TO_INT(fy);
+    rz  = FIXED_REST_TO_INT(fz);
+
+    K0 = p16 -> opta[3] * FIXED_TO_INT(fk);
+    K1 = K0 + (Input[0] == 0xFFFFU ? 0 : p16->opta[3]);
+
+    XYZ0 = p16 -> opta[2] * FIXED_TO_INT(fx) +
+           p16 -> opta[1] * FIXED_TO_INT(fy) +
+           p16 -> opta[0] * FIXED_TO_INT(fz);
+
+    X1 = (Input[1] == 0xFFFFU ? 0 : p16->opta[2]);
+    Y1 = (Input[2] == 0xFFFFU ? 0 : p16->opta[1]);
+    Z1 = (Input[3] == 0xFFFFU ? 0 : p16->opta[0]);
+
+    Tmp1 = Tetrahedral4InputsSSE41(LutTable + K0 + XYZ0, X1, Y1, Z1, rx, ry, rz, p16 -> nOutputs);
+    Tmp2 = Tetrahedral4InputsSSE41(LutTable + K1 + XYZ0, X1, Y1, Z1, rx, ry, rz, p16 -> nOutputs);
+
+    // LinearInterp(rk, Tmp1, Tmp2)
+    dif = _mm_mullo_epi32(_mm_sub_epi32(Tmp2, Tmp1), _mm_set1_epi32(rk));
+    dif = _mm_srli_epi32(_mm_add_epi32(dif, _mm_set1_epi32(0x8000)), 16);
+
+    StoreNodeSSE41(Output, _mm_add_epi32(dif, Tmp1), p16 -> nOutputs);
+}
+
+#endif
+
+
 // For more that 3 inputs (i.e., CMYK)
 // evaluate two 3-dimensional interpolations and then linearly interpolate between them.
 static
@@ -1248,6 +1446,10 @@ cmsInterpFunction DefaultInterpolatorsFactory(cmsUInt32Number nInputChannels, cm
                    else {
 
                        Interpolation.Lerp16 = TetrahedralInterp16;
+#ifdef CMS_USE_SSE41
+                       if ((nOutputChannels == 3 || nOutputChannels == 4) && _cmsHasSSE41())
+                           Interpolation.Lerp16 = TetrahedralInterp16SSE41;
+#endif
                    }
                }
                break;
@@ -1256,8 +1458,13 @@ cmsInterpFunction DefaultInterpolatorsFactory(cmsUInt32Number nInputChannels, cm
 
                if (IsFloat)
                    Interpolation.LerpFloat =  Eval4InputsFloat;
-               else
+               else {
                    Interpolation.Lerp16    =  Eval4Inputs;
+#ifdef CMS_USE_SSE41
+                   if ((nOutputChannels == 3 || nOutputChannels == 4) && _cmsHasSSE41())
+                       Interpolation.Lerp16 = Eval4InputsSSE41;
+#endif
+               }
                break;
 
            case 5: // 5 Inks
@@ -1043,6 +1043,32 @@ void PrelinEval8(CMSREGISTER const cmsUInt16Number Input[],
 
 #undef DENS
 
+#ifdef CMS_USE_SSE41
+
+// PrelinEval8 for 3 or 4 output channels
+static
+void PrelinEval8SSE41(CMSREGISTER const cmsUInt16Number Input[],
+                      CMSREGISTER cmsUInt16Number Output[],
+                      CMSREGISTER const void* D)
+{
+    Prelin8Data* p8 = (Prelin8Data*) D;
+    const cmsInterpParams* p = p8 ->p;
+    cmsUInt8Number r, g, b;
+
+    r = (cmsUInt8Number) (Input[0] >> 8);
+    g = (cmsUInt8Number) (Input[1] >> 8);
+    b = (cmsUInt8Number) (Input[2] >> 8);
+
+    _cmsTetrahedralInterp16SSE41((const cmsUInt16Number*) p->Table + p8->X0[r] + p8->Y0[g] + p8->Z0[b],
+                                 (p8 ->rx[r] == 0) ? 0 : p ->opta[2],
+                                 (p8 ->ry[g] == 0) ? 0 : p ->opta[1],
+                                 (p8 ->rz[b] == 0) ? 0 : p ->opta[0],
+                                 p8 ->rx[r], p8 ->ry[g], p8 ->rz[b],
+                                 p ->nOutputs, Output);
+}
+
+#endif
+
 
 // Curves that contain wide empty areas are not optimizeable
 static
@@ -1237,9 +1263,15 @@ cmsBool OptimizeByComputingLinearization(cmsPipeline** Lut, cmsUInt32Number Inte
         Prelin8Data* p8 = PrelinOpt8alloc(OptimizedLUT ->ContextID,
                                                 OptimizedPrelinCLUT ->Params,
                                                 OptimizedPrelinCurves);
+        _cmsPipelineEval16Fn Eval8 = PrelinEval8;
+
         if (p8 == NULL) return FALSE;
 
-        _cmsPipelineSetOptimizationParameters(OptimizedLUT, PrelinEval8, (void*) p8, Prelin8free, Prelin8dup);
+#ifdef CMS_USE_SSE41
+        if ((p8 ->p ->nOutputs == 3 || p8 ->p ->nOutputs == 4) && _cmsHasSSE41())
+            Eval8 = PrelinEval8SSE41;
+#endif
+        _cmsPipelineSetOptimizationParameters(OptimizedLUT, Eval8, (void*) p8, Prelin8free, Prelin8dup);
 
     }
     else
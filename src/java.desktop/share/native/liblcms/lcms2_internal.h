@@ -872,6 +872,23 @@ cmsInterpParams*                         _cmsComputeInterpParamsEx(cmsContext Co
 CMSCHECKPOINT void             CMSEXPORT _cmsFreeInterpParams(cmsInterpParams* p);
 cmsBool                                  _cmsSetInterpolationRoutine(cmsContext ContextID, cmsInterpParams* p);
 
+// SSE4.1 versions of the 16-bit tetrahedral interpolation, for 3 and 4 output channels. They are
+// compiled with a target attribute and only used if the CPU supports SSE4.1; results are the same
+// as the portable routines.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(CMS_DONT_USE_SSE41)
+#define CMS_USE_SSE41 1
+
+cmsBool                                  _cmsHasSSE41(void);
+
+// Output[i] = Lut[i] + tetrahedral interpolation of the Lut[X1], Lut[Y1], Lut[Z1], Lut[X1+Y1+Z1]...
+// corners, rounded as TetrahedralInterp16. X1, Y1, Z1 are offsets relative to Lut, rx, ry, rz the
+// fractions in 0..0xffff
+void                                     _cmsTetrahedralInterp16SSE41(const cmsUInt16Number* Lut,
+                                                                      cmsUInt32Number X1, cmsUInt32Number Y1, cmsUInt32Number Z1,
+                                                                      cmsS15Fixed16Number rx, cmsS15Fixed16Number ry, cmsS15Fixed16Number rz,
+                                                                      cmsUInt32Number nOutputs, cmsUInt16Number Output[]);
+#endif
+
 // Curves ----------------------------------------------------------------------------------------------------------------
 
 // This struct holds information about a segment, plus a pointer to the function that implements the evaluation.
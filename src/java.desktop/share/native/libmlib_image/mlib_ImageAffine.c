@@ -74,6 +74,7 @@
 
 #include "mlib_ImageCheck.h"
 #include "mlib_ImageAffine.h"
+#include "mlib_ImageBands.h"
 
 
 /***************************************************************/
@@ -130,6 +131,29 @@ const type_affine_fun mlib_AffineFunArr_bc[] = {
 #define MAX_T_IND  3
 #endif /* i386 ( do not perform the coping by mlib_d64 data type for x86 ) */
 
+/***************************************************************/
+typedef struct {
+  type_affine_fun   fun;
+  mlib_affine_param *param;
+} mlib_affine_bands;
+
+/***************************************************************/
+/* Runs the kernel on the destination rows first..last. */
+static mlib_status mlib_ImageAffine_band(void     *arg,
+                                         mlib_s32 first,
+                                         mlib_s32 last)
+{
+  mlib_affine_bands *bands = arg;
+  mlib_affine_param param[1];
+
+  *param = *(bands->param);
+  param->dstData += (first - param->yStart) * param->dstYStride;
+  param->yStart = first;
+  param->yFinish = last;
+
+  return bands->fun(param);
+}
+
 /***************************************************************/
 mlib_status mlib_ImageAffine_alltypes(mlib_image       *dst,
                                       const mlib_image *src,
@@ -138,6 +162,7 @@ mlib_status mlib_ImageAffine_alltypes(mlib_image       *dst,
                                       mlib_edge        edge)
 {
   mlib_affine_param param[1];
+  mlib_affine_bands bands;
   mlib_status res;
   mlib_type type;
   mlib_s32 nchan, t_ind, kw, kw1;
@@ -222,21 +247,35 @@ mlib_status mlib_ImageAffine_alltypes(mlib_image       *dst,
           t_ind++;
         }
 
-        res = mlib_AffineFunArr_nn[4 * t_ind + (nchan - 1)] (param);
+        bands.fun = mlib_AffineFunArr_nn[4 * t_ind + (nchan - 1)];
         break;
 
       case MLIB_BILINEAR:
 
-        res = mlib_AffineFunArr_bl[4 * t_ind + (nchan - 1)] (param);
+        bands.fun = mlib_AffineFunArr_bl[4 * t_ind + (nchan - 1)];
+#ifdef MLIB_S_AFFINE
+        if (t_ind == 0 && nchan == 4 && mlib_s_ImageAffineSupported())
+          bands.fun = mlib_s_ImageAffine_u8_4ch_bl;
+#endif /* MLIB_S_AFFINE */
         break;
 
       case MLIB_BICUBIC:
       case MLIB_BICUBIC2:
 
-        res = mlib_AffineFunArr_bc[4 * t_ind + (nchan - 1)] (param);
+        bands.fun = mlib_AffineFunArr_bc[4 * t_ind + (nchan - 1)];
+#ifdef MLIB_S_AFFINE
+        if (t_ind == 0 && nchan == 4 && mlib_s_ImageAffineSupported())
+          bands.fun = mlib_s_ImageAffine_u8_4ch_bc;
+#endif /* MLIB_S_AFFINE */
         break;
     }
 
+    /* the rows are independent: split them between the band workers */
+    bands.param = param;
+    res = mlib_ImageRunBands(mlib_ImageAffine_band, &bands,
+                             param->yStart, param->yFinish,
+                             param->max_xsize * nchan * kw * kw);
+
     if (res != MLIB_SUCCESS) {
       if (param->buff_malloc != NULL)
         mlib_free(param->buff_malloc);
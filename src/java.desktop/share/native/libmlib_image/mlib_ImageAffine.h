@@ -185,6 +185,17 @@ extern const type_affine_fun mlib_AffineFunArr_nn[];
 extern const type_affine_fun mlib_AffineFunArr_bl[];
 extern const type_affine_fun mlib_AffineFunArr_bc[];
 
+/***************************************************************/
+/* SSE4.1 versions of the BYTE 4-channel bilinear and bicubic functions */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define MLIB_S_AFFINE
+
+mlib_s32 mlib_s_ImageAffineSupported(void);
+mlib_status mlib_s_ImageAffine_u8_4ch_bl(mlib_affine_param *param);
+mlib_status mlib_s_ImageAffine_u8_4ch_bc(mlib_affine_param *param);
+
+#endif /* defined(__x86_64__) && defined(__GNUC__) */
+
 /***************************************************************/
 typedef union {
   mlib_d64 d64;
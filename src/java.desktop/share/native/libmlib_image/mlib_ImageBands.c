@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+/*
+ * FUNCTION
+ *      mlib_ImageRunBands - run an operation on row bands in parallel
+ *
+ * DESCRIPTION
+ *      See mlib_ImageBands.h.
+ *
+ *      The workers are started on first use and live as long as the
+ *      library.  One image is processed at a time: the bands of the
+ *      current job are claimed one by one under the pool lock, by the
+ *      workers and by the thread that started the job, which returns
+ *      when all of them are finished.
+ */
+
+#include "mlib_ImageBands.h"
+
+/***************************************************************/
+/* at most this many threads, including the calling one, work on an image */
+#define MLIB_BAND_MAX_THREADS  8
+
+/* estimated work (e.g. destination pixels times kernel size) per band */
+#define MLIB_BAND_MIN_WORK     (1 << 18)
+
+/* fewest rows per band */
+#define MLIB_BAND_MIN_ROWS     16
+
+/***************************************************************/
+#if defined(_WIN32) || defined(_WIN64)
+
+mlib_status mlib_ImageRunBands(mlib_band_fun fun,
+                               void          *arg,
+                               mlib_s32      first,
+                               mlib_s32      last,
+                               mlib_s32      row_work)
+{
+  return fun(arg, first, last);
+}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+/***************************************************************/
+typedef struct {
+  mlib_band_fun fun;
+  void          *arg;
+  mlib_s32      first;
+  mlib_s32      nrows;
+  mlib_s32      nbands;
+  mlib_s32      next;    /* next band to claim */
+  mlib_s32      pending; /* bands not finished yet */
+  mlib_status   status;
+} mlib_band_job;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  pool_done = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t pool_busy = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t  pool_once = PTHREAD_ONCE_INIT;
+static mlib_band_job   *pool_job = NULL;
+static mlib_s32        pool_workers = 0;
+
+/***************************************************************/
+/* Runs bands of the job until none is left. Called with pool_lock held. */
+static void mlib_RunJobBands(mlib_band_job *job)
+{
+  while (job->next < job->nbands) {
+    mlib_s32 band = job->next++;
+    mlib_s32 size = job->nrows / job->nbands;
+    mlib_s32 extra = job->nrows % job->nbands;
+    mlib_s32 first = job->first + band * size + (band < extra ? band : extra);
+    mlib_s32 last = first + size - (band < extra ? 0 : 1);
+    mlib_status status;
+
+    pthread_mutex_unlock(&pool_lock);
+    status = job->fun(job->arg, first, last);
+    pthread_mutex_lock(&pool_lock);
+
+    if (status != MLIB_SUCCESS)
+      job->status = status;
+
+    if (--job->pending == 0)
+      pthread_cond_signal(&pool_done);
+  }
+}
+
+/***************************************************************/
+static void *mlib_BandWorker(void *unused)
+{
+  pthread_mutex_lock(&pool_lock);
+  for (;;) {
+    while (pool_job == NULL || pool_job->next >= pool_job->nbands) {
+      pthread_cond_wait(&pool_work, &pool_lock);
+    }
+
+    mlib_RunJobBands(pool_job);
+  }
+
+  return NULL;
+}
+
+/***************************************************************/
+static void mlib_StartBandWorkers(void)
+{
+  long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+  mlib_s32 nworkers, i;
+  pthread_attr_t attr;
+
+  if (ncpus > MLIB_BAND_MAX_THREADS)
+    ncpus = MLIB_BAND_MAX_THREADS;
+
+  nworkers = (ncpus > 1) ? (mlib_s32) ncpus - 1 : 0;
+
+  if (nworkers == 0 || pthread_attr_init(&attr) != 0)
+    return;
+
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  for (i = 0; i < nworkers; i++) {
+    pthread_t tid;
+
+    if (pthread_create(&tid, &attr, mlib_BandWorker, NULL) != 0)
+      break;
+  }
+
+  pthread_attr_destroy(&attr);
+  pool_workers = i;
+}
+
+/***************************************************************/
+mlib_status mlib_ImageRunBands(mlib_band_fun fun,
+                               void          *arg,
+                               mlib_s32      first,
+                               mlib_s32      last,
+                               mlib_s32      row_work)
+{
+  mlib_band_job job;
+  mlib_s32 nrows = last - first + 1;
+  mlib_s32 band_rows, nbands;
+
+  if (row_work < 1)
+    row_work = 1;
+
+  band_rows = (MLIB_BAND_MIN_WORK + row_work - 1) / row_work;
+
+  if (band_rows < MLIB_BAND_MIN_ROWS)
+    band_rows = MLIB_BAND_MIN_ROWS;
+
+  if (nrows < 2 * band_rows)
+    return fun(arg, first, last);
+
+  pthread_once(&pool_once, mlib_StartBandWorkers);
+
+  nbands = pool_workers + 1;
+
+  if (nbands > nrows / band_rows)
+    nbands = nrows / band_rows;
+
+  /* another image is being processed: do this one on the calling thread */
+  if (nbands < 2 || pthread_mutex_trylock(&pool_busy) != 0)
+    return fun(arg, first, last);
+
+  job.fun = fun;
+  job.arg = arg;
+  job.first = first;
+  job.nrows = nrows;
+  job.nbands = nbands;
+  job.next = 0;
+  job.pending = nbands;
+  job.status = MLIB_SUCCESS;
+
+  pthread_mutex_lock(&pool_lock);
+  pool_job = &job;
+  pthread_cond_broadcast(&pool_work);
+
+  mlib_RunJobBands(&job);
+
+  while (job.pending > 0) {
+    pthread_cond_wait(&pool_done, &pool_lock);
+  }
+
+  pool_job = NULL;
+  pthread_mutex_unlock(&pool_lock);
+  pthread_mutex_unlock(&pool_busy);
+
+  return job.status;
+}
+
+#endif /* defined(_WIN32) || defined(_WIN64) */
+
+/***************************************************************/
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef __MLIB_IMAGEBANDS_H
+#define __MLIB_IMAGEBANDS_H
+
+#include "mlib_types.h"
+#include "mlib_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * DESCRIPTION
+ *   Runs an operation on horizontal bands of the destination image in
+ *   parallel.  The rows first..last are split into contiguous bands that
+ *   are handed to a pool of native worker threads, and the calling thread
+ *   works on bands as well.  The band function must only write the rows
+ *   of its band, so that the result does not depend on the split.
+ *
+ *   Small operations, estimated as rows * row_work, run on the calling
+ *   thread as one band, as do operations started while the pool is busy
+ *   with another image.  The pool is only implemented with pthreads; on
+ *   other platforms every operation runs as one band.
+ *
+ *   The status is MLIB_SUCCESS if every band succeeded, otherwise the
+ *   status of a failed band.
+ */
+
+/***************************************************************/
+typedef mlib_status (*mlib_band_fun)(void     *arg,
+                                     mlib_s32 first,
+                                     mlib_s32 last);
+
+/***************************************************************/
+mlib_status mlib_ImageRunBands(mlib_band_fun fun,
+                               void          *arg,
+                               mlib_s32      first,
+                               mlib_s32      last,
+                               mlib_s32      row_work);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __MLIB_IMAGEBANDS_H */
@@ -88,6 +88,7 @@
 #include "mlib_c_ImageConv.h"
 #include "mlib_ImageClipping.h"
 #include "mlib_ImageConvEdge.h"
+#include "mlib_ImageBands.h"
 
 /***************************************************************/
 JNIEXPORT
@@ -128,6 +129,96 @@ mlib_status mlib_ImageConvMxN(mlib_image       *dst,
   return mlib_ImageConvMxN_f(dst, src, kernel, m, n, dm, dn, scale, cmask, edge);
 }
 
+/***************************************************************/
+typedef struct {
+  mlib_image       *dst;
+  const mlib_image *src;
+  const void       *kernel;
+  mlib_s32         m;
+  mlib_s32         n;
+  mlib_s32         dm;
+  mlib_s32         dn;
+  mlib_s32         scale;
+  mlib_s32         cmask;
+} mlib_conv_bands;
+
+/***************************************************************/
+static mlib_status mlib_ImageConvMxNnw(mlib_image       *dst,
+                                       const mlib_image *src,
+                                       const void       *kernel,
+                                       mlib_s32         m,
+                                       mlib_s32         n,
+                                       mlib_s32         dm,
+                                       mlib_s32         dn,
+                                       mlib_s32         scale,
+                                       mlib_s32         cmask)
+{
+  mlib_type type = mlib_ImageGetType(dst);
+
+  switch (type) {
+    case MLIB_BYTE:
+      return mlib_convMxNnw_u8(dst, src, kernel, m, n, dm, dn, scale, cmask);
+    case MLIB_SHORT:
+#ifdef __sparc
+      return mlib_convMxNnw_s16(dst, src, kernel, m, n, dm, dn, scale, cmask);
+#else
+
+      if (mlib_ImageConvVersion(m, n, scale, type) == 0)
+        return mlib_convMxNnw_s16(dst, src, kernel, m, n, dm, dn, scale, cmask);
+      else
+        return mlib_i_convMxNnw_s16(dst, src, kernel, m, n, dm, dn, scale, cmask);
+#endif /* __sparc */
+    case MLIB_USHORT:
+#ifdef __sparc
+      return mlib_convMxNnw_u16(dst, src, kernel, m, n, dm, dn, scale, cmask);
+#else
+
+      if (mlib_ImageConvVersion(m, n, scale, type) == 0)
+        return mlib_convMxNnw_u16(dst, src, kernel, m, n, dm, dn, scale, cmask);
+      else
+        return mlib_i_convMxNnw_u16(dst, src, kernel, m, n, dm, dn, scale, cmask);
+#endif /* __sparc */
+    case MLIB_INT:
+      return mlib_convMxNnw_s32(dst, src, kernel, m, n, dm, dn, scale, cmask);
+    case MLIB_FLOAT:
+      return mlib_convMxNnw_f32(dst, src, kernel, m, n, dm, dn, cmask);
+    case MLIB_DOUBLE:
+      return mlib_convMxNnw_d64(dst, src, kernel, m, n, dm, dn, cmask);
+
+  default:
+    /* For some reasons, there is no convolution routine for type MLIB_BIT.
+     * For now, we silently ignore it (because this image type is not used by java),
+     * but probably we have to report an error.
+     */
+    break;
+  }
+
+  return MLIB_SUCCESS;
+}
+
+/***************************************************************/
+/* Computes the output rows first..last of the inner part of the image:
+ * the kernel is applied to the subimages holding these rows and the
+ * source rows they depend on.
+ */
+static mlib_status mlib_ImageConvMxN_band(void     *arg,
+                                          mlib_s32 first,
+                                          mlib_s32 last)
+{
+  mlib_conv_bands *bands = arg;
+  mlib_image dst_b[1], src_b[1];
+  mlib_s32 width = mlib_ImageGetWidth(bands->dst);
+  mlib_s32 y = first - bands->dn;
+  mlib_s32 height = last - first + bands->n;
+
+  if (mlib_ImageSetSubimage(dst_b, bands->dst, 0, y, width, height) == NULL ||
+      mlib_ImageSetSubimage(src_b, bands->src, 0, y, width, height) == NULL)
+    return MLIB_FAILURE;
+
+  return mlib_ImageConvMxNnw(dst_b, src_b, bands->kernel, bands->m, bands->n,
+                             bands->dm, bands->dn, bands->scale, bands->cmask);
+}
+
 /***************************************************************/
 mlib_status mlib_ImageConvMxN_f(mlib_image       *dst,
                                 const mlib_image *src,
@@ -177,49 +268,22 @@ mlib_status mlib_ImageConvMxN_f(mlib_image       *dst,
 
   if (edge != MLIB_EDGE_SRC_EXTEND) {
     if (mlib_ImageGetWidth(dst_i) >= m && mlib_ImageGetHeight(dst_i) >= n) {
-      switch (type) {
-        case MLIB_BYTE:
-          ret = mlib_convMxNnw_u8(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-          break;
-        case MLIB_SHORT:
-#ifdef __sparc
-          ret = mlib_convMxNnw_s16(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-#else
+      mlib_conv_bands bands;
 
-          if (mlib_ImageConvVersion(m, n, scale, type) == 0)
-            ret = mlib_convMxNnw_s16(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-          else
-            ret = mlib_i_convMxNnw_s16(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-#endif /* __sparc */
-          break;
-        case MLIB_USHORT:
-#ifdef __sparc
-          ret = mlib_convMxNnw_u16(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-#else
+      bands.dst = dst_i;
+      bands.src = src_i;
+      bands.kernel = kernel;
+      bands.m = m;
+      bands.n = n;
+      bands.dm = dm;
+      bands.dn = dn;
+      bands.scale = scale;
+      bands.cmask = cmask;
 
-          if (mlib_ImageConvVersion(m, n, scale, type) == 0)
-            ret = mlib_convMxNnw_u16(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-          else
-            ret = mlib_i_convMxNnw_u16(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-#endif /* __sparc */
-          break;
-        case MLIB_INT:
-          ret = mlib_convMxNnw_s32(dst_i, src_i, kernel, m, n, dm, dn, scale, cmask);
-          break;
-        case MLIB_FLOAT:
-          ret = mlib_convMxNnw_f32(dst_i, src_i, kernel, m, n, dm, dn, cmask);
-          break;
-        case MLIB_DOUBLE:
-          ret = mlib_convMxNnw_d64(dst_i, src_i, kernel, m, n, dm, dn, cmask);
-          break;
-
-      default:
-        /* For some reasons, there is no convolution routine for type MLIB_BIT.
-         * For now, we silently ignore it (because this image type is not used by java),
-         * but probably we have to report an error.
-         */
-        break;
-      }
+      /* the output rows dn..height-n+dn are independent: split them */
+      ret = mlib_ImageRunBands(mlib_ImageConvMxN_band, &bands, dn,
+                               mlib_ImageGetHeight(dst_i) - n + dn,
+                               mlib_ImageGetWidth(dst_i) * nchan * m * n);
     }
 
     switch (edge) {
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+
+/*
+ * FUNCTION
+ *      mlib_s_ImageAffine_u8_4ch_bl - bilinear affine of 4-channel BYTE image
+ *      mlib_s_ImageAffine_u8_4ch_bc - bicubic affine of 4-channel BYTE image
+ *      mlib_s_ImageAffineSupported  - check that the CPU runs them
+ *
+ * DESCRIPTION
+ *      SSE4.1 versions of mlib_ImageAffine_u8_4ch_bl and
+ *      mlib_ImageAffine_u8_4ch_bc (the integer variants used on x86).
+ *      The four channels of a pixel are processed in the lanes of one
+ *      register with the same 32-bit integer arithmetic, so the results
+ *      are identical.  The functions are compiled with target attributes;
+ *      mlib_ImageAffine_alltypes only selects them when
+ *      mlib_s_ImageAffineSupported() returns 1.
+ */
+
+#include <string.h>
+#include "mlib_ImageAffine.h"
+
+#ifdef MLIB_S_AFFINE
+
+#include <cpuid.h>
+#include <smmintrin.h>
+#include "mlib_ImageFilters.h"
+
+#define DTYPE  mlib_u8
+
+#define FILTER_BITS   8
+
+#define MLIB_ROUND   (1 << (MLIB_SHIFT - 1))
+
+#define SHIFT_X  12
+
+#define SHIFT_Y  (14 + 14 - SHIFT_X)
+#define ROUND_Y  (1 << (SHIFT_Y - 1))
+
+#define MLIB_S_TARGET  __attribute__((target("sse4.1")))
+
+/***************************************************************/
+mlib_s32 mlib_s_ImageAffineSupported(void)
+{
+  static mlib_s32 supported = -1;
+
+  if (supported < 0) {
+    unsigned int eax, ebx, ecx, edx;
+
+    supported = (__get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+                 (ecx & bit_SSE4_1) != 0) ? 1 : 0;
+  }
+
+  return supported;
+}
+
+/***************************************************************/
+/* Stores the low 4 bytes of v as one 4-channel pixel. */
+#define STORE_PIXEL(dp, v)                                      \
+  {                                                             \
+    mlib_s32 pix = _mm_cvtsi128_si32(v);                        \
+    memcpy(dp, &pix, 4);                                        \
+  }
+
+/***************************************************************/
+MLIB_S_TARGET
+mlib_status mlib_s_ImageAffine_u8_4ch_bl(mlib_affine_param *param)
+{
+  DECLAREVAR_BL();
+  DTYPE *dstLineEnd;
+  DTYPE *srcPixelPtr2;
+  const __m128i round = _mm_set1_epi32(MLIB_ROUND);
+
+  for (j = yStart; j <= yFinish; j++) {
+    CLIP(4);
+    dstLineEnd = (DTYPE *) dstData + 4 * xRight;
+
+    for (; dstPixelPtr <= dstLineEnd; dstPixelPtr += 4) {
+      __m128i top, bot, a00, a01, a10, a11, fdx, fdy, pix0, pix1, res;
+
+      fdx = _mm_set1_epi32(X & MLIB_MASK);
+      fdy = _mm_set1_epi32(Y & MLIB_MASK);
+      ySrc = MLIB_POINTER_SHIFT(Y);
+      xSrc = X >> MLIB_SHIFT;
+      srcPixelPtr = MLIB_POINTER_GET(lineAddr, ySrc) + 4 * xSrc;
+      srcPixelPtr2 = (DTYPE *) ((mlib_u8 *) srcPixelPtr + srcYStride);
+      X += dX;
+      Y += dY;
+
+      top = _mm_loadl_epi64((const __m128i *) srcPixelPtr);
+      bot = _mm_loadl_epi64((const __m128i *) srcPixelPtr2);
+      a00 = _mm_cvtepu8_epi32(top);
+      a01 = _mm_cvtepu8_epi32(_mm_srli_si128(top, 4));
+      a10 = _mm_cvtepu8_epi32(bot);
+      a11 = _mm_cvtepu8_epi32(_mm_srli_si128(bot, 4));
+
+      /* pix0 = a00 + ((fdy * (a10 - a00) + MLIB_ROUND) >> MLIB_SHIFT) */
+      pix0 = _mm_mullo_epi32(fdy, _mm_sub_epi32(a10, a00));
+      pix0 = _mm_add_epi32(a00, _mm_srai_epi32(_mm_add_epi32(pix0, round),
+                                               MLIB_SHIFT));
+      pix1 = _mm_mullo_epi32(fdy, _mm_sub_epi32(a11, a01));
+      pix1 = _mm_add_epi32(a01, _mm_srai_epi32(_mm_add_epi32(pix1, round),
+                                               MLIB_SHIFT));
+      res = _mm_mullo_epi32(fdx, _mm_sub_epi32(pix1, pix0));
+      res = _mm_add_epi32(pix0, _mm_srai_epi32(_mm_add_epi32(res, round),
+                                               MLIB_SHIFT));
+
+      res = _mm_packs_epi32(res, res);
+      res = _mm_packus_epi16(res, res);
+      STORE_PIXEL(dstPixelPtr, res);
+    }
+  }
+
+  return MLIB_SUCCESS;
+}
+
+/***************************************************************/
+/* Horizontal pass over the 4 pixels at sp, for each channel:
+ * (s0 * xf0 + s1 * xf1 + s2 * xf2 + s3 * xf3 + ROUND_X) >> SHIFT_X
+ * with ROUND_X == 0.  xf01 holds the pairs (xf0, xf1), xf23 (xf2, xf3).
+ */
+static MLIB_S_TARGET inline __m128i mlib_s_RowBC(const mlib_u8 *sp,
+                                                 __m128i       xf01,
+                                                 __m128i       xf23)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i row = _mm_loadu_si128((const __m128i *) sp);
+  __m128i lo = _mm_unpacklo_epi8(row, zero); /* s0, s1 */
+  __m128i hi = _mm_unpackhi_epi8(row, zero); /* s2, s3 */
+
+  lo = _mm_unpacklo_epi16(lo, _mm_srli_si128(lo, 8));
+  hi = _mm_unpacklo_epi16(hi, _mm_srli_si128(hi, 8));
+
+  return _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(lo, xf01),
+                                      _mm_madd_epi16(hi, xf23)), SHIFT_X);
+}
+
+/***************************************************************/
+MLIB_S_TARGET
+mlib_status mlib_s_ImageAffine_u8_4ch_bc(mlib_affine_param *param)
+{
+  DECLAREVAR_BC();
+  DTYPE *dstLineEnd;
+  const mlib_s16 *mlib_filters_table;
+  const __m128i round = _mm_set1_epi32(ROUND_Y);
+
+  if (filter == MLIB_BICUBIC) {
+    mlib_filters_table = (mlib_s16 *) mlib_filters_u8_bc;
+  }
+  else {
+    mlib_filters_table = (mlib_s16 *) mlib_filters_u8_bc2;
+  }
+
+  for (j = yStart; j <= yFinish; j++) {
+    CLIP(4);
+    dstLineEnd = (DTYPE *) dstData + 4 * xRight;
+
+    for (; dstPixelPtr <= dstLineEnd; dstPixelPtr += 4) {
+      __m128i xf, yf, xf01, xf23, c0, c1, c2, c3, val;
+      const mlib_s16 *fptr;
+      mlib_s32 filterpos;
+
+      filterpos = (X >> FILTER_SHIFT) & FILTER_MASK;
+      fptr = (mlib_s16 *) ((mlib_u8 *) mlib_filters_table + filterpos);
+      xf = _mm_loadl_epi64((const __m128i *) fptr);
+      xf01 = _mm_shuffle_epi32(xf, 0x00);
+      xf23 = _mm_shuffle_epi32(xf, 0x55);
+
+      filterpos = (Y >> FILTER_SHIFT) & FILTER_MASK;
+      fptr = (mlib_s16 *) ((mlib_u8 *) mlib_filters_table + filterpos);
+      yf = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *) fptr));
+
+      xSrc = (X >> MLIB_SHIFT) - 1;
+      ySrc = (Y >> MLIB_SHIFT) - 1;
+      X += dX;
+      Y += dY;
+
+      srcPixelPtr = ((DTYPE **) lineAddr)[ySrc] + 4 * xSrc;
+      c0 = mlib_s_RowBC(srcPixelPtr, xf01, xf23);
+      srcPixelPtr = (DTYPE *) ((mlib_addr) srcPixelPtr + srcYStride);
+      c1 = mlib_s_RowBC(srcPixelPtr, xf01, xf23);
+      srcPixelPtr = (DTYPE *) ((mlib_addr) srcPixelPtr + srcYStride);
+      c2 = mlib_s_RowBC(srcPixelPtr, xf01, xf23);
+      srcPixelPtr = (DTYPE *) ((mlib_addr) srcPixelPtr + srcYStride);
+      c3 = mlib_s_RowBC(srcPixelPtr, xf01, xf23);
+
+      /* (c0 * yf0 + c1 * yf1 + c2 * yf2 + c3 * yf3 + ROUND_Y) >> SHIFT_Y */
+      val = _mm_add_epi32(
+              _mm_add_epi32(_mm_mullo_epi32(c0, _mm_shuffle_epi32(yf, 0x00)),
+                            _mm_mullo_epi32(c1, _mm_shuffle_epi32(yf, 0x55))),
+              _mm_add_epi32(_mm_mullo_epi32(c2, _mm_shuffle_epi32(yf, 0xAA)),
+                            _mm_mullo_epi32(c3, _mm_shuffle_epi32(yf, 0xFF))));
+      val = _mm_srai_epi32(_mm_add_epi32(val, round), SHIFT_Y);
+
+      /* saturate to [MLIB_U8_MIN, MLIB_U8_MAX] as S32_TO_U8_SAT */
+      val = _mm_packs_epi32(val, val);
+      val = _mm_packus_epi16(val, val);
+      STORE_PIXEL(dstPixelPtr, val);
+    }
+  }
+
+  return MLIB_SUCCESS;
+}
+
+#endif /* MLIB_S_AFFINE */
+
+/***************************************************************/
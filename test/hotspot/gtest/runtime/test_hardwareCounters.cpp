@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "runtime/hardwareCounters.hpp"
+#include "runtime/thread.hpp"
+#include "unittest.hpp"
+
+#ifdef LINUX
+#include "hardwareCounters_linux.hpp"
+#endif
+
+static void busy_loop() {
+  volatile u8 sum = 0;
+  for (int i = 0; i < 1000000; i++) {
+    sum += i;
+  }
+}
+
+static void set_values(HardwareCounterValues* values, u8 cycles, u8 instructions) {
+  values->set(HardwareCounters::cycles, cycles);
+  values->set(HardwareCounters::instructions, instructions);
+}
+
+TEST(HardwareCounterValues, clear) {
+  HardwareCounterValues values;
+  EXPECT_TRUE(values.is_zero());
+  set_values(&values, 10, 20);
+  EXPECT_FALSE(values.is_zero());
+  values.clear();
+  EXPECT_TRUE(values.is_zero());
+}
+
+TEST(HardwareCounterValues, delta) {
+  HardwareCounterValues start;
+  HardwareCounterValues end;
+  set_values(&start, 100, 50);
+  set_values(&end, 150, 40);
+
+  HardwareCounterValues delta;
+  delta.set_delta(start, end);
+  EXPECT_EQ((u8)50, delta.cycles());
+  // Scaled counts may go backwards, which must not wrap around
+  EXPECT_EQ((u8)0, delta.instructions());
+}
+
+TEST(HardwareCounterValues, add) {
+  HardwareCounterValues sum;
+  HardwareCounterValues values;
+  set_values(&values, 7, 3);
+  sum.add(values);
+  sum.add(values);
+  EXPECT_EQ((u8)14, sum.cycles());
+  EXPECT_EQ((u8)6, sum.instructions());
+  EXPECT_EQ((u8)0, sum.llc_misses());
+}
+
+TEST_VM(HardwareCounters, read_current_thread) {
+  HardwareCounterValues values;
+  if (!HardwareCounters::is_enabled()) {
+    EXPECT_FALSE(HardwareCounters::read(Thread::current(), &values));
+    EXPECT_TRUE(values.is_zero());
+    return;
+  }
+  ASSERT_TRUE(HardwareCounters::read(Thread::current(), &values));
+  busy_loop();
+  HardwareCounterValues end;
+  ASSERT_TRUE(HardwareCounters::read(Thread::current(), &end));
+  EXPECT_GT(end.cycles(), values.cycles());
+}
+
+#ifdef LINUX
+// Opens the counters of the current thread regardless of UseHardwareCounters.
+// Skipped where perf_event_open is not available, e.g. in containers.
+TEST_VM(HardwareCounterSet, read_increases) {
+  if (!HardwareCounterSet::is_supported()) {
+    return;
+  }
+  HardwareCounterSet set;
+  set.open();
+
+  HardwareCounterValues start;
+  ASSERT_TRUE(set.read(&start, true));
+  busy_loop();
+  HardwareCounterValues end;
+  ASSERT_TRUE(set.read(&end, true));
+
+  // is_supported() opened the cycles counter, the others might be missing
+  EXPECT_GT(end.cycles(), start.cycles());
+  EXPECT_TRUE(end.instructions() == 0 || end.instructions() > start.instructions());
+}
+#endif
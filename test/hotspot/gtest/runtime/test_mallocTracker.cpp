@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+
+// Included early because the NMT flags don't include it.
+#include "utilities/macros.hpp"
+
+#if INCLUDE_NMT
+
+#include "services/mallocTracker.hpp"
+#include "unittest.hpp"
+
+TEST(StripedMemoryCounter, sums_stripes) {
+  StripedMemoryCounter counter;
+  EXPECT_EQ(0u, counter.count());
+  EXPECT_EQ(0u, counter.size());
+
+  counter.allocate(100);
+  counter.allocate(28);
+  counter.resize(-8);
+  counter.deallocate(20);
+  EXPECT_EQ(1u, counter.count());
+  EXPECT_EQ(100u, counter.size());
+
+  MemoryCounter copy;
+  counter.copy_to(&copy);
+  EXPECT_EQ(1u, copy.count());
+  EXPECT_EQ(100u, copy.size());
+}
+
+TEST(MemoryCounter, weighted_allocation) {
+  MemoryCounter counter;
+  counter.allocate(4096, 16);
+  counter.allocate(64);
+  EXPECT_EQ(17u, counter.count());
+  EXPECT_EQ(4160u, counter.size());
+
+  counter.deallocate(4096, 16);
+  EXPECT_EQ(1u, counter.count());
+  EXPECT_EQ(64u, counter.size());
+}
+
+#endif // INCLUDE_NMT
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.lang.invoke.VarHandle;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.nio.file.StandardOpenOption;
+
+import sun.jvmstat.monitor.Monitor;
+import sun.jvmstat.monitor.MonitoredHost;
+import sun.jvmstat.monitor.MonitoredVm;
+import sun.jvmstat.monitor.VmIdentifier;
+
+/*
+ * @test
+ * @summary Read the thread records back from the hsperfdata file
+ * @requires os.family == "linux"
+ * @modules jdk.internal.jvmstat/sun.jvmstat.monitor
+ * @run main/othervm -XX:+UsePerfData -XX:+PerfDataThreadRecords
+ *                   -XX:PerfDataThreadRecordsInterval=10 ThreadRecordsTest
+ */
+public class ThreadRecordsTest {
+
+    // PerfDataPrologue
+    private static final int BYTE_ORDER_OFFSET = 4;
+    private static final int USED_OFFSET = 8;
+    private static final int ENTRY_OFFSET_OFFSET = 24;
+    private static final int NUM_ENTRIES_OFFSET = 28;
+
+    // PerfDataEntry
+    private static final int ENTRY_LENGTH_OFFSET = 0;
+    private static final int NAME_OFFSET_OFFSET = 4;
+    private static final int DATA_OFFSET_OFFSET = 16;
+
+    // ThreadPerfRecords, in jlongs
+    private static final int SEQUENCE = 0;
+    private static final int STATE = 1;
+    private static final int JAVA_THREAD_ID = 3;
+    private static final int CPU_TIME = 5;
+    private static final int ALLOCATED_BYTES = 6;
+
+    private static final long TIMEOUT_MILLIS = 60_000;
+
+    private static volatile boolean done;
+    private static volatile Object sink;
+
+    public static void main(String[] args) throws Exception {
+        long pid = ProcessHandle.current().pid();
+
+        // jvmstat parses every entry of the region, the records must not break it
+        VmIdentifier vmid = new VmIdentifier(String.valueOf(pid));
+        MonitoredVm vm = MonitoredHost.getMonitoredHost(vmid).getMonitoredVm(vmid);
+        Monitor offsetMonitor = vm.findByName("sun.threads.threadRecordsOffset");
+        if (offsetMonitor == null) {
+            throw new RuntimeException("sun.threads.threadRecordsOffset not found by jvmstat");
+        }
+        vm.detach();
+
+        Path path = Paths.get(System.getProperty("java.io.tmpdir"),
+                              "hsperfdata_" + System.getProperty("user.name"),
+                              String.valueOf(pid));
+        MappedByteBuffer buffer;
+        try (FileChannel fc = FileChannel.open(path, StandardOpenOption.READ)) {
+            buffer = fc.map(FileChannel.MapMode.READ_ONLY, 0, fc.size());
+        }
+        buffer.order(buffer.get(BYTE_ORDER_OFFSET) == 0 ? ByteOrder.BIG_ENDIAN : ByteOrder.LITTLE_ENDIAN);
+
+        long offset = findConstant(buffer, "sun.threads.threadRecordsOffset");
+        long capacity = findConstant(buffer, "sun.threads.threadRecordCapacity");
+        long length = findConstant(buffer, "sun.threads.threadRecordLength");
+        if (offsetMonitor.getValue() instanceof Long && (Long)offsetMonitor.getValue() != offset) {
+            throw new RuntimeException("jvmstat and the mapped file disagree on the offset");
+        }
+        if (offset < buffer.getInt(USED_OFFSET) || offset % Long.BYTES != 0) {
+            throw new RuntimeException("Records overlap the PerfData entries, offset " + offset);
+        }
+        if (offset + capacity * length * Long.BYTES > buffer.capacity()) {
+            throw new RuntimeException("Records exceed the PerfData region");
+        }
+
+        Thread worker = new Thread(ThreadRecordsTest::work, "ThreadRecordsTest worker");
+        worker.start();
+        try {
+            long[] record = awaitRecord(buffer, (int)offset, (int)capacity, (int)length, worker.getId());
+            if (record[STATE] == 0) {
+                throw new RuntimeException("Record of a live thread has no state");
+            }
+            if (record[CPU_TIME] == 0) {
+                throw new RuntimeException("Record has no CPU time");
+            }
+            System.out.println("Record of " + worker.getName() + ": allocated " +
+                               record[ALLOCATED_BYTES] + " bytes, cpu " + record[CPU_TIME] + " ns");
+        } finally {
+            done = true;
+            worker.join();
+        }
+    }
+
+    private static void work() {
+        while (!done) {
+            sink = new byte[1024];
+        }
+    }
+
+    // Waits for the sampler to publish allocations for the thread with the given id
+    private static long[] awaitRecord(ByteBuffer buffer, int offset, int capacity, int length,
+                                      long threadId) throws InterruptedException {
+        long deadline = System.currentTimeMillis() + TIMEOUT_MILLIS;
+        long[] record = new long[length];
+        while (System.currentTimeMillis() < deadline) {
+            for (int i = 0; i < capacity; i++) {
+                if (readRecord(buffer, offset + i * length * Long.BYTES, record) &&
+                    record[JAVA_THREAD_ID] == threadId && record[ALLOCATED_BYTES] > 0) {
+                    return record;
+                }
+            }
+            Thread.sleep(10);
+        }
+        throw new RuntimeException("No record with allocations found for thread " + threadId);
+    }
+
+    // Copies a record, returns false if it was being updated
+    private static boolean readRecord(ByteBuffer buffer, int position, long[] record) {
+        long sequence = buffer.getLong(position + SEQUENCE * Long.BYTES);
+        if ((sequence & 1) != 0) {
+            return false;
+        }
+        VarHandle.acquireFence();
+        for (int i = 0; i < record.length; i++) {
+            record[i] = buffer.getLong(position + i * Long.BYTES);
+        }
+        VarHandle.acquireFence();
+        return buffer.getLong(position + SEQUENCE * Long.BYTES) == sequence;
+    }
+
+    private static long findConstant(ByteBuffer buffer, String name) {
+        int entry = buffer.getInt(ENTRY_OFFSET_OFFSET);
+        int entries = buffer.getInt(NUM_ENTRIES_OFFSET);
+        for (int i = 0; i < entries; i++) {
+            int nameStart = entry + buffer.getInt(entry + NAME_OFFSET_OFFSET);
+            int nameEnd = nameStart;
+            while (buffer.get(nameEnd) != 0) {
+                nameEnd++;
+            }
+            byte[] bytes = new byte[nameEnd - nameStart];
+            for (int j = 0; j < bytes.length; j++) {
+                bytes[j] = buffer.get(nameStart + j);
+            }
+            if (name.equals(new String(bytes, StandardCharsets.UTF_8))) {
+                return buffer.getLong(entry + buffer.getInt(entry + DATA_OFFSET_OFFSET));
+            }
+            entry += buffer.getInt(entry + ENTRY_LENGTH_OFFSET);
+        }
+        throw new RuntimeException(name + " not found");
+    }
+}
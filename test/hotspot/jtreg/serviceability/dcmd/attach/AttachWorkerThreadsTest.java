@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+
+import jdk.test.lib.dcmd.PidJcmdExecutor;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+/*
+ * @test
+ * @summary Test that attach operations are executed by AttachListenerWorkerThreads
+ *          and that large replies are returned in full
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ *          java.management
+ * @run driver AttachWorkerThreadsTest
+ */
+public class AttachWorkerThreadsTest {
+
+    public static void main(String[] args) throws Exception {
+        // The default pool of two workers
+        OutputAnalyzer output = runApp("-XX:AttachListenerWorkerThreads=2", "2");
+        output.shouldContain("jcmd completed");
+        output.shouldHaveExitValue(0);
+
+        // Zero executes the operations on the Attach Listener thread
+        output = runApp("-XX:AttachListenerWorkerThreads=0", "0");
+        output.shouldContain("jcmd completed");
+        output.shouldHaveExitValue(0);
+
+        // Out of range
+        output = runApp("-XX:AttachListenerWorkerThreads=17", "0");
+        output.shouldContain("uint AttachListenerWorkerThreads=17 is outside the allowed range");
+        output.shouldNotHaveExitValue(0);
+    }
+
+    private static OutputAnalyzer runApp(String option, String workers) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            option, TestApp.class.getName(), workers);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getOutput());
+        return output;
+    }
+
+    public static class TestApp {
+        // Enough parked threads to make the thread dump exceed the 64K
+        // at which the reply starts streaming
+        private static final int THREADS = 500;
+        private static final int CLIENTS = 4;
+
+        public static void main(String[] args) throws Exception {
+            int workers = Integer.parseInt(args[0]);
+
+            CountDownLatch done = new CountDownLatch(1);
+            for (int i = 0; i < THREADS; i++) {
+                Thread t = new Thread(() -> {
+                    try {
+                        done.await();
+                    } catch (InterruptedException e) {
+                    }
+                }, "Parked#" + i);
+                t.setDaemon(true);
+                t.start();
+            }
+
+            // Several clients at once, each asking for a large and a small reply
+            ExecutorService clients = Executors.newFixedThreadPool(CLIENTS);
+            List<Future<?>> results = new ArrayList<>();
+            for (int i = 0; i < CLIENTS; i++) {
+                results.add(clients.submit(() -> {
+                    PidJcmdExecutor executor = new PidJcmdExecutor();
+                    checkThreadDump(executor.execute("Thread.print"), workers);
+                    executor.execute("VM.version").shouldContain("JDK");
+                    return null;
+                }));
+            }
+            for (Future<?> result : results) {
+                result.get();
+            }
+            clients.shutdown();
+            done.countDown();
+            System.out.println("jcmd completed");
+        }
+
+        private static void checkThreadDump(OutputAnalyzer output, int workers) {
+            output.shouldContain("Full thread dump");
+            for (int i = 0; i < THREADS; i++) {
+                output.shouldContain("\"Parked#" + i + "\"");
+            }
+            for (int i = 0; i < 16; i++) {
+                if (i < workers) {
+                    output.shouldContain("\"Attach Listener Worker#" + i + "\"");
+                } else {
+                    output.shouldNotContain("\"Attach Listener Worker#" + i + "\"");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.List;
+
+import jdk.test.lib.dcmd.PidJcmdExecutor;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+/*
+ * @test
+ * @summary Test the GC.heap_profile diagnostic command
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ *          java.management
+ * @run driver HeapProfileTest
+ */
+public class HeapProfileTest {
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer output = runApp("-XX:+AllocationSiteProfiling", "enabled");
+        output.shouldContain("profile checked");
+        output.shouldHaveExitValue(0);
+
+        output = runApp("-XX:-AllocationSiteProfiling", "disabled");
+        output.shouldContain("profile checked");
+        output.shouldHaveExitValue(0);
+    }
+
+    private static OutputAnalyzer runApp(String option, String expect) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            option, "-XX:AllocationSiteProfilingInterval=4096",
+            TestApp.class.getName(), expect);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getOutput());
+        return output;
+    }
+
+    public static class TestApp {
+        private static final List<byte[]> retained = new ArrayList<>();
+
+        public static void main(String[] args) throws Exception {
+            boolean enabled = args[0].equals("enabled");
+            allocate();
+
+            Path profile = Paths.get("heap-" + args[0] + ".pb").toAbsolutePath();
+            Files.deleteIfExists(profile);
+            OutputAnalyzer output = new PidJcmdExecutor().execute("GC.heap_profile " + profile);
+
+            if (enabled) {
+                output.shouldMatch("Wrote [1-9][0-9]* allocation sites from [1-9][0-9]* live samples");
+                output.shouldContain(profile.toString());
+                // The function names are in the string table of the profile
+                String content = new String(Files.readAllBytes(profile), StandardCharsets.ISO_8859_1);
+                if (!content.contains("HeapProfileTest$TestApp.allocate")) {
+                    throw new RuntimeException("Allocation site missing from " + profile);
+                }
+            } else {
+                output.shouldContain("Allocation site profiling is not enabled, use -XX:+AllocationSiteProfiling");
+                if (Files.exists(profile)) {
+                    throw new RuntimeException(profile + " should not have been written");
+                }
+            }
+            System.out.println("profile checked");
+        }
+
+        private static void allocate() {
+            for (int i = 0; i < 10_000; i++) {
+                retained.add(new byte[1024]);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+
+import jdk.test.lib.dcmd.PidJcmdExecutor;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+/*
+ * @test
+ * @summary Test the GC.worker_timeline diagnostic command
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ *          java.management
+ * @run driver WorkerTimelineTest
+ */
+public class WorkerTimelineTest {
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer output = runApp("-XX:+RecordGCWorkerTimeline", "enabled");
+        output.shouldContain("timeline checked");
+        output.shouldHaveExitValue(0);
+
+        output = runApp("-XX:-RecordGCWorkerTimeline", "disabled");
+        output.shouldContain("timeline checked");
+        output.shouldHaveExitValue(0);
+    }
+
+    private static OutputAnalyzer runApp(String option, String expect) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            option, "-XX:ParallelGCThreads=2", TestApp.class.getName(), expect);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getOutput());
+        return output;
+    }
+
+    public static class TestApp {
+        public static void main(String[] args) throws Exception {
+            boolean enabled = args[0].equals("enabled");
+            // Record at least one pause
+            System.gc();
+
+            Path trace = Paths.get("timeline-" + args[0] + ".json").toAbsolutePath();
+            Files.deleteIfExists(trace);
+            OutputAnalyzer output = new PidJcmdExecutor().execute("GC.worker_timeline " + trace);
+
+            if (enabled) {
+                output.shouldContain("GC worker timeline written to " + trace);
+                String content = new String(Files.readAllBytes(trace));
+                if (!content.startsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") ||
+                    !content.trim().endsWith("]}")) {
+                    throw new RuntimeException("Not a trace: " + content);
+                }
+                for (String event : new String[] { "GC Pauses", "GC Worker #0", "\"name\":\"Pause (" }) {
+                    if (!content.contains(event)) {
+                        throw new RuntimeException("Missing " + event + " in " + content);
+                    }
+                }
+            } else {
+                output.shouldContain("GC worker timeline is not recorded, use -XX:+RecordGCWorkerTimeline");
+                if (Files.exists(trace)) {
+                    throw new RuntimeException(trace + " should not have been written");
+                }
+            }
+            System.out.println("timeline checked");
+        }
+    }
+}
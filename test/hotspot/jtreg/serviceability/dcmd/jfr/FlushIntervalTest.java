@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Optional;
+import java.util.stream.Stream;
+
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+/*
+ * @test
+ * @summary Test the flushinterval option of -XX:FlightRecorderOptions
+ * @requires vm.hasJFR
+ * @library /test/lib
+ * @modules jdk.jfr
+ * @run driver FlushIntervalTest
+ */
+public class FlushIntervalTest {
+
+    // The chunk size is the first header slot after the magic and version
+    private static final int CHUNK_SIZE_OFFSET = 8;
+    private static final int CHUNK_HEADER_SIZE = 68;
+
+    public static void main(String[] args) throws Exception {
+        // Below the minimum of 10 ms
+        OutputAnalyzer output = runApp("flushinterval=5ms", "none");
+        output.shouldContain("Value specified for option \"flushinterval\" is lower than the minimum");
+        output.shouldNotHaveExitValue(0);
+
+        // Flushpoints publish the chunk size while the chunk is still open
+        output = runApp("flushinterval=100ms", "flushed");
+        output.shouldContain("chunk flushed");
+        output.shouldHaveExitValue(0);
+
+        // Without flushpoints the header is only written at rotation
+        output = runApp("flushinterval=0", "unflushed");
+        output.shouldContain("chunk not flushed");
+        output.shouldHaveExitValue(0);
+    }
+
+    private static OutputAnalyzer runApp(String option, String expect) throws Exception {
+        Path repository = Files.createTempDirectory(Paths.get("."), "repository");
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:StartFlightRecording",
+            "-XX:FlightRecorderOptions=repository=" + repository + "," + option,
+            TestApp.class.getName(), repository.toString(), expect);
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getOutput());
+        return output;
+    }
+
+    public static class TestApp {
+        public static void main(String[] args) throws Exception {
+            Path repository = Paths.get(args[0]);
+            boolean flushed = false;
+
+            // Wait up to 10 s for a flushpoint, or 2 s to see none
+            long deadline = System.currentTimeMillis() +
+                            (args[1].equals("flushed") ? 10_000 : 2_000);
+            while (!flushed && System.currentTimeMillis() < deadline) {
+                Thread.sleep(100);
+                Optional<Path> chunk = findChunk(repository);
+                if (chunk.isPresent()) {
+                    flushed = readChunkSize(chunk.get()) > 0;
+                }
+            }
+            System.out.println(flushed ? "chunk flushed" : "chunk not flushed");
+        }
+
+        private static Optional<Path> findChunk(Path repository) throws IOException {
+            try (Stream<Path> files = Files.walk(repository)) {
+                return files.filter(p -> p.toString().endsWith(".jfr")).findFirst();
+            }
+        }
+
+        private static long readChunkSize(Path chunk) throws IOException {
+            try (RandomAccessFile file = new RandomAccessFile(chunk.toFile(), "r")) {
+                if (file.length() < CHUNK_HEADER_SIZE) {
+                    return 0;
+                }
+                file.seek(CHUNK_SIZE_OFFSET);
+                long size = file.readLong();
+                if (size > file.length()) {
+                    throw new RuntimeException("Chunk size " + size +
+                                               " exceeds file length " + file.length());
+                }
+                return size;
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.util.concurrent.CountDownLatch;
+
+import jdk.test.lib.dcmd.PidJcmdExecutor;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+/*
+ * @test
+ * @summary Test Thread.print with and without HandshakeThreadDump, including
+ *          the detection of a deadlock
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ *          java.management
+ * @run driver HandshakeThreadDumpTest
+ */
+public class HandshakeThreadDumpTest {
+
+    public static void main(String[] args) throws Exception {
+        // Threads are printed one handshake at a time
+        OutputAnalyzer output = runApp("-XX:+HandshakeThreadDump");
+        output.shouldContain("thread dumps checked");
+        output.shouldHaveExitValue(0);
+
+        // Threads are printed at a safepoint
+        output = runApp("-XX:-HandshakeThreadDump");
+        output.shouldContain("thread dumps checked");
+        output.shouldHaveExitValue(0);
+    }
+
+    private static OutputAnalyzer runApp(String option) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            option, TestApp.class.getName());
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getOutput());
+        return output;
+    }
+
+    public static class TestApp {
+        private static final Object lockA = new Object();
+        private static final Object lockB = new Object();
+
+        public static void main(String[] args) throws Exception {
+            CountDownLatch locked = new CountDownLatch(2);
+            startDeadlocked("DeadlockedA", lockA, lockB, locked);
+            startDeadlocked("DeadlockedB", lockB, lockA, locked);
+            locked.await();
+            // Give both threads time to block on the second monitor
+            Thread.sleep(1000);
+
+            PidJcmdExecutor executor = new PidJcmdExecutor();
+            checkThreadDump(executor.execute("Thread.print"));
+            // -l always stops the threads at a safepoint
+            OutputAnalyzer output = executor.execute("Thread.print -l");
+            checkThreadDump(output);
+            output.shouldContain("Locked ownable synchronizers:");
+            System.out.println("thread dumps checked");
+        }
+
+        private static void startDeadlocked(String name, Object first, Object second,
+                                            CountDownLatch locked) {
+            Thread t = new Thread(() -> {
+                synchronized (first) {
+                    locked.countDown();
+                    try {
+                        locked.await();
+                    } catch (InterruptedException e) {
+                    }
+                    synchronized (second) {
+                        throw new RuntimeException("Not deadlocked");
+                    }
+                }
+            }, name);
+            t.setDaemon(true);
+            t.start();
+        }
+
+        private static void checkThreadDump(OutputAnalyzer output) {
+            output.shouldContain("Full thread dump");
+            output.shouldContain("\"main\"");
+            output.shouldContain("\"DeadlockedA\"");
+            output.shouldContain("\"DeadlockedB\"");
+            output.shouldContain("- waiting to lock");
+            output.shouldContain("Found one Java-level deadlock:");
+            output.shouldContain("Found 1 deadlock.");
+        }
+    }
+}